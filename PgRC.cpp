@@ -27,10 +27,10 @@ int main(int argc, char *argv[])
 #endif
 
 #ifdef DEVELOPER_BUILD
-    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:l:B:E:doSIrNVvTaA?")) != -1) {
+    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:b:Rl:B:E:doSIrNVvTaA?")) != -1) {
         char* valPtr;
 #else
-    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:do?")) != -1) {
+    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:b:Rdo?")) != -1) {
 #endif
         switch (opt) {
             case 'c':
@@ -91,6 +91,18 @@ int main(int argc, char *argv[])
                 compressionParamPresent = true;
                 pgRC->setMinimalPgReverseComplementedRepeatLength(atoi(optarg));
                 break;
+            case 'b':
+                compressionParamPresent = true;
+                if (atoi(optarg) < 0) {
+                    fprintf(stderr, "The size of blocks must not be negative.\n");
+                    exit(EXIT_FAILURE);
+                }
+                parallelBlocksCoderBlockSize = ((size_t) atoi(optarg)) << 20;
+                break;
+            case 'R':
+                compressionParamPresent = true;
+                pgRC->enableRevComplPgGeneration();
+                break;
 #ifdef DEVELOPER_BUILD
             case 'l':
                 compressionParamPresent = true;
@@ -172,7 +184,9 @@ int main(int argc, char *argv[])
 #endif
                                 "lengthOfReadSeedPartForReadsAlignmentPhase]\n"
                                 "[-M minimalNumberOfCharsPerMismatchForReadsAlignmentPhase]\n"
-                                "[-p minimalReverseComplementedRepeatLength]\n\n");
+                                "[-p minimalReverseComplementedRepeatLength]\n"
+                                "[-b blockSizeInMBForParallelStreamsCompression] (0=>disable - default)\n"
+                                "[-R] overlap reverse complements of reads during HQ Pg generation (ignored with -o)\n\n");
 #ifdef DEVELOPER_BUILD
                 fprintf(stderr, "Matching modes: d[s]:default; i[s]:interleaved; c[s]:copMEM ('s' suffix: shortcut after first read match)\n");
                 fprintf(stderr, "------------------ DEVELOPER OPTIONS ----------------\n");
@@ -16,11 +16,13 @@ namespace PgTools {
     static const char *const GOOD_INFIX = "good";
     static const char *const N_INFIX = "N";
     static const char *const DIVISION_EXTENSION = ".div";
+    static const char *const ALL_INFIX = "all";
+    static const char *const READS_STORE_EXTENSION = ".prs";
 
     static const char *const TEMPORARY_FILE_SUFFIX = ".temp";
     static const char *const PGRC_HEADER = "PgRC";
 
-    uint_read_len_max probeReadsLength(const string &srcFastqFile);
+    uint_read_len_max probeReadsLength(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt);
 
     time_t getTimeInSec(chrono::steady_clock::time_point end_t, chrono::steady_clock::time_point begin_t) {
         chrono::nanoseconds time_span = chrono::duration_cast<chrono::nanoseconds>(end_t - begin_t);
@@ -71,7 +73,6 @@ namespace PgTools {
         initCompressionParameters();
         qualityDivision = error_limit_in_promils < 1000;
         generatorDivision = gen_quality_coef > 0;
-        readLength = probeReadsLength(srcFastqFile);
         if (pairFastqFile.empty() && !preserveOrderMode)
             singleReadsMode = true;
 
@@ -137,6 +138,14 @@ namespace PgTools {
         pgSeqFinalLqPrefix = pgFilesPrefixesWithM + BAD_INFIX;
         pgNPrefix = pgFilesPrefixesWithM + N_INFIX;
         mappedLqDivisionFile = pgFilesPrefixesWithM + BAD_INFIX + DIVISION_EXTENSION;
+        readsStoreFile = tmpDirectoryName + "/" + ALL_INFIX + READS_STORE_EXTENSION;
+
+        readsStoreAvailable = skipStages > 0 &&
+                ReadsSetPersistence::probePackedReadsStore(readsStoreFile, readLength);
+        if (!readsStoreAvailable) {
+            probedReadsIterator = createAllReadsIterator();
+            readLength = probeReadsLength(probedReadsIterator);
+        }
     }
 
     void PgRCManager::executePgRCChain() {
@@ -153,6 +162,8 @@ namespace PgTools {
         div_t = chrono::steady_clock::now();
         if (skipStages < ++stageCount && endAtStage >= stageCount) {
             prepareForPgGeneratorBaseReadsDivision();
+            if (extraFilesForValidation)
+                persistReadsStore();
             if (generatorDivision)
                 runPgGeneratorBasedReadsDivision();
             if (disableInMemoryMode || endAtStage == stageCount) {
@@ -206,12 +217,12 @@ namespace PgTools {
                 if (preserveOrderMode) {
                     ExtendedReadsListWithConstantAccessOption *const pgRl = lqPg->getReadsList();
                     uint_pg_len_max pos = hqPg->getPseudoGenomeLength();
-                    for (uint_reads_cnt_std i = 0; i < pgRl->readsCount; i++) {
+                    for (uint_reads_cnt_max i = 0; i < pgRl->readsCount; i++) {
                         pos += pgRl->off[i];
                         orgIdx2PgPos[pgRl->orgIdx[i]] = pos;
                     }
                 } else
-                    rlIdxOrder.insert(rlIdxOrder.end(), lqPg->getReadsList()->orgIdx.begin(), lqPg->getReadsList()->orgIdx.end());
+                    rlIdxOrder.append(lqPg->getReadsList()->orgIdx);
             }
             lqPg->disposeReadsList();
             if (separateNReads) {
@@ -225,13 +236,12 @@ namespace PgTools {
                     if (preserveOrderMode) {
                         ExtendedReadsListWithConstantAccessOption *const pgRl = nPg->getReadsList();
                         uint_pg_len_max pos = hqPg->getPseudoGenomeLength() + lqPg->getPseudoGenomeLength();
-                        for (uint_reads_cnt_std i = 0; i < pgRl->readsCount; i++) {
+                        for (uint_reads_cnt_max i = 0; i < pgRl->readsCount; i++) {
                             pos += pgRl->off[i];
                             orgIdx2PgPos[pgRl->orgIdx[i]] = pos;
                         }
                     } else
-                        rlIdxOrder.insert(rlIdxOrder.end(), nPg->getReadsList()->orgIdx.begin(),
-                                   nPg->getReadsList()->orgIdx.end());
+                        rlIdxOrder.append(nPg->getReadsList()->orgIdx);
                 }
                 nPg->disposeReadsList();
             }
@@ -280,9 +290,26 @@ namespace PgTools {
 #endif
     }
 
+    ReadsSourceIteratorTemplate<uint_read_len_max>* PgRCManager::createAllReadsIterator() {
+        if (probedReadsIterator) {
+            ReadsSourceIteratorTemplate<uint_read_len_max>* readsIt = probedReadsIterator;
+            probedReadsIterator = 0;
+            return readsIt;
+        }
+        if (readsStoreAvailable)
+            return ReadsSetPersistence::createPackedReadsStoreIterator(readsStoreFile);
+        return ReadsSetPersistence::createManagedReadsIterator(srcFastqFile, pairFastqFile, revComplPairFile);
+    }
+
+    void PgRCManager::persistReadsStore() {
+        if (readsStoreAvailable || !divReadsSets->getHqReadsSet())
+            return;
+        divReadsSets->writeReadsStore(readsStoreFile);
+        readsStoreAvailable = true;
+    }
+
     void PgRCManager::runQualityBasedDivision() {
-        ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                srcFastqFile, pairFastqFile, revComplPairFile);
+        ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = createAllReadsIterator();
         divReadsSets =
                 DividedPCLReadsSets::getQualityDivisionBasedReadsSets(allReadsIterator, readLength, error_limit_in_promils / 1000.0,
                         separateNReads, nReadsLQ);
@@ -290,6 +317,7 @@ namespace PgTools {
     }
 
     void PgRCManager::persistReadsQualityDivision() {
+        persistReadsStore();
         divReadsSets->getLqReadsIndexesMapping()->saveMapping(lqDivisionFile);
         if (separateNReads)
             divReadsSets->getNReadsIndexesMapping()->saveMapping(nDivisionFile);
@@ -297,8 +325,7 @@ namespace PgTools {
 
     void PgRCManager::prepareForPgGeneratorBaseReadsDivision() {
         if (!divReadsSets) {
-            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                    srcFastqFile, pairFastqFile, revComplPairFile);
+            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = createAllReadsIterator();
             if (qualityDivision) {
                 divReadsSets = DividedPCLReadsSets::loadDivisionReadsSets(
                         allReadsIterator, readLength, lqDivisionFile, nReadsLQ, separateNReads ? nDivisionFile : "");
@@ -324,8 +351,7 @@ namespace PgTools {
 
     void PgRCManager::prepareForHqPgGeneration() {
         if (!divReadsSets) {
-            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                    srcFastqFile, pairFastqFile, revComplPairFile);
+            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = createAllReadsIterator();
             divReadsSets = DividedPCLReadsSets::loadDivisionReadsSets(
                     allReadsIterator, readLength, lqDivisionFile, nReadsLQ, separateNReads ? nDivisionFile : "");
             delete (allReadsIterator);
@@ -335,9 +361,10 @@ namespace PgTools {
     void PgRCManager::runHQPgGeneration() {
         cout << "HQ ";
         divReadsSets->getHqReadsSet()->printout();
-        if (numberOfThreads > 1 && divReadsSets->getHqReadsSet()->readsCount() > PARALLEL_PG_GENERATION_READS_COUNT_THRESHOLD)
+        if (isRevComplPgGenerationEnabled() || (numberOfThreads > 1 &&
+                divReadsSets->getHqReadsSet()->readsCount() > PARALLEL_PG_GENERATION_READS_COUNT_THRESHOLD))
             hqPg = ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::generateSeparatedPg(
-                    divReadsSets->getHqReadsSet());
+                    divReadsSets->getHqReadsSet(), isRevComplPgGenerationEnabled());
         else
             hqPg = GreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::generateSeparatedPg(
                     divReadsSets->getHqReadsSet());
@@ -353,8 +380,7 @@ namespace PgTools {
 
     void PgRCManager::prepareForMappingLQReadsOnHQPg() {
         if (!divReadsSets) {
-            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                    srcFastqFile, pairFastqFile, revComplPairFile);
+            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = createAllReadsIterator();
             divReadsSets = DividedPCLReadsSets::loadDivisionReadsSets(
                     allReadsIterator, readLength, lqDivisionFile, nReadsLQ, separateNReads ? nDivisionFile : "", true);
             delete (allReadsIterator);
@@ -410,8 +436,7 @@ namespace PgTools {
 
     void PgRCManager::prepareForLQPgAndNPgGeneration() {
         if (!divReadsSets) {
-            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                    srcFastqFile, pairFastqFile, revComplPairFile);
+            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = createAllReadsIterator();
             divReadsSets = DividedPCLReadsSets::loadDivisionReadsSets(
                     allReadsIterator, readLength, mappedLqDivisionFile, nReadsLQ, separateNReads ? nDivisionFile : "", true);
             delete (allReadsIterator);
@@ -518,6 +543,10 @@ namespace PgTools {
     }
 
     void PgRCManager::disposeChainData() {
+        if (probedReadsIterator) {
+            delete (probedReadsIterator);
+            probedReadsIterator = 0;
+        }
         if (divReadsSets) {
             delete (divReadsSets);
             divReadsSets = 0;
@@ -585,6 +614,7 @@ namespace PgTools {
         pgSeqFinalHqPrefix = tmpDirectoryPath + GOOD_INFIX;
         pgSeqFinalLqPrefix = tmpDirectoryPath + BAD_INFIX;
         pgNPrefix = tmpDirectoryPath + N_INFIX;
+        readsStoreFile = tmpDirectoryPath + ALL_INFIX + READS_STORE_EXTENSION;
 
         preserveOrderMode = pgrc_mode == PGRC_ORD_SE_MODE || pgrc_mode == PGRC_ORD_PE_MODE;
         ignorePairOrderInformation = pgrc_mode == PGRC_MIN_PE_MODE;
@@ -607,12 +637,19 @@ namespace PgTools {
 
         if (srcFastqFile.empty()) {
             if (singleReadsMode && !preserveOrderMode) {
-                if (ENABLE_PARALLEL_DECOMPRESSION && dnaStreamSize() > CHUNK_SIZE_IN_BYTES)
+                if (ENABLE_PARALLEL_DECOMPRESSION && numberOfThreads > 1 && dnaStreamSize() > CHUNK_SIZE_IN_BYTES)
                     writeAllReadsInSEModeParallel(pgRCFileName);
                 else
                     writeAllReadsInSEMode(pgRCFileName);
             }
-            else if (!preserveOrderMode)
+            else if (ENABLE_PARALLEL_DECOMPRESSION && numberOfThreads > 1) {
+                if (!preserveOrderMode)
+                    writeAllReadsInPEModeParallel(pgRCFileName);
+                else if (isJoinedPgLengthStd)
+                    writeAllReadsInORDModeParallel<uint_pg_len_std>(pgRCFileName, orgIdx2StdPgPos);
+                else
+                    writeAllReadsInORDModeParallel<uint_pg_len_max>(pgRCFileName, orgIdx2PgPos);
+            } else if (!preserveOrderMode)
                 writeAllReadsInPEMode(pgRCFileName);
             else if (isJoinedPgLengthStd)
                 writeAllReadsInORDMode<uint_pg_len_std>(pgRCFileName, orgIdx2StdPgPos);
@@ -632,9 +669,11 @@ namespace PgTools {
     }
 
     void PgRCManager::pushOutToQueue(string &out) {
-        std::lock_guard<std::mutex> _(this->mut);
+        std::unique_lock<std::mutex> lk(this->mut);
+        space_cond.wait(lk, [this]{return out_queue.size() < OUT_QUEUE_LIMIT;});
         out_queue.push(std::move(out));
         data_cond.notify_one();
+        lk.unlock();
         out.resize(0);
         out.reserve(CHUNK_SIZE_IN_BYTES);
     }
@@ -651,35 +690,34 @@ namespace PgTools {
         lqPg->getReadsList()->enableConstantAccess(true);
         if (nPg) nPg->getReadsList()->enableConstantAccess(true);
         std::thread writing(&PgRCManager::writeFromQueue, this, outPrefix);
-        string res, read;
-        read.resize(readLength);
-        uint64_t res_size_guard = CHUNK_SIZE_IN_BYTES;
-        res.reserve(CHUNK_SIZE_IN_BYTES);
-        for(uint_reads_cnt_max i = 0; i < hqReadsCount; i++) {
-            if (res.size() > res_size_guard) {
-                pushOutToQueue(res);
-            }
-            hqPg->getRead_Unsafe(i, (char *) read.data());
-            res.append(read);
-            res.push_back('\n');
-        }
-        for(uint_reads_cnt_max i = 0; i < lqReadsCount; i++) {
-            if (res.size() > res_size_guard) {
-                pushOutToQueue(res);
-            }
-            lqPg->getRead_RawSequence(i, (char *) read.data());
-            res.append(read);
-            res.push_back('\n');
-        }
-        for(uint_reads_cnt_max i = 0; i < nPgReadsCount; i++) {
-            if (res.size() > res_size_guard) {
-                pushOutToQueue(res);
+        const uint_reads_cnt_max chunkReadsCount = CHUNK_SIZE_IN_BYTES / (readLength + 1) + 1;
+        const uint_reads_cnt_max chunksCount = (readsTotalCount + chunkReadsCount - 1) / chunkReadsCount;
+        const uint_reads_cnt_max batchChunksCount = numberOfThreads * 4;
+        vector<string> batch(batchChunksCount);
+        for(uint_reads_cnt_max c = 0; c < chunksCount; c += batchChunksCount) {
+            const uint_reads_cnt_max batchEnd = c + batchChunksCount < chunksCount ? c + batchChunksCount : chunksCount;
+            #pragma omp parallel for schedule(static, 1) num_threads(numberOfThreads)
+            for(uint_reads_cnt_max b = c; b < batchEnd; b++) {
+                string &res = batch[b - c];
+                const uint_reads_cnt_max start = b * chunkReadsCount;
+                const uint_reads_cnt_max end = start + chunkReadsCount < readsTotalCount ?
+                        start + chunkReadsCount : readsTotalCount;
+                res.resize((end - start) * (readLength + 1));
+                char* readPtr = (char*) res.data();
+                for(uint_reads_cnt_max i = start; i < end; i++) {
+                    if (i < hqReadsCount)
+                        hqPg->getRead_Unsafe(i, readPtr);
+                    else if (i < nonNPgReadsCount)
+                        lqPg->getRead_RawSequence(i - hqReadsCount, readPtr);
+                    else
+                        nPg->getRead_RawSequence(i - nonNPgReadsCount, readPtr);
+                    readPtr += readLength;
+                    *(readPtr++) = '\n';
+                }
             }
-            nPg->getRead_RawSequence(i, (char *) read.data());
-            res.append(read);
-            res.push_back('\n');
+            for(uint_reads_cnt_max b = c; b < batchEnd; b++)
+                pushOutToQueue(batch[b - c]);
         }
-        pushOutToQueue(res);
         cout << "... finished loading queue (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
         finishWritingParallel();
         writing.join();
@@ -692,8 +730,9 @@ namespace PgTools {
             std::unique_lock<std::mutex> lk(mut);
             data_cond.wait(
                     lk,[this]{return !out_queue.empty();});
-            out = out_queue.front();
+            out = std::move(out_queue.front());
             out_queue.pop();
+            space_cond.notify_one();
             lk.unlock();
             fout << out;
         } while (!out.empty());
@@ -759,7 +798,7 @@ namespace PgTools {
                     fout << res;
                     res.resize(0);
                 }
-                uint_reads_cnt_std idx = rlIdxOrder[i];
+                uint_reads_cnt_max idx = rlIdxOrder[i];
                 if (idx < hqReadsCount)
                     hqPg->getRead(idx, readPtr);
                 else {
@@ -792,7 +831,7 @@ namespace PgTools {
             uint64_t totalSize = dnaStreamSize();
             res.reserve(totalSize < res_size_guard ? totalSize : res_size_guard + (readLength + 1));
             uint_reads_cnt_max i = 0;
-            uint_reads_cnt_std endI = (readsTotalCount / parts) * (p + 1);
+            uint_reads_cnt_max endI = (readsTotalCount / parts) * (p + 1);
             for (i = (readsTotalCount / parts) * p; i < endI; i++) {
                 if (res.size() > res_size_guard) {
                     fout << res;
@@ -819,6 +858,126 @@ namespace PgTools {
     template void PgRCManager::writeAllReadsInORDMode<uint_pg_len_std>(const string &outPrefix, vector<uint_pg_len_std> &orgIdx2PgPos) const;
     template void PgRCManager::writeAllReadsInORDMode<uint_pg_len_max>(const string &outPrefix, vector<uint_pg_len_max> &orgIdx2PgPos) const;
 
+    uint_reads_cnt_max PgRCManager::slabReadsCount() const {
+        return CHUNK_SIZE_IN_BYTES / (readLength + 1) + 1;
+    }
+
+    void PgRCManager::writeAllReadsInSlabsParallel(const string &outPrefix, uint8_t parts,
+                                                   const SlabFiller &fillSlab) const {
+        cout << "... parallel mode" << endl;
+        vector<fstream> fouts;
+        for(uint8_t p = 0; p < parts; p++)
+            fouts.emplace_back(outPrefix + "_out" + (parts == 1?"":("_" + toString(p + 1))),
+                               ios_base::out | ios_base::binary | std::ios::trunc);
+        const uint_reads_cnt_max partReadsCount = readsTotalCount / parts;
+        const uint_reads_cnt_max slabReadsCount = this->slabReadsCount();
+        const uint_reads_cnt_max slabsCount = (partReadsCount + slabReadsCount - 1) / slabReadsCount;
+        const uint_reads_cnt_max batchSlabsCount = numberOfThreads * 4;
+        // slabs of a batch are generated while the previous batch is written by the sequencer thread
+        vector<string> slabs(batchSlabsCount * parts);
+        vector<string> writtenSlabs(batchSlabsCount * parts);
+        uint_reads_cnt_max writtenSlabsCount = 0;
+        std::thread sequencer;
+        for(uint_reads_cnt_max s = 0; s < slabsCount; s += batchSlabsCount) {
+            const uint_reads_cnt_max batchEnd = s + batchSlabsCount < slabsCount ? s + batchSlabsCount : slabsCount;
+            const int64_t jobsCount = (batchEnd - s) * parts;
+            #pragma omp parallel for schedule(static, 1) num_threads(numberOfThreads)
+            for(int64_t j = 0; j < jobsCount; j++) {
+                const uint8_t p = j % parts;
+                const uint_reads_cnt_max slabIdx = s + j / parts;
+                const uint_reads_cnt_max start = slabIdx * slabReadsCount;
+                const uint_reads_cnt_max end = start + slabReadsCount < partReadsCount ?
+                        start + slabReadsCount : partReadsCount;
+                string &slab = slabs[j];
+                slab.resize((end - start) * (readLength + 1));
+                fillSlab(p, slabIdx, start, end, (char*) slab.data());
+            }
+            if (sequencer.joinable())
+                sequencer.join();
+            slabs.swap(writtenSlabs);
+            writtenSlabsCount = jobsCount;
+            sequencer = std::thread([&fouts, &writtenSlabs, writtenSlabsCount, parts]() {
+                for(uint_reads_cnt_max j = 0; j < writtenSlabsCount; j++)
+                    fouts[j % parts] << writtenSlabs[j];
+            });
+        }
+        if (sequencer.joinable())
+            sequencer.join();
+        for(uint8_t p = 0; p < parts; p++)
+            fouts[p].close();
+    }
+
+    void PgRCManager::writeAllReadsInPEModeParallel(const string &outPrefix) const {
+        hqPg->getReadsList()->enableConstantAccess(true);
+        lqPg->getReadsList()->enableConstantAccess(true);
+        if (nPg) nPg->getReadsList()->enableConstantAccess(true);
+        const uint8_t PE_PARTS_COUNT = 2;
+        writeAllReadsInSlabsParallel(outPrefix, PE_PARTS_COUNT,
+                [this](uint8_t p, uint_reads_cnt_max slabIdx, uint_reads_cnt_max start, uint_reads_cnt_max end,
+                        char* readPtr) {
+            for (uint_reads_cnt_max i = start * PE_PARTS_COUNT + p; i < end * PE_PARTS_COUNT; i += PE_PARTS_COUNT) {
+                uint_reads_cnt_max idx = rlIdxOrder[i];
+                if (idx < hqReadsCount)
+                    hqPg->getRead(idx, readPtr);
+                else {
+                    if (idx < nonNPgReadsCount)
+                        lqPg->getRead_RawSequence(idx - hqReadsCount, readPtr);
+                    else
+                        nPg->getRead_RawSequence(idx - nonNPgReadsCount, readPtr);
+                    if (p)
+                        PgSAHelpers::reverseComplementInPlace(readPtr, readLength);
+                }
+                readPtr += readLength;
+                *(readPtr++) = '\n';
+            }
+        });
+    }
+
+    template <typename uint_pg_len>
+    void PgRCManager::writeAllReadsInORDModeParallel(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos) const {
+        hqPg->getReadsList()->enableConstantAccess(true);
+        const uint8_t parts = singleReadsMode?1:2;
+        const uint_reads_cnt_max partReadsCount = readsTotalCount / parts;
+        const uint_reads_cnt_max slabReadsCount = this->slabReadsCount();
+        const uint_reads_cnt_max slabsCount = (partReadsCount + slabReadsCount - 1) / slabReadsCount;
+        // HQ reads are stored in the order of appearance (prefix sums of their counts in slabs are required)
+        vector<uint_reads_cnt_max> hqRlIdxStart(parts * slabsCount + 1, 0);
+        #pragma omp parallel for schedule(static) num_threads(numberOfThreads)
+        for(int64_t j = 0; j < (int64_t) (parts * slabsCount); j++) {
+            const uint_reads_cnt_max start = partReadsCount * (j / slabsCount) + (j % slabsCount) * slabReadsCount;
+            const uint_reads_cnt_max end = start - partReadsCount * (j / slabsCount) + slabReadsCount < partReadsCount ?
+                    start + slabReadsCount : partReadsCount * (j / slabsCount + 1);
+            uint_reads_cnt_max hqCount = 0;
+            for (uint_reads_cnt_max i = start; i < end; i++)
+                hqCount += orgIdx2PgPos[i] < hqPgLen;
+            hqRlIdxStart[j + 1] = hqCount;
+        }
+        for(uint_reads_cnt_max j = 0; j < parts * slabsCount; j++)
+            hqRlIdxStart[j + 1] += hqRlIdxStart[j];
+        writeAllReadsInSlabsParallel(outPrefix, parts,
+                [this, &orgIdx2PgPos, &hqRlIdxStart, partReadsCount, slabsCount](uint8_t p, uint_reads_cnt_max slabIdx,
+                        uint_reads_cnt_max start, uint_reads_cnt_max end, char* readPtr) {
+            uint_reads_cnt_max hqRlIdx = hqRlIdxStart[p * slabsCount + slabIdx];
+            for (uint_reads_cnt_max i = partReadsCount * p + start; i < partReadsCount * p + end; i++) {
+                uint_pg_len pos = orgIdx2PgPos[i];
+                if (pos < hqPgLen)
+                    hqPg->getRead_Unsafe(hqRlIdx++, pos, readPtr);
+                else {
+                    if (pos < nonNPgLen)
+                        lqPg->getRawSequenceOfReadLength(readPtr, pos - hqPgLen);
+                    else
+                        nPg->getRawSequenceOfReadLength(readPtr, pos - nonNPgLen);
+                    if (p)
+                        PgSAHelpers::reverseComplementInPlace(readPtr, readLength);
+                }
+                readPtr += readLength;
+                *(readPtr++) = '\n';
+            }
+        });
+    }
+    template void PgRCManager::writeAllReadsInORDModeParallel<uint_pg_len_std>(const string &outPrefix, vector<uint_pg_len_std> &orgIdx2PgPos) const;
+    template void PgRCManager::writeAllReadsInORDModeParallel<uint_pg_len_max>(const string &outPrefix, vector<uint_pg_len_max> &orgIdx2PgPos) const;
+
     uint_reads_cnt_max PgRCManager::dnaStreamSize() const {
         return (hqPg->getReadsSetProperties()->readsCount + lqPg->getReadsSetProperties()->readsCount) *
                (hqPg->getReadsSetProperties()->maxReadLength + 1);
@@ -829,9 +988,9 @@ namespace PgTools {
             lqPg->getReadsList()->orgIdx.clear();
             nPg->getReadsList()->orgIdx.clear();
             uint8_t parts = singleReadsMode?1:2;
-            for (uint_reads_cnt_std i = 0; i < readsTotalCount; i++) {
+            for (uint_reads_cnt_max i = 0; i < readsTotalCount; i++) {
                 uint_pg_len_max pos = isJoinedPgLengthStd ? orgIdx2StdPgPos[i] : orgIdx2PgPos[i];
-                uint_reads_cnt_std orgIdx = i < readsTotalCount / parts ? i * parts : (i - readsTotalCount / parts) * parts + 1;
+                uint_reads_cnt_max orgIdx = i < readsTotalCount / parts ? i * parts : (i - readsTotalCount / parts) * parts + 1;
                 if (pos < hqPgLen)
                     hqPg->getReadsList()->pos.push_back(pos);
                 else if (pos < nonNPgLen) {
@@ -851,9 +1010,14 @@ namespace PgTools {
     }
 
     void PgRCManager::validateAllPgs() {
-        vector<uint_reads_cnt_max> orgIdx2rlIdx = getAllPgsOrgIdxs2RlIdx();
-        ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                srcFastqFile, pairFastqFile);
+        ReadsIndexValues orgIdx2rlIdx = getAllPgsOrgIdxs2RlIdx();
+        // the reads store (if kept for validation) holds the pair reads after applying revComplPairFile
+        uint_read_len_max storeReadLength = 0;
+        const bool validateWithReadsStore = ReadsSetPersistence::probePackedReadsStore(readsStoreFile, storeReadLength);
+        const bool revComplStoredPairReads = validateWithReadsStore && revComplPairFile;
+        ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = validateWithReadsStore ?
+                ReadsSetPersistence::createPackedReadsStoreIterator(readsStoreFile) :
+                ReadsSetPersistence::createManagedReadsIterator(srcFastqFile, pairFastqFile);
 
         vector<bool> validated(readsTotalCount, false);
         uint_reads_cnt_max notValidatedCount = 0;
@@ -881,7 +1045,10 @@ namespace PgTools {
                 if (!singleReadsMode && !ignorePairOrderInformation && (i % 2 == 1))
                     PgSAHelpers::reverseComplementInPlace(read);
             }
-            if (read != allReadsIterator->getRead())
+            string orgRead = allReadsIterator->getRead();
+            if (revComplStoredPairReads && (i % 2 == 1))
+                PgSAHelpers::reverseComplementInPlace(orgRead);
+            if (read != orgRead)
                 errorsCount++;
         }
         uint_reads_cnt_max missingCount = 0;
@@ -900,15 +1067,15 @@ namespace PgTools {
 
     }
 
-    const vector<uint_reads_cnt_max> PgRCManager::getAllPgsOrgIdxs2RlIdx() const {
-        vector<uint_reads_cnt_max> orgIdx2rlIdx;
+    const ReadsIndexValues PgRCManager::getAllPgsOrgIdxs2RlIdx() const {
+        ReadsIndexValues orgIdx2rlIdx(readsTotalCount);
         orgIdx2rlIdx.resize(readsTotalCount);
         for(uint_reads_cnt_max i = 0; i < hqPg->getReadsSetProperties()->readsCount; i++)
-            orgIdx2rlIdx[hqPg->getReadsList()->orgIdx[i]] = i;
+            orgIdx2rlIdx.set(hqPg->getReadsList()->orgIdx[i], i);
         for(uint_reads_cnt_max i = 0; i < lqPg->getReadsSetProperties()->readsCount; i++)
-            orgIdx2rlIdx[lqPg->getReadsList()->orgIdx[i]] = hqPg->getReadsSetProperties()->readsCount + i;
+            orgIdx2rlIdx.set(lqPg->getReadsList()->orgIdx[i], hqPg->getReadsSetProperties()->readsCount + i);
         for(uint_reads_cnt_max i = 0; i < nPgReadsCount; i++)
-            orgIdx2rlIdx[nPg->getReadsList()->orgIdx[i]] = nonNPgReadsCount + i;
+            orgIdx2rlIdx.set(nPg->getReadsList()->orgIdx[i], nonNPgReadsCount + i);
         return orgIdx2rlIdx;
     }
 
@@ -930,8 +1097,8 @@ namespace PgTools {
         uint_reads_cnt_max errorsCount = 0;
         if (preserveOrderMode) {
             rlIdxOrder = getAllPgsOrgIdxs2RlIdx();
-            for(uint_reads_cnt_std i = 0; i < readsTotalCount; i++) {
-                uint_reads_cnt_std rlIdx = rlIdxOrder[i];
+            for(uint_reads_cnt_max i = 0; i < readsTotalCount; i++) {
+                uint_reads_cnt_max rlIdx = rlIdxOrder[i];
                 if (validated[rlIdx]) {
                     notValidatedCount++;
                     continue;
@@ -940,18 +1107,18 @@ namespace PgTools {
                     errorsCount++;
             }
         } else {
-            for(uint_reads_cnt_std p = 0; p < readsTotalCount / 2; p++) {
-                uint_reads_cnt_std rlIdx = rlIdxOrder[p * 2];
-                uint_reads_cnt_std rlPairIdx = rlIdxOrder[p * 2 + 1];
+            for(uint_reads_cnt_max p = 0; p < readsTotalCount / 2; p++) {
+                uint_reads_cnt_max rlIdx = rlIdxOrder[p * 2];
+                uint_reads_cnt_max rlPairIdx = rlIdxOrder[p * 2 + 1];
                 if (validated[rlIdx]) notValidatedCount++;
                 if (validated[rlPairIdx]) notValidatedCount++;
                 if (!validated[rlIdx] && !validated[rlPairIdx]) {
                     validated[rlIdx] = true;
                     validated[rlPairIdx] = true;
-                    uint_reads_cnt_std orgIdx = getAllPgsOrgIdx(rlIdx);
-                    uint_reads_cnt_std orgPairIdx = getAllPgsOrgIdx(rlPairIdx);
-                    uint_reads_cnt_std smallerIdx = orgIdx < orgPairIdx ? orgIdx : orgPairIdx;
-                    uint_reads_cnt_std largerIdx = orgIdx >= orgPairIdx ? orgIdx : orgPairIdx;
+                    uint_reads_cnt_max orgIdx = getAllPgsOrgIdx(rlIdx);
+                    uint_reads_cnt_max orgPairIdx = getAllPgsOrgIdx(rlPairIdx);
+                    uint_reads_cnt_max smallerIdx = orgIdx < orgPairIdx ? orgIdx : orgPairIdx;
+                    uint_reads_cnt_max largerIdx = orgIdx >= orgPairIdx ? orgIdx : orgPairIdx;
                     if (largerIdx - smallerIdx != 1 || smallerIdx % 2)
                         errorsCount++;
                     else if (!ignorePairOrderInformation && smallerIdx != orgIdx)
@@ -970,7 +1137,7 @@ namespace PgTools {
     template<typename uint_pg_len>
     void PgRCManager::applyRevComplPairFileToPgs(vector<uint_pg_len> &orgIdx2PgPos) {
         if (preserveOrderMode) {
-            uint_reads_cnt_std hqRlIdx = 0;
+            uint_reads_cnt_max hqRlIdx = 0;
             const uint_reads_cnt_max pairsCount = readsTotalCount / 2;
             for (uint_reads_cnt_max i = 0; i < pairsCount; i++) {
                     uint_pg_len pgPos = orgIdx2PgPos[i];
@@ -986,7 +1153,7 @@ namespace PgTools {
             }
         } else {
             for (uint_reads_cnt_max i = 1; i < readsTotalCount; i += 2) {
-                uint_reads_cnt_std idx = rlIdxOrder[i];
+                uint_reads_cnt_max idx = rlIdxOrder[i];
                 if (idx < hqReadsCount)
                     hqPg->getReadsList()->revComp[idx] = !hqPg->getReadsList()->revComp[idx];
             }
@@ -1003,9 +1170,11 @@ namespace PgTools {
             cout << "Reads list text mode unsupported during decompression." << endl;
             exit(EXIT_FAILURE);
         }
+        ParallelStreamsDecompressor rlPsd;
         ExtendedReadsListWithConstantAccessOption* hqCaeRl =
                 ExtendedReadsListWithConstantAccessOption::loadConstantAccessExtendedReadsList(pgrcIn,
-                        &hqPgh, &hqRsProp, srcFastqFile.empty()?"":pgSeqFinalHqPrefix, preserveOrderMode);
+                        &hqPgh, &hqRsProp, srcFastqFile.empty()?"":pgSeqFinalHqPrefix, preserveOrderMode,
+                        false, false, &rlPsd);
         PseudoGenomeHeader lqPgh(pgrcIn);
         ReadsSetProperties lqRsProp(pgrcIn);
         if (confirmTextReadMode(pgrcIn)) {
@@ -1013,7 +1182,7 @@ namespace PgTools {
             exit(EXIT_FAILURE);
         }
         ExtendedReadsListWithConstantAccessOption* lqCaeRl = ExtendedReadsListWithConstantAccessOption::loadConstantAccessExtendedReadsList(pgrcIn,
-                    &lqPgh, &lqRsProp, srcFastqFile.empty()?"":pgSeqFinalLqPrefix, preserveOrderMode, true, true);
+                    &lqPgh, &lqRsProp, srcFastqFile.empty()?"":pgSeqFinalLqPrefix, preserveOrderMode, true, true, &rlPsd);
         ExtendedReadsListWithConstantAccessOption* nCaeRl = 0;
         ReadsSetProperties nRsProp;
         PseudoGenomeHeader nPgh;
@@ -1025,8 +1194,19 @@ namespace PgTools {
                 exit(EXIT_FAILURE);
             }
             nCaeRl = ExtendedReadsListWithConstantAccessOption::loadConstantAccessExtendedReadsList(pgrcIn,
-                    &nPgh, &nRsProp, srcFastqFile.empty()?"":pgNPrefix, preserveOrderMode, true, true);
+                    &nPgh, &nRsProp, srcFastqFile.empty()?"":pgNPrefix, preserveOrderMode, true, true, &rlPsd);
         }
+        // reads lists are decoded in the background (while the order information and Pgs are loaded)
+        bool backgroundRlDecompression = ENABLE_PARALLEL_DECOMPRESSION && numberOfThreads > 1;
+#ifdef DEVELOPER_BUILD
+        backgroundRlDecompression &= !dump_after_decompression;
+#endif
+        std::thread rlDecompression;
+        ostringstream rlDecompressionLog;
+        if (backgroundRlDecompression)
+            rlDecompression = std::thread([&rlPsd, &rlDecompressionLog]() { rlPsd.decompress(rlDecompressionLog); });
+        else
+            rlPsd.decompress();
         readLength = hqRsProp.maxReadLength;
         hqReadsCount = hqRsProp.readsCount;
         lqReadsCount = lqRsProp.readsCount;
@@ -1045,12 +1225,20 @@ namespace PgTools {
                 SeparatedPseudoGenomePersistence::decompressReadsPgPositions<uint_pg_len_max>(pgrcIn, orgIdx2PgPos,
                         readsTotalCount, singleReadsMode);
         } else {
-            SeparatedPseudoGenomePersistence::decompressReadsOrder(pgrcIn, rlIdxOrder,
+            SeparatedPseudoGenomePersistence::decompressReadsOrder(pgrcIn, rlIdxOrder, readsTotalCount,
                                                                    preserveOrderMode, ignorePairOrderInformation, singleReadsMode);
         }
         cout << "... loaded Pgs Reads Lists (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
         string hqPgSeq, lqPgSeq, nPgSeq;
         SimplePgMatcher::restoreMatchedPgs(pgrcIn, hqPgLen, hqPgSeq, lqPgSeq, nPgSeq);
+        if (rlDecompression.joinable()) {
+            rlDecompression.join();
+            *PgSAHelpers::logout << rlDecompressionLog.str();
+        }
+        cout << "Loaded Pg reads list containing " << hqReadsCount << " reads." << endl;
+        cout << "Loaded Pg reads list containing " << lqReadsCount << " reads." << endl;
+        if (separateNReads)
+            cout << "Loaded Pg reads list containing " << nPgReadsCount << " reads." << endl;
         hqPg = new SeparatedPseudoGenome(move(hqPgSeq), hqCaeRl, &hqRsProp);
         lqPg = new SeparatedPseudoGenome(move(lqPgSeq), lqCaeRl, &lqRsProp);
         nPg = new SeparatedPseudoGenome(move(nPgSeq), nCaeRl, &nRsProp);
@@ -1085,12 +1273,10 @@ namespace PgTools {
         readLength = hqPg->getReadsSetProperties()->maxReadLength;
     }
 
-    uint_read_len_max probeReadsLength(const string &srcFastqFile) {
-        ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt = ReadsSetPersistence::createManagedReadsIterator(
-                srcFastqFile);
+    uint_read_len_max probeReadsLength(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt) {
         readsIt->moveNext();
         uint_read_len_max readsLength = readsIt->getReadLength();
-        delete(readsIt);
+        readsIt->rewind();
         return readsLength;
     }
 
@@ -12,8 +12,9 @@
 #include <queue>
 #include <mutex>
 #include <thread>
+#include <functional>
 
-#define ENABLE_PARALLEL_DECOMPRESSION false
+#define ENABLE_PARALLEL_DECOMPRESSION true
 
 namespace PgTools {
 
@@ -25,8 +26,8 @@ namespace PgTools {
 
     static const char PGRC_VERSION_MODE = '#';
     static const char PGRC_VERSION_MAJOR = 1;
-    static const char PGRC_VERSION_MINOR = 2;
-    static const char PGRC_VERSION_REVISION = 2;
+    static const char PGRC_VERSION_MINOR = 3;
+    static const char PGRC_VERSION_REVISION = 0;
 
     class PgRCManager {
     private:
@@ -63,6 +64,7 @@ namespace PgTools {
         char preMatchingMode = CHAR_MAX;
         char matchingMode = CHAR_MAX;
         uint16_t targetPgMatchLength = DEFAULT_UINT16_PARAM;
+        bool revComplPgGenerationMode = false;
 
         // CHAIN MANAGEMENT
         uint8_t skipStages = 0;
@@ -91,11 +93,11 @@ namespace PgTools {
         SeparatedPseudoGenome *lqPg = 0;
         SeparatedPseudoGenome *nPg = 0;
 
-        vector<uint_reads_cnt_std> rlIdxOrder;
+        ReadsIndexValues rlIdxOrder;
         vector<uint_pg_len_max> orgIdx2PgPos;
         vector<uint_pg_len_std> orgIdx2StdPgPos;
 
-        bool revComplPairFile;
+        bool revComplPairFile = false;
         bool qualityDivision;
         bool generatorDivision;
         string lqDivisionFile;
@@ -108,6 +110,11 @@ namespace PgTools {
         string pgSeqFinalLqPrefix;
         string pgNPrefix;
         string mappedLqDivisionFile;
+        // all reads packed in a single pass (read by the following stages instead of reparsing input)
+        string readsStoreFile;
+        bool readsStoreAvailable = false;
+        // input iterator positioned at start after probing the reads length (consumed by the first stage)
+        ReadsSourceIteratorTemplate<uint_read_len_max>* probedReadsIterator = 0;
 
         // Decompression chain variables
         char pgrcVersionMajor = 1;
@@ -167,6 +174,10 @@ namespace PgTools {
             PgRCManager::singleReadsMode = true;
         }
 
+        void enableRevComplPgGeneration() {
+            PgRCManager::revComplPgGenerationMode = true;
+        }
+
         void allowVariableParams() {
             PgRCManager::forceConstantParamsMode = false;
         }
@@ -296,6 +307,13 @@ namespace PgTools {
             PgRCManager::endAtStage = endAtStage;
         }
 
+        // reverse complements are overlapped only in HQ Pg (unsupported by reads lists in original order mode)
+        bool isRevComplPgGenerationEnabled() { return revComplPgGenerationMode && !preserveOrderMode; }
+
+        ReadsSourceIteratorTemplate<uint_read_len_max>* createAllReadsIterator();
+
+        void persistReadsStore();
+
         void runQualityBasedDivision();
 
         void runPgGeneratorBasedReadsDivision();
@@ -357,12 +375,25 @@ namespace PgTools {
         template<typename uint_pg_len>
         void writeAllReadsInORDMode(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos) const;
 
+        // maximal number of output chunks waiting for writing
+        const size_t OUT_QUEUE_LIMIT = 256;
+
         std::mutex mut;
         std::queue<string> out_queue;
         std::condition_variable data_cond;
+        std::condition_variable space_cond;
 
         void writeAllReadsInSEModeParallel(const string &outPrefix);
 
+        // fills slab with reads [start, end) of a given part (i.e. output file)
+        typedef std::function<void(uint8_t part, uint_reads_cnt_max slabIdx, uint_reads_cnt_max start,
+                uint_reads_cnt_max end, char* slab)> SlabFiller;
+        uint_reads_cnt_max slabReadsCount() const;
+        void writeAllReadsInSlabsParallel(const string &outPrefix, uint8_t parts, const SlabFiller &fillSlab) const;
+        void writeAllReadsInPEModeParallel(const string &outPrefix) const;
+        template<typename uint_pg_len>
+        void writeAllReadsInORDModeParallel(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos) const;
+
         void pushOutToQueue(string &out);
 
         void finishWritingParallel();
@@ -374,7 +405,7 @@ namespace PgTools {
 
         uint_reads_cnt_max dnaStreamSize() const;
 
-        const vector<uint_reads_cnt_max> getAllPgsOrgIdxs2RlIdx() const;
+        const ReadsIndexValues getAllPgsOrgIdxs2RlIdx() const;
         const uint_reads_cnt_max getAllPgsOrgIdx(uint_reads_cnt_max idx) const;
 
         void preparePgsForValidation() const;
@@ -1,101 +1,194 @@
 #include "ConstantLengthPatternsOnTextHashMatcher.h"
 
+#include <algorithm>
+#include <omp.h>
+
+using namespace PgSAHelpers;
+
+void ConstantLengthPatternsHashIndex::build(vector<Entry> &patterns) {
+    uint64_t bucketsCount = MIN_BUCKETS_COUNT;
+    while (bucketsCount < patterns.size() && bucketsCount < (1ULL << 31))
+        bucketsCount *= 2;
+    bucketsMask = bucketsCount - 1;
+    bucketStart.assign(bucketsCount + 1, 0);
+    #pragma omp parallel for num_threads(numberOfThreads)
+    for(int64_t i = 0; i < (int64_t) patterns.size(); i++) {
+        if (patterns[i].idx == NO_PATTERN_IDX)
+            continue;
+        #pragma omp atomic
+        bucketStart[(patterns[i].hash & bucketsMask) + 1]++;
+    }
+    for(uint64_t b = 0; b < bucketsCount; b++)
+        bucketStart[b + 1] += bucketStart[b];
+    entries.resize(bucketStart[bucketsCount]);
+    vector<uint32_t> bucketFill(bucketStart.begin(), bucketStart.end() - 1);
+    #pragma omp parallel for num_threads(numberOfThreads)
+    for(int64_t i = 0; i < (int64_t) patterns.size(); i++) {
+        if (patterns[i].idx == NO_PATTERN_IDX)
+            continue;
+        uint32_t pos;
+        #pragma omp atomic capture
+        pos = bucketFill[patterns[i].hash & bucketsMask]++;
+        entries[pos] = patterns[i];
+    }
+    patterns.clear();
+    patterns.shrink_to_fit();
+    #pragma omp parallel for schedule(dynamic, 4096) num_threads(numberOfThreads)
+    for(int64_t b = 0; b < (int64_t) bucketsCount; b++)
+        std::sort(entries.begin() + bucketStart[b], entries.begin() + bucketStart[b + 1],
+                [](const Entry &e1, const Entry &e2) { return e1.idx < e2.idx; });
+}
+
 
 DefaultConstantLengthPatternsOnTextHashMatcher::DefaultConstantLengthPatternsOnTextHashMatcher(uint32_t patternLength)
         : patternLength(patternLength), hf(patternLength, 32) {
 }
 
 DefaultConstantLengthPatternsOnTextHashMatcher::~DefaultConstantLengthPatternsOnTextHashMatcher() {
+    delete(iterator);
+}
 
+void DefaultConstantLengthPatternsOnTextHashMatcher::buildIndex() {
+    if (!index.isBuilt())
+        index.build(patterns);
+}
+
+void DefaultConstantLengthPatternsOnTextHashMatcher::iterateOver(const char *txt, uint64_t length) {
+    buildIndex();
+    delete(iterator);
+    iterator = new Iterator(*this, txt, length);
+}
+
+DefaultConstantLengthPatternsOnTextHashMatcher::Iterator::Iterator(
+        const DefaultConstantLengthPatternsOnTextHashMatcher &matcher, const char *txt, uint64_t length)
+        : index(matcher.index), patternLength(matcher.patternLength), hf(matcher.hf), txt(txt) {
+    hf.reset();
+    for(uint32_t i = 0; i < length && i < patternLength; i++)
+        hf.eat(this->txt[i]);
+    this->lastTxtPos = (int64_t) length - patternLength;
+    while (aheadTxtPos < HASH_LOOKUP_AHEAD)
+        hashAhead();
 }
 
 void DefaultConstantLengthPatternsOnTextHashMatcher::addPattern(const char *pattern, uint32_t idx) {
-    if (this->txt != 0) {
+    if (index.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
     hf.reset();
     for(uint32_t i = 0; i < patternLength; i++)
         hf.eat(pattern[i]);
-    hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf.hashvalue, idx));
+    patterns.push_back({ hf.hashvalue, idx });
 }
 
 void DefaultConstantLengthPatternsOnTextHashMatcher::addReadsSetOfPatterns(ConstantLengthReadsSetInterface *readsSet,
                                                                            uint8_t partsCount,
                                                                            vector<bool> matchedReadsBitmap) {
-    if (this->txt != 0) {
+    if (index.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
-    const uint_reads_cnt_max readsCount = readsSet->getReadsSetProperties()->readsCount;
-    for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
-        if (!matchedReadsBitmap.empty() && matchedReadsBitmap[i])
-            continue;
-        uint_read_len_max offset = 0;
-        for (uint8_t j = 0; j < partsCount; j++, offset += patternLength) {
-            hf.reset();
-            for(uint32_t k = 0; k < patternLength; k++)
-                hf.eat(readsSet->getReadSymbol(i, offset + k));
-            hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf.hashvalue, i * partsCount + j));
+    const uint_reads_cnt_max readsCount = readsSet->readsCount();
+    patterns.resize(patterns.size() + readsCount * partsCount);
+    ConstantLengthPatternsHashIndex::Entry* readsPatterns = patterns.data() + patterns.size() - readsCount * partsCount;
+    #pragma omp parallel num_threads(numberOfThreads)
+    {
+        CyclicHash<uint32_t> patternHf(hf);
+        #pragma omp for
+        for (int64_t i = 0; i < (int64_t) readsCount; i++) {
+            ConstantLengthPatternsHashIndex::Entry* readPatterns = readsPatterns + i * partsCount;
+            const bool skipRead = !matchedReadsBitmap.empty() && matchedReadsBitmap[i];
+            uint_read_len_max offset = 0;
+            for (uint8_t j = 0; j < partsCount; j++, offset += patternLength) {
+                if (skipRead) {
+                    readPatterns[j].idx = ConstantLengthPatternsHashIndex::NO_PATTERN_IDX;
+                    continue;
+                }
+                patternHf.reset();
+                for(uint32_t k = 0; k < patternLength; k++)
+                    patternHf.eat(readsSet->getReadSymbol(i, offset + k));
+                readPatterns[j] = { patternHf.hashvalue, (uint32_t) (i * partsCount + j) };
+            }
         }
     }
 }
 
-uint32_t DefaultConstantLengthPatternsOnTextHashMatcher::getHashMatchPatternIndex() {
-    return indexIter->second;
-}
 
-uint64_t DefaultConstantLengthPatternsOnTextHashMatcher::getHashMatchTextPosition() {
-    return this->txtPos;
-}
 
 InterleavedConstantLengthPatternsOnTextHashMatcher::InterleavedConstantLengthPatternsOnTextHashMatcher(
         uint32_t patternLength, const uint8_t patternParts)
-        : patternLength(patternLength), patternParts(patternParts), patternSpan(patternLength*patternParts) {
-    hf.push_back(CyclicHash<uint32_t>(patternLength, 32));
-    for(uint8_t i = 1; i < patternParts; i++)
-        hf.push_back(hf[0]);
+        : patternLength(patternLength), patternParts(patternParts), patternSpan(patternLength*patternParts),
+        hf(patternLength, 32) {
 }
 
 InterleavedConstantLengthPatternsOnTextHashMatcher::~InterleavedConstantLengthPatternsOnTextHashMatcher() {
+    delete(iterator);
+}
+
+void InterleavedConstantLengthPatternsOnTextHashMatcher::buildIndex() {
+    if (!index.isBuilt())
+        index.build(patterns);
+}
 
+void InterleavedConstantLengthPatternsOnTextHashMatcher::iterateOver(const char *txt, uint64_t length) {
+    buildIndex();
+    delete(iterator);
+    iterator = new Iterator(*this, txt, length);
+}
+
+InterleavedConstantLengthPatternsOnTextHashMatcher::Iterator::Iterator(
+        const InterleavedConstantLengthPatternsOnTextHashMatcher &matcher, const char *txt, uint64_t length)
+        : index(matcher.index), patternParts(matcher.patternParts), patternSpan(matcher.patternSpan), txt(txt) {
+    for(uint8_t h = 0; h < patternParts; h++) {
+        hf.push_back(matcher.hf);
+        hf[h].reset();
+        const uint32_t patternGuard = patternSpan + h;
+        for (uint32_t i = h; i < length && i < patternGuard; i += patternParts)
+            hf[h].eat(this->txt[i]);
+    }
+    this->lastTxtPos = (int64_t) length - patternSpan;
+    while (aheadTxtPos < HASH_LOOKUP_AHEAD)
+        hashAhead();
 }
 
 void InterleavedConstantLengthPatternsOnTextHashMatcher::addPattern(const char *pattern, uint32_t idx) {
-    if (this->txt != 0) {
+    if (index.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
-    hf[0].reset();
+    hf.reset();
     for(uint32_t i = 0; i < patternSpan; i += patternParts)
-        hf[0].eat(pattern[i]);
-    hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf[0].hashvalue, idx));
+        hf.eat(pattern[i]);
+    patterns.push_back({ hf.hashvalue, idx });
 }
 
 
 void InterleavedConstantLengthPatternsOnTextHashMatcher::addPackedPatterns(ConstantLengthReadsSetInterface *readsSet,
         int partsCount, vector<bool> matchedReadsBitmap) {
-    if (this->txt != 0) {
+    if (index.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
-    const uint_reads_cnt_max readsCount = readsSet->getReadsSetProperties()->readsCount;
-    for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
-        for (uint8_t j = 0; j < partsCount; j++) {
-            if (!matchedReadsBitmap.empty() && matchedReadsBitmap[i])
-                continue;
-            hf[0].reset();
-            for(uint32_t k = 0; k < patternSpan; k += patternParts)
-                hf[0].eat(readsSet->getReadSymbol(i, j + k));
-            hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf[0].hashvalue, i * partsCount + j));
+    const uint_reads_cnt_max readsCount = readsSet->readsCount();
+    patterns.resize(patterns.size() + readsCount * partsCount);
+    ConstantLengthPatternsHashIndex::Entry* readsPatterns = patterns.data() + patterns.size() - readsCount * partsCount;
+    #pragma omp parallel num_threads(numberOfThreads)
+    {
+        CyclicHash<uint32_t> patternHf(hf);
+        #pragma omp for
+        for (int64_t i = 0; i < (int64_t) readsCount; i++) {
+            ConstantLengthPatternsHashIndex::Entry* readPatterns = readsPatterns + i * partsCount;
+            const bool skipRead = !matchedReadsBitmap.empty() && matchedReadsBitmap[i];
+            for (uint8_t j = 0; j < partsCount; j++) {
+                if (skipRead) {
+                    readPatterns[j].idx = ConstantLengthPatternsHashIndex::NO_PATTERN_IDX;
+                    continue;
+                }
+                patternHf.reset();
+                for(uint32_t k = 0; k < patternSpan; k += patternParts)
+                    patternHf.eat(readsSet->getReadSymbol(i, j + k));
+                readPatterns[j] = { patternHf.hashvalue, (uint32_t) (i * partsCount + j) };
+            }
         }
     }
 }
-
-uint32_t InterleavedConstantLengthPatternsOnTextHashMatcher::getHashMatchPatternIndex() {
-    return indexIter->second;
-}
-
-uint64_t InterleavedConstantLengthPatternsOnTextHashMatcher::getHashMatchTextPosition() {
-    return this->txtPos;
-}
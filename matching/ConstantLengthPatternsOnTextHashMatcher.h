@@ -1,26 +1,89 @@
 #ifndef PGTOOLS_CONSTANTLENGTHPATTERNSONTEXTHASHMATCHER_H
 #define PGTOOLS_CONSTANTLENGTHPATTERNSONTEXTHASHMATCHER_H
 
-#include <unordered_map>
 #include <vector>
 #include "rollinghash/cyclichash.h"
 #include "../readsset/ReadsSetInterface.h"
 
 using namespace std;
 
+// patterns indexes grouped in hash buckets with counting sort (CSR layout)
+class ConstantLengthPatternsHashIndex {
+public:
+    struct Entry {
+        uint32_t hash;
+        uint32_t idx;
+    };
+    // marks pattern slots excluded from the index
+    static const uint32_t NO_PATTERN_IDX = UINT32_MAX;
+
+private:
+    static const uint32_t MIN_BUCKETS_COUNT = 1 << 10;
+
+    vector<uint32_t> bucketStart;
+    vector<Entry> entries;
+    uint32_t bucketsMask = 0;
+
+public:
+    // patterns are released; entries of each bucket are ordered by pattern indexes
+    void build(vector<Entry> &patterns);
+
+    bool isBuilt() const { return !bucketStart.empty(); };
+
+    inline void prefetchBucket(uint32_t hash) const {
+        __builtin_prefetch(bucketStart.data() + (hash & bucketsMask));
+    };
+    inline void prefetchEntries(uint32_t hash) const {
+        __builtin_prefetch(entries.data() + bucketStart[hash & bucketsMask]);
+    };
+    inline void getBucket(uint32_t hash, const Entry* &begin, const Entry* &end) const {
+        const uint32_t b = hash & bucketsMask;
+        begin = entries.data() + bucketStart[b];
+        end = entries.data() + bucketStart[b + 1];
+    };
+};
+
+// number of text positions hashed (and prefetched) in advance of the iterator
+static const int64_t HASH_LOOKUP_AHEAD = 16;
+
 class DefaultConstantLengthPatternsOnTextHashMatcher {
+public:
+    // iteration state over a text (segment); many iterators may share the index of a matcher
+    class Iterator {
+    private:
+        const ConstantLengthPatternsHashIndex &index;
+        const uint32_t patternLength;
+
+        CyclicHash<uint32_t> hf;
+
+        const  char* txt = 0;
+        int64_t txtPos = -1;
+        int64_t lastTxtPos = -1;
+        int64_t aheadTxtPos = 0;
+        uint32_t aheadHash[HASH_LOOKUP_AHEAD];
+        uint32_t currentHash = 0;
+        const ConstantLengthPatternsHashIndex::Entry *indexIter = 0, *indexIterEnd = 0;
+
+        inline void hashAhead();
+
+    public:
+        // requires built index of the matcher
+        Iterator(const DefaultConstantLengthPatternsOnTextHashMatcher &matcher, const char* txt, uint64_t length);
+
+        inline bool moveNext();
+        uint32_t getHashMatchPatternIndex() const { return indexIter->idx; };
+        // relative to the beginning of the iterated text
+        uint64_t getHashMatchTextPosition() const { return txtPos; };
+    };
+
 private:
-    unordered_multimap<uint32_t, uint32_t> hashToIndexMap;
+    vector<ConstantLengthPatternsHashIndex::Entry> patterns;
+    ConstantLengthPatternsHashIndex index;
     const uint32_t patternLength;
 
     CyclicHash<uint32_t> hf;
 
-    const  char* txt = 0;
-    uint64_t txtSize = 0;
-
-    //iterator fields
-    int64_t txtPos = -1;
-    unordered_multimap<uint32_t, uint32_t>::iterator indexIter, indexIterEnd;
+    Iterator* iterator = 0;
 
 public:
     DefaultConstantLengthPatternsOnTextHashMatcher(uint32_t patternLength);
@@ -31,58 +94,88 @@ public:
     void addReadsSetOfPatterns(ConstantLengthReadsSetInterface *readsSet, uint8_t partsCount = 1,
                                vector<bool> matchedReadsBitmap = {});
 
+    // finalizes adding patterns (must precede concurrent iterations)
+    void buildIndex();
+
     //iterator routines
-    inline void iterateOver(const char* txt, uint64_t length);
-    inline bool moveNext();
-    uint32_t getHashMatchPatternIndex();
-    uint64_t getHashMatchTextPosition();
+    void iterateOver(const char* txt, uint64_t length);
+    inline bool moveNext() { return iterator->moveNext(); };
+    uint32_t getHashMatchPatternIndex() { return iterator->getHashMatchPatternIndex(); };
+    uint64_t getHashMatchTextPosition() { return iterator->getHashMatchTextPosition(); };
 };
 
 
-void DefaultConstantLengthPatternsOnTextHashMatcher::iterateOver(const char *txt, uint64_t length) {
-    this->txt = txt;
-    this->txtSize = length;
-    hf.reset();
-    for(uint32_t i = 0; i < txtSize && i < patternLength; i++)
-        hf.eat(this->txt[i]);
-    this->txtPos = -1;
-    indexIter = hashToIndexMap.end();
-    indexIterEnd = hashToIndexMap.end();
+void DefaultConstantLengthPatternsOnTextHashMatcher::Iterator::hashAhead() {
+    if (aheadTxtPos <= lastTxtPos) {
+        aheadHash[aheadTxtPos % HASH_LOOKUP_AHEAD] = hf.hashvalue;
+        index.prefetchBucket(hf.hashvalue);
+        if (aheadTxtPos < lastTxtPos)
+            hf.update(this->txt[aheadTxtPos], this->txt[aheadTxtPos + patternLength]);
+    }
+    aheadTxtPos++;
 }
 
-bool DefaultConstantLengthPatternsOnTextHashMatcher::moveNext() {
+bool DefaultConstantLengthPatternsOnTextHashMatcher::Iterator::moveNext() {
     if (indexIter != indexIterEnd) {
-        indexIter++;
-        if (indexIter != indexIterEnd)
-            return true;
+        while (++indexIter != indexIterEnd)
+            if (indexIter->hash == currentHash)
+                return true;
     }
-    while(++this->txtPos <= (int64_t) txtSize - patternLength) {
-        auto indexIterRange = hashToIndexMap.equal_range(hf.hashvalue);
-        hf.update(this->txt[this->txtPos], this->txt[this->txtPos + patternLength]);
-        indexIter = indexIterRange.first;
-        indexIterEnd = indexIterRange.second;
-        if (indexIter != indexIterEnd)
-            return true;
+    while(++this->txtPos <= lastTxtPos) {
+        currentHash = aheadHash[this->txtPos % HASH_LOOKUP_AHEAD];
+        hashAhead();
+        if (this->txtPos + HASH_LOOKUP_AHEAD / 2 <= lastTxtPos)
+            index.prefetchEntries(aheadHash[(this->txtPos + HASH_LOOKUP_AHEAD / 2) % HASH_LOOKUP_AHEAD]);
+        index.getBucket(currentHash, indexIter, indexIterEnd);
+        for (; indexIter != indexIterEnd; indexIter++)
+            if (indexIter->hash == currentHash)
+                return true;
     }
     return false;
 }
 
 class InterleavedConstantLengthPatternsOnTextHashMatcher {
+public:
+    // iteration state over a text (segment); many iterators may share the index of a matcher
+    class Iterator {
+    private:
+        const ConstantLengthPatternsHashIndex &index;
+        const uint8_t patternParts;
+        const uint32_t patternSpan;
+
+        std::vector<CyclicHash<uint32_t>> hf;
+        uint8_t currentHF = 0;
+
+        const  char* txt = 0;
+        int64_t txtPos = -1;
+        int64_t lastTxtPos = -1;
+        int64_t aheadTxtPos = 0;
+        uint32_t aheadHash[HASH_LOOKUP_AHEAD];
+        uint32_t currentHash = 0;
+        const ConstantLengthPatternsHashIndex::Entry *indexIter = 0, *indexIterEnd = 0;
+
+        inline void hashAhead();
+
+    public:
+        // requires built index of the matcher
+        Iterator(const InterleavedConstantLengthPatternsOnTextHashMatcher &matcher, const char* txt, uint64_t length);
+
+        inline bool moveNext();
+        uint32_t getHashMatchPatternIndex() const { return indexIter->idx; };
+        // relative to the beginning of the iterated text
+        uint64_t getHashMatchTextPosition() const { return txtPos; };
+    };
+
 private:
-    unordered_multimap<uint32_t, uint32_t> hashToIndexMap;
+    vector<ConstantLengthPatternsHashIndex::Entry> patterns;
+    ConstantLengthPatternsHashIndex index;
     const uint32_t patternLength;
     const uint8_t patternParts;
     const uint32_t patternSpan;
 
-    std::vector<CyclicHash<uint32_t>> hf;
-    uint8_t currentHF = 0;
-
-    const  char* txt = 0;
-    uint64_t txtSize = 0;
+    CyclicHash<uint32_t> hf;
 
-    //iterator fields
-    int64_t txtPos = -1;
-    unordered_multimap<uint32_t, uint32_t>::iterator indexIter, indexIterEnd;
+    Iterator* iterator = 0;
 
 public:
     InterleavedConstantLengthPatternsOnTextHashMatcher(uint32_t patternLength, const uint8_t patternParts);
@@ -91,47 +184,47 @@ public:
 
     void addPattern(const char* pattern, uint32_t idx);
 
+    // finalizes adding patterns (must precede concurrent iterations)
+    void buildIndex();
+
     //iterator routines
-    inline void iterateOver(const char* txt, uint64_t length);
-    inline bool moveNext();
-    uint32_t getHashMatchPatternIndex();
-    uint64_t getHashMatchTextPosition();
+    void iterateOver(const char* txt, uint64_t length);
+    inline bool moveNext() { return iterator->moveNext(); };
+    uint32_t getHashMatchPatternIndex() { return iterator->getHashMatchPatternIndex(); };
+    uint64_t getHashMatchTextPosition() { return iterator->getHashMatchTextPosition(); };
 
     void addPackedPatterns(ConstantLengthReadsSetInterface*readsSet, int partsCount,
                            vector<bool> matchedReadsBitmap = {});
 };
 
 
-void InterleavedConstantLengthPatternsOnTextHashMatcher::iterateOver(const char *txt, uint64_t length) {
-    this->txt = txt;
-    this->txtSize = length;
-    for(uint8_t h = 0; h < patternParts; h++) {
-        hf[h].reset();
-        const uint32_t patternGuard = patternSpan + h;
-        for (uint32_t i = h; i < txtSize && i < patternGuard; i += patternParts)
-            hf[h].eat(this->txt[i]);
+void InterleavedConstantLengthPatternsOnTextHashMatcher::Iterator::hashAhead() {
+    if (aheadTxtPos <= lastTxtPos) {
+        aheadHash[aheadTxtPos % HASH_LOOKUP_AHEAD] = hf[currentHF].hashvalue;
+        index.prefetchBucket(hf[currentHF].hashvalue);
+        if (aheadTxtPos + patternParts <= lastTxtPos)
+            hf[currentHF].update(this->txt[aheadTxtPos], this->txt[aheadTxtPos + patternSpan]);
+        if (++currentHF == patternParts)
+            currentHF = 0;
     }
-    this->txtPos = -1;
-    indexIter = hashToIndexMap.end();
-    indexIterEnd = hashToIndexMap.end();
-    currentHF = 0;
+    aheadTxtPos++;
 }
 
-bool InterleavedConstantLengthPatternsOnTextHashMatcher::moveNext() {
+bool InterleavedConstantLengthPatternsOnTextHashMatcher::Iterator::moveNext() {
     if (indexIter != indexIterEnd) {
-        indexIter++;
-        if (indexIter != indexIterEnd)
-            return true;
+        while (++indexIter != indexIterEnd)
+            if (indexIter->hash == currentHash)
+                return true;
     }
-    while(++this->txtPos <= txtSize - patternSpan) {
-        auto indexIterRange = hashToIndexMap.equal_range(hf[currentHF].hashvalue);
-        hf[currentHF++].update(this->txt[this->txtPos], this->txt[this->txtPos + patternSpan]);
-        if (currentHF == patternParts)
-            currentHF = 0;
-        indexIter = indexIterRange.first;
-        indexIterEnd = indexIterRange.second;
-        if (indexIter != indexIterEnd)
-            return true;
+    while(++this->txtPos <= lastTxtPos) {
+        currentHash = aheadHash[this->txtPos % HASH_LOOKUP_AHEAD];
+        hashAhead();
+        if (this->txtPos + HASH_LOOKUP_AHEAD / 2 <= lastTxtPos)
+            index.prefetchEntries(aheadHash[(this->txtPos + HASH_LOOKUP_AHEAD / 2) % HASH_LOOKUP_AHEAD]);
+        index.getBucket(currentHash, indexIter, indexIterEnd);
+        for (; indexIter != indexIterEnd; indexIter++)
+            if (indexIter->hash == currentHash)
+                return true;
     }
     return false;
 }
@@ -345,13 +345,16 @@ namespace PgTools {
         }
         srcRl->pos.clear();
 
-        vector<uint_reads_cnt_max> rlPosOrd(srcPgh->getReadsCount());
+        ReadsIndexValues rlPosOrd(srcPgh->getReadsCount());
         for (uint_reads_cnt_max i = 0; i < srcPgh->getReadsCount(); i++)
-            rlPosOrd[i] = i;
-        sort(rlPosOrd.begin(), rlPosOrd.end(),
-             [this](const uint_reads_cnt_max &rlPosIdx1, const uint_reads_cnt_max &rlPosIdx2) -> bool {
-                 return newRlPos[rlPosIdx1] < newRlPos[rlPosIdx2];
-             });
+            rlPosOrd.push_back(i);
+        auto newRlPosOrder = [this](const uint_reads_cnt_max rlPosIdx1, const uint_reads_cnt_max rlPosIdx2) -> bool {
+            return newRlPos[rlPosIdx1] < newRlPos[rlPosIdx2];
+        };
+        if (rlPosOrd.isMaxMode())
+            sort(rlPosOrd.maxValues.begin(), rlPosOrd.maxValues.end(), newRlPosOrder);
+        else
+            sort(rlPosOrd.stdValues.begin(), rlPosOrd.stdValues.end(), newRlPosOrder);
 
         SeparatedPseudoGenomeOutputBuilder builder(destPgIsSrcPg?destPgPrefix:srcPgPrefix);
         builder.copyPseudoGenomeProperties(srcPgPrefix);
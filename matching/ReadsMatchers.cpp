@@ -10,18 +10,6 @@
 
 namespace PgTools {
 
-    uint8_t countMismatches(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
-        uint8_t res = 0;
-        const char *patEnd = pattern + length;
-        while (pattern != patEnd) {
-            if (*pattern++ != *text++) {
-                if (res++ >= maxMismatches)
-                    return NOT_MATCHED_COUNT;
-            }
-        }
-        return res;
-    }
-
     void reportMismatches(const char *read, const char *pgPart, const uint_read_len_max length, ofstream &mismatchesDest) {
         uint64_t pos = 0;
         do {
@@ -96,6 +84,18 @@ namespace PgTools {
         falseMatchCount = 0;
     }
 
+    int64_t DefaultReadsMatcher::pgSegmentsCount() const {
+        return numberOfThreads * PG_SEGMENTS_PER_THREAD;
+    }
+
+    void DefaultReadsMatcher::getPgSegment(int64_t s, uint32_t patternSpan, uint64_t &segBegin,
+                                           uint64_t &segTxtLength) const {
+        const uint64_t segLength = (pgLength + pgSegmentsCount() - 1) / pgSegmentsCount();
+        segBegin = s * segLength < pgLength ? s * segLength : pgLength;
+        const uint64_t segEnd = segBegin + segLength < pgLength ? segBegin + segLength : pgLength;
+        segTxtLength = segEnd + patternSpan - 1 < pgLength ? segEnd + patternSpan - 1 - segBegin : pgLength - segBegin;
+    }
+
     void AbstractReadsApproxMatcher::initMatchingContinuation(DefaultReadsMatcher *pMatcher) {
         pMatcher->transferMatchingResults(this);
     }
@@ -151,9 +151,7 @@ namespace PgTools {
         missedReadsDest.close();
         dumpDest.close();
     }
-    void DefaultReadsMatcher::matchConstantLengthReads() {
-        initMatching();
-
+    void DefaultReadsMatcher::executeMatchingOfBothStrands() {
         this->executeMatching(false);
 
         if (revComplPg) {
@@ -163,16 +161,16 @@ namespace PgTools {
         }
     }
 
+    void DefaultReadsMatcher::matchConstantLengthReads() {
+        initMatching();
+
+        this->executeMatchingOfBothStrands();
+    }
+
     void AbstractReadsApproxMatcher::continueMatchingConstantLengthReads(DefaultReadsMatcher *pMatcher) {
         this->initMatchingContinuation(pMatcher);
 
-        this->executeMatching(false);
-
-        if (revComplPg) {
-            PgSAHelpers::reverseComplementInPlace(pgPtr, pgLength);
-            this->executeMatching(true);
-            PgSAHelpers::reverseComplementInPlace(pgPtr, pgLength);
-        }
+        this->executeMatchingOfBothStrands();
     }
 
     DefaultReadsExactMatcher::DefaultReadsExactMatcher(char* pgPtr, const uint_pg_len_max pgLength, bool revComplPg,
@@ -190,30 +188,39 @@ namespace PgTools {
     void DefaultReadsExactMatcher::executeMatching(bool revCompMode) {
         time_checkpoint();
         cout << "Matching" << (revCompMode?" in Pg reverse":"") << "...\n" << endl;
-        hashMatcher->iterateOver(pgPtr, pgLength);
-
-        while (hashMatcher->moveNext()) {
-            const uint64_t matchPosition = hashMatcher->getHashMatchTextPosition();
-            const uint_reads_cnt_max matchReadIndex = hashMatcher->getHashMatchPatternIndex();
-
-            bool exactMatch = readsSet->compareReadWithPattern(matchReadIndex, pgPtr + matchPosition) == 0;
-            if (exactMatch) {
-                if (readMatchPos[matchReadIndex] == NOT_MATCHED_POSITION) {
-                    readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                    if (revCompMode) readMatchRC[matchReadIndex] = true;
-                    matchedReadsCount++;
+        hashMatcher->buildIndex();
+        // the first (leftmost) exact match of a read is reported
+        vector<uint64_t> firstMatchPos(readsCount, NOT_MATCHED_POSITION);
+        uint64_t exactMatchCount = 0;
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:exactMatchCount) reduction(+:falseMatchCount) \
+                                num_threads(numberOfThreads)
+        for(int64_t s = 0; s < pgSegmentsCount(); s++) {
+            uint64_t segBegin, segTxtLength;
+            getPgSegment(s, matchingLength, segBegin, segTxtLength);
+            DefaultConstantLengthPatternsOnTextHashMatcher::Iterator hashIter(*hashMatcher, pgPtr + segBegin, segTxtLength);
+            while (hashIter.moveNext()) {
+                const uint64_t matchPosition = segBegin + hashIter.getHashMatchTextPosition();
+                const uint_reads_cnt_max matchReadIndex = hashIter.getHashMatchPatternIndex();
+
+                bool exactMatch = readsSet->compareReadWithPattern(matchReadIndex, pgPtr + matchPosition) == 0;
+                if (exactMatch) {
+                    exactMatchCount++;
+                    uint64_t currentPos = __atomic_load_n(&firstMatchPos[matchReadIndex], __ATOMIC_RELAXED);
+                    while (matchPosition < currentPos && !__atomic_compare_exchange_n(&firstMatchPos[matchReadIndex],
+                            &currentPos, matchPosition, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
                 } else
-                    betterMatchCount++;
-            } else
-                falseMatchCount++;
-/*            if (i++ < 1) {
-                cout << "Matched: " << matchReadIndex << "; " << matchPosition
-                    << "; " << (exactMatch?"positive":"false") << "; " << (revCompMode?"pair strand (RC)":"") << endl;
-                cout << matchedRead << endl;
-                const string pgPart(txt + (matchPosition), matchingLength);
-                cout << pgPart << endl;
-            }*/
+                    falseMatchCount++;
+            }
+        }
+        const uint_reads_cnt_max previouslyMatchedCount = matchedReadsCount;
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
+            if (firstMatchPos[i] == NOT_MATCHED_POSITION || readMatchPos[i] != NOT_MATCHED_POSITION)
+                continue;
+            readMatchPos[i] = revCompMode?pgLength-(firstMatchPos[i]+matchingLength):firstMatchPos[i];
+            if (revCompMode) readMatchRC[i] = true;
+            matchedReadsCount++;
         }
+        betterMatchCount += exactMatchCount - (matchedReadsCount - previouslyMatchedCount);
 
         cout << "... exact matching procedure completed in " << time_millis() << " msec. " << endl;
         cout << "Exact matched " << matchedReadsCount << " reads (" << (readsCount - matchedReadsCount)
@@ -256,6 +263,75 @@ namespace PgTools {
     }
 
 
+    static const uint8_t MATCH_KEY_RANK_SHIFT = 56;
+    static const uint8_t MATCH_KEY_ORDER_SHIFT = 8;
+    static const uint64_t MATCH_KEY_ORDER_LIMIT = 1ULL << (MATCH_KEY_RANK_SHIFT - MATCH_KEY_ORDER_SHIFT);
+
+    uint64_t AbstractReadsApproxMatcher::matchKey(uint8_t mismatchesCount, uint64_t candidateOrder) {
+        // reads matched within minMismatches are not matched further (the first such candidate wins)
+        const uint64_t rank = mismatchesCount <= minMismatches ? 0 : mismatchesCount;
+        return (rank << MATCH_KEY_RANK_SHIFT) | (candidateOrder << MATCH_KEY_ORDER_SHIFT) | mismatchesCount;
+    }
+
+    void AbstractReadsApproxMatcher::initConcurrentMatching(uint64_t candidatesOrderLimit) {
+        if (candidatesOrderLimit >= MATCH_KEY_ORDER_LIMIT) {
+            fprintf(stderr, "Pseudogenome too long for concurrent matching (%lu).\n", (unsigned long) pgLength);
+            exit(EXIT_FAILURE);
+        }
+        readMatchKey.resize(readsCount);
+        #pragma omp parallel for num_threads(numberOfThreads)
+        for(int64_t i = 0; i < (int64_t) readsCount; i++)
+            readMatchKey[i] = matchKey(readMismatchesCount[i], 0);
+    }
+
+    void AbstractReadsApproxMatcher::matchCandidate(uint_reads_cnt_max matchReadIndex, const char *pgPart,
+            uint64_t candidateOrder, uint64_t &falseMatchCount) {
+        uint64_t currentKey = __atomic_load_n(&readMatchKey[matchReadIndex], __ATOMIC_RELAXED);
+        const uint8_t currentRank = currentKey >> MATCH_KEY_RANK_SHIFT;
+        const bool precedes = candidateOrder < ((currentKey >> MATCH_KEY_ORDER_SHIFT) & (MATCH_KEY_ORDER_LIMIT - 1));
+        if (currentRank == 0 && !precedes)
+            return;
+        // preceding candidates win ties
+        uint8_t mismatchesLimit = currentRank == 0 ? minMismatches : (precedes ? currentRank : currentRank - 1);
+        if (mismatchesLimit > maxMismatches)
+            mismatchesLimit = maxMismatches;
+        const uint8_t mismatchesCount = readsSet->countMismatchesVsPattern(matchReadIndex, pgPart,
+                                                                           matchingLength, mismatchesLimit);
+        const uint64_t key = matchKey(mismatchesCount, candidateOrder);
+        if (mismatchesCount > mismatchesLimit || key > currentKey) {
+            falseMatchCount++;
+            return;
+        }
+        while (key < currentKey && !__atomic_compare_exchange_n(&readMatchKey[matchReadIndex], &currentKey, key,
+                true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+
+    void AbstractReadsApproxMatcher::finalizeConcurrentMatching(bool revCompMode, uint_read_len_max partPositionShift) {
+        const uint8_t partsCount = targetMismatches + 1;
+        // chunks are aligned to words of readMatchRC bitmap
+        #pragma omp parallel for schedule(static, 1 << 12) reduction(+:matchedReadsCount) reduction(+:betterMatchCount) \
+                                reduction(+:matchedCountPerMismatches[0:NOT_MATCHED_COUNT+1]) num_threads(numberOfThreads)
+        for(int64_t i = 0; i < (int64_t) readsCount; i++) {
+            const uint64_t candidateOrder = (readMatchKey[i] >> MATCH_KEY_ORDER_SHIFT) & (MATCH_KEY_ORDER_LIMIT - 1);
+            if (candidateOrder == 0)
+                continue;
+            const uint8_t mismatchesCount = (uint8_t) readMatchKey[i];
+            const uint64_t matchPosition = (candidateOrder - 1) / partsCount -
+                    ((candidateOrder - 1) % partsCount) * partPositionShift;
+            if (readMismatchesCount[i] == NOT_MATCHED_COUNT)
+                matchedReadsCount++;
+            else
+                betterMatchCount++;
+            matchedCountPerMismatches[readMismatchesCount[i]]--;
+            matchedCountPerMismatches[mismatchesCount]++;
+            readMatchPos[i] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
+            readMatchRC[i] = revCompMode;
+            readMismatchesCount[i] = mismatchesCount;
+        }
+        readMatchKey.clear();
+        readMatchKey.shrink_to_fit();
+    }
+
     void AbstractReadsApproxMatcher::printApproxMatchingStats() {
         cout << "Matched " << matchedReadsCount << " reads (" << (readsCount - matchedReadsCount)
              << " left; " << betterMatchCount << " better-matches) in " << time_millis() << " msec.  False matches reported: " << falseMatchCount << "."
@@ -289,46 +365,31 @@ namespace PgTools {
     void DefaultReadsApproxMatcher::executeMatching(bool revCompMode) {
         time_checkpoint();
         cout << "Matching" << (revCompMode?" in Pg reverse":"") << "...\n" << endl;
-        hashMatcher->iterateOver(pgPtr, pgLength);
-        while (hashMatcher->moveNext()) {
-            const uint32_t matchPatternIndex = hashMatcher->getHashMatchPatternIndex();
-            uint32_t matchReadIndex = matchPatternIndex / (targetMismatches + 1);
-            if (readMismatchesCount[matchReadIndex] <= minMismatches)
-                continue;
-            uint64_t matchPosition = hashMatcher->getHashMatchTextPosition();
-            const uint_read_len_max positionShift = ((matchPatternIndex % (targetMismatches + 1)) * partLength);
-            if (positionShift > matchPosition)
-                continue;
-            matchPosition -= positionShift;
-            if (matchPosition + readLength > pgLength)
-                continue;
-            if (readMatchPos[matchReadIndex] == (revCompMode?pgLength-(matchPosition+matchingLength):matchPosition))
-                continue;
-            uint8_t currentMismatchesLimit = readMismatchesCount[matchReadIndex]==NOT_MATCHED_COUNT?maxMismatches
-                    :(readMismatchesCount[matchReadIndex] - 1);
-            const uint8_t mismatchesCount = readsSet->countMismatchesVsPattern(matchReadIndex, pgPtr + matchPosition,
-                                                            matchingLength, currentMismatchesLimit);
-            if (mismatchesCount < readMismatchesCount[matchReadIndex]) {
-                if (readMismatchesCount[matchReadIndex] == NOT_MATCHED_COUNT)
-                    matchedReadsCount++;
-                 else
-                    betterMatchCount++;
-                matchedCountPerMismatches[readMismatchesCount[matchReadIndex]]--;
-                matchedCountPerMismatches[mismatchesCount]++;
-                readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                readMatchRC[matchReadIndex] = revCompMode;
-                readMismatchesCount[matchReadIndex] = mismatchesCount;
-            } else
-                falseMatchCount++;
-
-/*            if (mismatchesCount < UINT8_MAX && i++ < 2) {
-                cout << "Matched: " << matchReadIndex << " (" << matchPatternIndex << "); "
-                     << matchPosition << "; " << (int) mismatchesCount << "; " << (revCompMode?"pair strand (RC)":"") << endl;
-                cout << matchedRead << endl;
-                const string pgPart(txt + matchPosition, matchingLength);
-                cout << pgPart << endl;
-            }*/
+        hashMatcher->buildIndex();
+        const uint8_t partsCount = targetMismatches + 1;
+        initConcurrentMatching((pgLength + 1) * partsCount);
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:falseMatchCount) num_threads(numberOfThreads)
+        for(int64_t s = 0; s < pgSegmentsCount(); s++) {
+            uint64_t segBegin, segTxtLength;
+            getPgSegment(s, partLength, segBegin, segTxtLength);
+            DefaultConstantLengthPatternsOnTextHashMatcher::Iterator hashIter(*hashMatcher, pgPtr + segBegin, segTxtLength);
+            while (hashIter.moveNext()) {
+                const uint32_t matchPatternIndex = hashIter.getHashMatchPatternIndex();
+                uint32_t matchReadIndex = matchPatternIndex / partsCount;
+                const uint64_t txtPos = segBegin + hashIter.getHashMatchTextPosition();
+                const uint_read_len_max positionShift = (matchPatternIndex % partsCount) * partLength;
+                if (positionShift > txtPos)
+                    continue;
+                const uint64_t matchPosition = txtPos - positionShift;
+                if (matchPosition + readLength > pgLength)
+                    continue;
+                if (readMatchPos[matchReadIndex] == (revCompMode?pgLength-(matchPosition+matchingLength):matchPosition))
+                    continue;
+                matchCandidate(matchReadIndex, pgPtr + matchPosition, txtPos * partsCount + matchPatternIndex % partsCount + 1,
+                        falseMatchCount);
+            }
         }
+        finalizeConcurrentMatching(revCompMode, partLength);
         this->printApproxMatchingStats();
     }
 
@@ -356,47 +417,31 @@ namespace PgTools {
     void InterleavedReadsApproxMatcher::executeMatching(bool revCompMode) {
         time_checkpoint();
         cout << "Matching" << (revCompMode?" in Pg reverse":"") << "...\n" << endl;
-        hashMatcher->iterateOver(pgPtr, pgLength);
-        while (hashMatcher->moveNext()) {
-            const uint32_t matchPatternIndex = hashMatcher->getHashMatchPatternIndex();
-            uint32_t matchReadIndex = matchPatternIndex / (targetMismatches + 1);
-            if (readMismatchesCount[matchReadIndex] <= minMismatches)
-                continue;
-            uint64_t matchPosition = hashMatcher->getHashMatchTextPosition();
-            const uint8_t positionShift = matchPatternIndex % (targetMismatches + 1);
-            if (positionShift > matchPosition)
-                continue;
-            matchPosition -= positionShift;
-            if (matchPosition + readLength > pgLength)
-                continue;
-            if (readMatchPos[matchReadIndex] == (revCompMode?pgLength-(matchPosition+matchingLength):matchPosition))
-                continue;
-            uint8_t currentMatchesLimit = readMismatchesCount[matchReadIndex]==NOT_MATCHED_COUNT?maxMismatches
-                    :(readMismatchesCount[matchReadIndex] - 1);
-            const uint8_t mismatchesCount = readsSet->countMismatchesVsPattern(matchReadIndex, pgPtr + matchPosition,
-                    matchingLength, currentMatchesLimit);
-            if (mismatchesCount < readMismatchesCount[matchReadIndex]) {
-                if (readMismatchesCount[matchReadIndex] == NOT_MATCHED_COUNT)
-                    matchedReadsCount++;
-                else
-                    betterMatchCount++;
-                matchedCountPerMismatches[readMismatchesCount[matchReadIndex]]--;
-                matchedCountPerMismatches[mismatchesCount]++;
-                readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                readMatchRC[matchReadIndex] = revCompMode;
-                readMismatchesCount[matchReadIndex] = mismatchesCount;
-            } else
-                falseMatchCount++;
-
-            //if (mismatchesCount < UINT8_MAX && i++ < 2) {
-/*            if (mismatchesCount < UINT8_MAX && mismatchesCount > 8) {
-                cout << "Matched: " << matchReadIndex << " (" << matchPatternIndex << "); "
-                     << matchPosition << "; " << (int) mismatchesCount << "; " << (revCompMode?"pair strand (RC)":"") << endl;
-                cout << matchedRead << endl;
-                const string pgPart(txt + matchPosition, matchingLength);
-                cout << pgPart << endl;
-            }*/
+        hashMatcher->buildIndex();
+        const uint8_t partsCount = targetMismatches + 1;
+        initConcurrentMatching((pgLength + 1) * partsCount);
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:falseMatchCount) num_threads(numberOfThreads)
+        for(int64_t s = 0; s < pgSegmentsCount(); s++) {
+            uint64_t segBegin, segTxtLength;
+            getPgSegment(s, partLength * partsCount, segBegin, segTxtLength);
+            InterleavedConstantLengthPatternsOnTextHashMatcher::Iterator hashIter(*hashMatcher, pgPtr + segBegin, segTxtLength);
+            while (hashIter.moveNext()) {
+                const uint32_t matchPatternIndex = hashIter.getHashMatchPatternIndex();
+                uint32_t matchReadIndex = matchPatternIndex / partsCount;
+                const uint64_t txtPos = segBegin + hashIter.getHashMatchTextPosition();
+                const uint_read_len_max positionShift = matchPatternIndex % partsCount;
+                if (positionShift > txtPos)
+                    continue;
+                const uint64_t matchPosition = txtPos - positionShift;
+                if (matchPosition + readLength > pgLength)
+                    continue;
+                if (readMatchPos[matchReadIndex] == (revCompMode?pgLength-(matchPosition+matchingLength):matchPosition))
+                    continue;
+                matchCandidate(matchReadIndex, pgPtr + matchPosition, txtPos * partsCount + matchPatternIndex % partsCount + 1,
+                        falseMatchCount);
+            }
         }
+        finalizeConcurrentMatching(revCompMode, 1);
         this->printApproxMatchingStats();
     }
 
@@ -415,33 +460,82 @@ namespace PgTools {
         cout << "Feeding " << (revCompMode?"rc of ":"") << "pseudogenome sequence... " << endl;
         CopMEMMatcher* copMEMMatcher = new CopMEMMatcher(pgPtr, pgLength, partLength);
         *logout << "... checkpoint " << time_millis() << " msec. " << endl;
-        #pragma omp parallel for reduction(+:matchedReadsCount) reduction(+:betterMatchCount) \
-                                reduction(+:falseMatchCount) reduction(+:matchedCountPerMismatches[0:NOT_MATCHED_COUNT+1])
-        for(uint_reads_cnt_max matchReadIndex = 0; matchReadIndex < readsCount; matchReadIndex++) {
-            char_pg currentReadPtr[UINT8_MAX];
-            if (readMismatchesCount[matchReadIndex] <= minMismatches)
-                continue;
-            readsSet->getRead(matchReadIndex, currentReadPtr);
-            uint8_t mismatchesCount = readMismatchesCount[matchReadIndex];
-            uint64_t matchPosition = copMEMMatcher->approxMatchPattern(currentReadPtr, matchingLength,
-                                                                       maxMismatches, minMismatches, mismatchesCount,
-                                                                       betterMatchCount, falseMatchCount);
-            if (matchPosition == UINT64_MAX)
-                continue;
-            if (mismatchesCount < readMismatchesCount[matchReadIndex]) {
-                if (readMismatchesCount[matchReadIndex] == NOT_MATCHED_COUNT)
-                    matchedReadsCount++;
-                matchedCountPerMismatches[readMismatchesCount[matchReadIndex]]--;
-                matchedCountPerMismatches[mismatchesCount]++;
-                readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                readMatchRC[matchReadIndex] = revCompMode;
-                readMismatchesCount[matchReadIndex] = mismatchesCount;
-            }
-        }
+        matchReads(copMEMMatcher, revCompMode, false);
         delete(copMEMMatcher);
         printApproxMatchingStats();
     }
 
+    void CopMEMReadsApproxMatcher::executeMatchingOfBothStrands() {
+        time_checkpoint();
+        cout << "Feeding pseudogenome sequence... " << endl;
+        CopMEMMatcher* copMEMMatcher = new CopMEMMatcher(pgPtr, pgLength, partLength);
+        *logout << "... checkpoint " << time_millis() << " msec. " << endl;
+        matchReads(copMEMMatcher, false, revComplPg);
+        delete(copMEMMatcher);
+        printApproxMatchingStats();
+    }
+
+    void CopMEMReadsApproxMatcher::matchReads(CopMEMMatcher* copMEMMatcher, bool revCompMode, bool revComplReadsMode) {
+        const int64_t blocksCount = (readsCount + APPROX_MATCH_PATTERNS_BLOCK - 1) / APPROX_MATCH_PATTERNS_BLOCK;
+        #pragma omp parallel reduction(+:matchedReadsCount) reduction(+:betterMatchCount) \
+                                reduction(+:falseMatchCount) reduction(+:matchedCountPerMismatches[0:NOT_MATCHED_COUNT+1]) \
+                                num_threads(numberOfThreads)
+        {
+            vector<char_pg> blockReadsVector(APPROX_MATCH_PATTERNS_BLOCK * matchingLength);
+            char_pg* blockReads = blockReadsVector.data();
+            ApproxMatchBuffers matchBuffers;
+            // blocks are aligned to words of readMatchRC bitmap
+            #pragma omp for schedule(dynamic, 16)
+            for(int64_t b = 0; b < blocksCount; b++) {
+                uint_reads_cnt_max blockIdxs[APPROX_MATCH_PATTERNS_BLOCK];
+                uint8_t mismatchesCounts[APPROX_MATCH_PATTERNS_BLOCK];
+                uint64_t matchPositions[APPROX_MATCH_PATTERNS_BLOCK];
+                char_pg currentReadPtr[UINT16_MAX];
+                size_t blockCount = 0;
+                const uint_reads_cnt_max blockEnd = (b + 1) * APPROX_MATCH_PATTERNS_BLOCK < readsCount ?
+                        (b + 1) * APPROX_MATCH_PATTERNS_BLOCK : readsCount;
+                for(uint_reads_cnt_max i = b * APPROX_MATCH_PATTERNS_BLOCK; i < blockEnd; i++) {
+                    if (readMismatchesCount[i] <= minMismatches)
+                        continue;
+                    readsSet->getRead(i, currentReadPtr);
+                    memcpy(blockReads + blockCount * matchingLength, currentReadPtr, matchingLength);
+                    blockIdxs[blockCount++] = i;
+                }
+                // reverse complement of a read matched to Pg corresponds to the read matched to reverse complement of Pg
+                for(bool revComplRead = false; ; revComplRead = true) {
+                    for(size_t k = 0; k < blockCount; k++)
+                        mismatchesCounts[k] = readMismatchesCount[blockIdxs[k]];
+                    copMEMMatcher->approxMatchPatterns(blockReads, blockCount, matchingLength, maxMismatches, minMismatches,
+                            mismatchesCounts, matchPositions, betterMatchCount, falseMatchCount, matchBuffers,
+                            revComplRead);
+                    size_t leftCount = 0;
+                    for(size_t k = 0; k < blockCount; k++) {
+                        const uint_reads_cnt_max matchReadIndex = blockIdxs[k];
+                        const uint8_t mismatchesCount = mismatchesCounts[k];
+                        if (matchPositions[k] != UINT64_MAX && mismatchesCount < readMismatchesCount[matchReadIndex]) {
+                            if (readMismatchesCount[matchReadIndex] == NOT_MATCHED_COUNT)
+                                matchedReadsCount++;
+                            matchedCountPerMismatches[readMismatchesCount[matchReadIndex]]--;
+                            matchedCountPerMismatches[mismatchesCount]++;
+                            readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPositions[k]+matchingLength):matchPositions[k];
+                            readMatchRC[matchReadIndex] = revCompMode != revComplRead;
+                            readMismatchesCount[matchReadIndex] = mismatchesCount;
+                        }
+                        if (revComplRead || !revComplReadsMode || readMismatchesCount[matchReadIndex] <= minMismatches)
+                            continue;
+                        if (leftCount != k)
+                            memcpy(blockReads + leftCount * matchingLength, blockReads + k * matchingLength, matchingLength);
+                        PgSAHelpers::reverseComplementInPlace(blockReads + leftCount * matchingLength, matchingLength);
+                        blockIdxs[leftCount++] = matchReadIndex;
+                    }
+                    if (revComplRead || !revComplReadsMode || leftCount == 0)
+                        break;
+                    blockCount = leftCount;
+                }
+            }
+        }
+    }
+
     const string DefaultReadsMatcher::OFFSETS_SUFFIX = "_matched_offsets.txt";
     const string DefaultReadsMatcher::DUMP_SUFFIX = "_matches_info.txt";
     const string DefaultReadsMatcher::MISSED_READS_SUFFIX = "_missed.txt";
@@ -504,7 +598,7 @@ namespace PgTools {
             offsetsDest << "Matched " << mismatchedReadsCount[i] << " reads with " << (int) i << " mismatches." << endl;
 
         offsetsDest << endl << "Mismatches per reads position:" << endl;
-        for (uint8_t i = 0; i < readLength; i++)
+        for (uint_read_len_max i = 0; i < readLength; i++)
             offsetsDest << (int) i << ":\t" << mismatchesPerReadPositionCount[i] << endl;
 
         cout << endl << "... writing info dump files completed in " << time_millis() << " msec. " << endl;
@@ -555,14 +649,19 @@ namespace PgTools {
                                                      const string &outPgPrefix, IndexesMapping *orgIndexesMapping,
                                                      bool pairFileMode, bool revComplPairFile) {
         time_checkpoint();
-        vector<uint_reads_cnt_max> idxs(matchedReadsCount);
+        ReadsIndexValues idxs(readsCount);
+        idxs.resize(matchedReadsCount);
         uint64_t counter = 0;
         for(uint_reads_cnt_max i = 0; i < readsCount; i++)
             if (readMatchPos[i] != NOT_MATCHED_POSITION)
-                idxs[counter++] = i;
+                idxs.set(counter++, i);
 
-        __gnu_parallel::sort(idxs.begin(), idxs.end(), [this](const uint_reads_cnt_max& idx1, const uint_reads_cnt_max& idx2) -> bool
-        { return readMatchPos[idx1] < readMatchPos[idx2]; });
+        auto matchPosOrder = [this](const uint_reads_cnt_max idx1, const uint_reads_cnt_max idx2) -> bool
+        { return readMatchPos[idx1] < readMatchPos[idx2]; };
+        if (idxs.isMaxMode())
+            __gnu_parallel::sort(idxs.maxValues.begin(), idxs.maxValues.end(), matchPosOrder);
+        else
+            __gnu_parallel::sort(idxs.stdValues.begin(), idxs.stdValues.end(), matchPosOrder);
 
         initEntryUpdating();
         SeparatedPseudoGenomeOutputBuilder* builder = this->createSeparatedPseudoGenomeOutputBuilder(sPg);
@@ -591,11 +690,11 @@ namespace PgTools {
                                                            bool revComplPairFile) {
         time_checkpoint();
 
-        uint_reads_cnt_std readsTotalCount = orgIndexesMapping->getReadsTotalCount();
+        uint_reads_cnt_max readsTotalCount = orgIndexesMapping->getReadsTotalCount();
         vector<uint_pg_len_max> orgIdx2pgPos(readsTotalCount, -1);
         ExtendedReadsListWithConstantAccessOption *const pgRl = sPg->getReadsList();
         uint_pg_len_max pos = 0;
-        for(uint_reads_cnt_std i = 0; i < pgRl->readsCount; i++) {
+        for(uint_reads_cnt_max i = 0; i < pgRl->readsCount; i++) {
             pos += pgRl->off[i];
             orgIdx2pgPos[pgRl->orgIdx[i]] = pos;
         }
@@ -605,7 +704,7 @@ namespace PgTools {
         SeparatedPseudoGenomeOutputBuilder* builder = this->createSeparatedPseudoGenomeOutputBuilder(sPg);
         uint_reads_cnt_max nI_start = readsCount;
         int64_t curOrgIdx = 0;
-        for(uint_reads_cnt_std i = 0; i < readsCount; i++) {
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
             const uint_reads_cnt_max oIdx = orgIndexesMapping->getReadOriginalIndex(i);
             if (curOrgIdx > oIdx) {
                 nI_start = i;
@@ -16,9 +16,6 @@ namespace PgTools {
 
     static const int NOT_MATCHED_COUNT = UINT8_MAX;
 
-    uint8_t
-    countMismatches(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches = NOT_MATCHED_COUNT - 1);
-
     class AbstractReadsApproxMatcher;
 
     class DefaultReadsMatcher {
@@ -42,8 +39,15 @@ namespace PgTools {
         uint64_t betterMatchCount = 0;
         uint64_t falseMatchCount = 0;
 
+        // Pg is scanned concurrently in segments (overlapping by patternSpan - 1 symbols)
+        static const int64_t PG_SEGMENTS_PER_THREAD = 8;
+        int64_t pgSegmentsCount() const;
+        void getPgSegment(int64_t s, uint32_t patternSpan, uint64_t &segBegin, uint64_t &segTxtLength) const;
+
         virtual void initMatching();
         virtual void executeMatching(bool revCompMode = false) = 0;
+        // by default reverse complement of Pg is matched in the second pass
+        virtual void executeMatchingOfBothStrands();
         virtual void writeMatchesInfo(ofstream &offsetsDest, ofstream &missedPatternsDest, ofstream &suffixesDest) = 0;
 
         virtual SeparatedPseudoGenomeOutputBuilder *createSeparatedPseudoGenomeOutputBuilder(
@@ -115,6 +119,16 @@ namespace PgTools {
         vector<uint8_t> readMismatchesCount;
         uint_reads_cnt_max matchedCountPerMismatches[NOT_MATCHED_COUNT + 1] = {};
 
+        // best candidates of reads during concurrent scanning of Pg are min-updated lock-free as keys
+        // (mismatches rank, candidate order, mismatches) - results are the same as of a sequential scan
+        vector<uint64_t> readMatchKey;
+        inline uint64_t matchKey(uint8_t mismatchesCount, uint64_t candidateOrder);
+        void initConcurrentMatching(uint64_t candidatesOrderLimit);
+        // candidate order is (text position * (targetMismatches + 1) + part index + 1)
+        inline void matchCandidate(uint_reads_cnt_max matchReadIndex, const char *pgPart, uint64_t candidateOrder,
+                uint64_t &falseMatchCount);
+        void finalizeConcurrentMatching(bool revCompMode, uint_read_len_max partPositionShift);
+
         void writeMatchesInfo(ofstream &offsetsDest, ofstream &missedPatternsDest, ofstream &dumpDest);
         void printApproxMatchingStats();
 
@@ -183,12 +197,15 @@ namespace PgTools {
 
     class CopMEMReadsApproxMatcher: public AbstractReadsApproxMatcher {
     private:
+        void matchReads(CopMEMMatcher* copMEMMatcher, bool revCompMode, bool revComplReadsMode);
 
     protected:
         uint_read_len_max partLength;
 
         void initMatching();
         void executeMatching(bool revCompMode = false);
+        // reads and their reverse complements are matched against a single index of Pg
+        void executeMatchingOfBothStrands() override;
 
         void initMatchingContinuation(DefaultReadsMatcher *pMatcher) override;
 
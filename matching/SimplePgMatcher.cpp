@@ -218,23 +218,23 @@ namespace PgTools {
         *logout << "Good sequence mapping - offsets... ";
         double estimated_pg_offset_ratio = simpleUintCompressionEstimate(refSequenceLength, isPgLengthStd ? UINT32_MAX : UINT64_MAX);
         const int pgrc_pg_offset_dataperiodcode = isPgLengthStd ? PGRC_DATAPERIODCODE_32_t : PGRC_DATAPERIODCODE_64_t;
-        writeCompressed(pgrcOut, hqPgMapOff.data(), hqPgMapOff.size(), LZMA_CODER, coder_level,
+        writeCompressed(pgrcOut, hqPgMapOff.data(), hqPgMapOff.size(), selectLzmaCoder(hqPgMapOff.size()), coder_level,
                         pgrc_pg_offset_dataperiodcode, estimated_pg_offset_ratio);
         *logout << "lengths... ";
-        writeCompressed(pgrcOut, hqPgMapLen.data(), hqPgMapLen.size(), LZMA_CODER, coder_level,
+        writeCompressed(pgrcOut, hqPgMapLen.data(), hqPgMapLen.size(), selectLzmaCoder(hqPgMapLen.size()), coder_level,
                         PGRC_DATAPERIODCODE_8_t);
         *logout << "Bad sequence mapping - offsets... ";
-        writeCompressed(pgrcOut, lqPgMapOff.data(), lqPgMapOff.size(), LZMA_CODER, coder_level,
+        writeCompressed(pgrcOut, lqPgMapOff.data(), lqPgMapOff.size(), selectLzmaCoder(lqPgMapOff.size()), coder_level,
                         pgrc_pg_offset_dataperiodcode, estimated_pg_offset_ratio);
         *logout << "lengths... ";
-        writeCompressed(pgrcOut, lqPgMapLen.data(), lqPgMapLen.size(), LZMA_CODER, coder_level,
+        writeCompressed(pgrcOut, lqPgMapLen.data(), lqPgMapLen.size(), selectLzmaCoder(lqPgMapLen.size()), coder_level,
                         PGRC_DATAPERIODCODE_8_t);
         if (separateNReads) {
             *logout << "N sequence mapping - offsets... ";
-            writeCompressed(pgrcOut, nPgMapOff.data(), nPgMapOff.size(), LZMA_CODER, coder_level,
+            writeCompressed(pgrcOut, nPgMapOff.data(), nPgMapOff.size(), selectLzmaCoder(nPgMapOff.size()), coder_level,
                             pgrc_pg_offset_dataperiodcode, estimated_pg_offset_ratio);
             *logout << "lengths... ";
-            writeCompressed(pgrcOut, nPgMapLen.data(), nPgMapLen.size(), LZMA_CODER, coder_level,
+            writeCompressed(pgrcOut, nPgMapLen.data(), nPgMapLen.size(), selectLzmaCoder(nPgMapLen.size()), coder_level,
                             PGRC_DATAPERIODCODE_8_t);
         }
     }
@@ -275,7 +275,7 @@ namespace PgTools {
         pgSequence.clear();
         pgSequence.shrink_to_fit();
         *logout << "Joined var-len encoded mapped sequences (good&bad" << (noNPgSequence ? "" : "&N") << ")... ";
-        writeCompressed(pgrcOut, compSeq, compLen, LZMA_CODER, coder_level, PGRC_DATAPERIODCODE_8_t,
+        writeCompressed(pgrcOut, compSeq, compLen, selectLzmaCoder(compLen), coder_level, PGRC_DATAPERIODCODE_8_t,
                         COMPRESSION_ESTIMATION_VAR_LEN_DNA);
         delete[] compSeq;
     }
@@ -283,43 +283,51 @@ namespace PgTools {
     void SimplePgMatcher::restoreMatchedPgs(istream &pgrcIn, uint_pg_len_max orgHqPgLen, string &hqPgSequence, string &lqPgSequence,
                                             string &nPgSequence) {
         uint_pg_len_max hqPgMappedLen, lqPgMappedLen, nPgMappedLen;
-        string pgMapOff, pgMapLen;
-        istringstream pgMapOffSrc, pgMapLenSrc;
+        string hqPgMapOff, hqPgMapLen, lqPgMapOff, lqPgMapLen, nPgMapOff, nPgMapLen;
         PgSAHelpers::readValue<uint_pg_len_max>(pgrcIn, hqPgMappedLen, false);
         PgSAHelpers::readValue<uint_pg_len_max>(pgrcIn, lqPgMappedLen, false);
         PgSAHelpers::readValue<uint_pg_len_max>(pgrcIn, nPgMappedLen, false);
         string comboPgMapped;
-        readCompressed(pgrcIn, comboPgMapped);
+        ParallelStreamsDecompressor psd;
+        psd.addStream(pgrcIn, comboPgMapped);
+        psd.addStream(pgrcIn, hqPgMapOff);
+        psd.addStream(pgrcIn, hqPgMapLen);
+        psd.addStream(pgrcIn, lqPgMapOff);
+        psd.addStream(pgrcIn, lqPgMapLen);
+        if (nPgMappedLen) {
+            psd.addStream(pgrcIn, nPgMapOff);
+            psd.addStream(pgrcIn, nPgMapLen);
+        }
+        psd.decompress();
         string nPgMapped(comboPgMapped, hqPgMappedLen + lqPgMappedLen);
         comboPgMapped.resize(hqPgMappedLen + lqPgMappedLen);
+        string lqPgMapped(comboPgMapped, hqPgMappedLen);
+        comboPgMapped.resize(hqPgMappedLen);
+        comboPgMapped.shrink_to_fit();
         {
-            string lqPgMapped(comboPgMapped, hqPgMappedLen);
-            comboPgMapped.resize(hqPgMappedLen);
-            comboPgMapped.shrink_to_fit();
+            string hqPgMapped = std::move(comboPgMapped);
+            istringstream pgMapOffSrc(hqPgMapOff), pgMapLenSrc(hqPgMapLen);
+            hqPgSequence.clear();
+            hqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, hqPgMapped, pgMapOffSrc, pgMapLenSrc,
+                                                             true, false, true);
+        }
+        // LQ and N Pgs are restored independently (based on HQ Pg)
+        #pragma omp parallel sections num_threads(2)
+        {
+            #pragma omp section
             {
-                string hqPgMapped = std::move(comboPgMapped);
-                readCompressed(pgrcIn, pgMapOff);
-                readCompressed(pgrcIn, pgMapLen);
-                pgMapOffSrc.str(pgMapOff);
-                pgMapLenSrc.str(pgMapLen);
-                hqPgSequence.clear();
-                hqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, hqPgMapped, pgMapOffSrc, pgMapLenSrc,
-                                                                 true, false, true);
+                istringstream pgMapOffSrc(lqPgMapOff), pgMapLenSrc(lqPgMapLen);
+                lqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, lqPgMapped, pgMapOffSrc,
+                                                                 pgMapLenSrc, true, false);
+            }
+            #pragma omp section
+            {
+                if (nPgMappedLen) {
+                    istringstream pgMapOffSrc(nPgMapOff), pgMapLenSrc(nPgMapLen);
+                    nPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, nPgMapped, pgMapOffSrc,
+                                                                    pgMapLenSrc, true, false);
+                }
             }
-            readCompressed(pgrcIn, pgMapOff);
-            readCompressed(pgrcIn, pgMapLen);
-            pgMapOffSrc.str(pgMapOff);
-            pgMapLenSrc.str(pgMapLen);
-            lqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, lqPgMapped, pgMapOffSrc, pgMapLenSrc,
-                                                             true, false);
-        }
-        if (nPgMappedLen) {
-            readCompressed(pgrcIn, pgMapOff);
-            readCompressed(pgrcIn, pgMapLen);
-            pgMapOffSrc.str(pgMapOff);
-            pgMapLenSrc.str(pgMapLen);
-            nPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, nPgMapped, pgMapOffSrc, pgMapLenSrc,
-                                                            true, false);
         }
     }
 
@@ -397,8 +397,8 @@ void CopMEMMatcher::processExactMatchQueryTight(HashBuffer<MyUINT1, MyUINT2> buf
                         break;
                     }
 
-                    memcpy(&l1, curr1 - LK2, sizeof(std::uint32_t));
-                    memcpy(&r1, curr1 + K_PLUS_LK24, sizeof(std::uint32_t));
+                    if (curr1 - LK2 >= start1) memcpy(&l1, curr1 - LK2, sizeof(std::uint32_t));
+                    if (curr1 + K_PLUS_LK24 + sizeof(std::uint32_t) <= end1) memcpy(&r1, curr1 + K_PLUS_LK24, sizeof(std::uint32_t));
 
                     if (r1 == r2 || l1 == l2) {
                         const char *p1 = curr1 + K - 1;
@@ -452,8 +452,8 @@ void CopMEMMatcher::processExactMatchQueryTight(HashBuffer<MyUINT1, MyUINT2> buf
                 break;
             }
 
-            memcpy(&l1, curr1 - LK2, sizeof(std::uint32_t));
-            memcpy(&r1, curr1 + K_PLUS_LK24, sizeof(std::uint32_t));
+            if (curr1 - LK2 >= start1) memcpy(&l1, curr1 - LK2, sizeof(std::uint32_t));
+            if (curr1 + K_PLUS_LK24 + sizeof(std::uint32_t) <= end1) memcpy(&r1, curr1 + K_PLUS_LK24, sizeof(std::uint32_t));
 
             if (r1 == r2 || l1 == l2) {
                 const char* p1 = curr1 + K - 1;
@@ -480,91 +480,118 @@ void CopMEMMatcher::processExactMatchQueryTight(HashBuffer<MyUINT1, MyUINT2> buf
 }
 
 template<typename MyUINT1, typename MyUINT2>
-uint64_t CopMEMMatcher::processApproxMatchQueryTight(HashBuffer<MyUINT1, MyUINT2> buffer, const char *start2,
-                                                     const uint_read_len_max N2, uint8_t maxMismatches,
-                                                     uint8_t minMismatches, uint8_t &mismatchesCount,
-                                                     uint64_t& betterMatchCount, uint64_t& falseMatchCount) {
-    if (mismatchesCount < maxMismatches)
-        maxMismatches = mismatchesCount - 1;
+void CopMEMMatcher::processApproxMatchQueriesTight(HashBuffer<MyUINT1, MyUINT2> buffer, const char *patterns,
+                                                   const size_t patternsCount, const uint_read_len_max N2,
+                                                   const uint8_t maxMismatches, uint8_t minMismatches,
+                                                   uint8_t *mismatchesCounts, uint64_t *matchPositions,
+                                                   uint64_t& betterMatchCount, uint64_t& falseMatchCount,
+                                                   ApproxMatchBuffers &buffers, bool revComplPatterns) {
     MyUINT1* sampledPositions = buffer.first;
     MyUINT2* cumm = buffer.second;
 
-    MyUINT2 posArray[2];
-
-    const uint_read_len_max N2trim8 = (N2 / sizeof(uint64_t)) * sizeof(uint64_t);
-    uint_read_len_max k2positionsCount = (N2 + 1 - K) / k2;
-
-    uint64_t falseMatchCountLimit = k2positionsCount * AVERAGE_HASH_COLLISIONS_PER_POSITION_LIMIT;
-    uint64_t currentFalseMatchCount = 0;
-    uint64_t matchPosition = NOT_MATCHED_POSITION;
-    size_t i1 = 0;
-    const char* curr2 = start2 + i1;
-    for (; i1 + K < N2 + 1; i1 += k2) {
-        memcpy(posArray, cumm + hashFunc(curr2), sizeof(MyUINT2) * 2);
-
-        if (posArray[0] == posArray[1]) {
-            curr2 += k2;
-            continue;
-        }
-        if (falseMatchCountLimit < currentFalseMatchCount) {
-            MyUINT2 tmp = posArray[0] + UNLIMITED_NUMBER_OF_HASH_COLLISIONS_PER_POSITION;
-            if (posArray[1] > tmp)
-                posArray[1] = tmp;
+    const size_t seedsCount = N2 + 1 > (size_t) K ? (N2 - K) / k2 + 1 : 0;
+    const uint64_t falseMatchCountLimit = ((N2 + 1 - K) / k2) * AVERAGE_HASH_COLLISIONS_PER_POSITION_LIMIT;
+    vector<uint32_t> &hArray = buffers.hArray;
+    vector<MyUINT2> &posArray = buffers.getPosArray<MyUINT2>();
+    if (hArray.size() < patternsCount * seedsCount)
+        hArray.resize(patternsCount * seedsCount);
+    if (posArray.size() < patternsCount * seedsCount * 2)
+        posArray.resize(patternsCount * seedsCount * 2);
+
+    // reverse complemented patterns are processed as if their counterparts were matched against reverse complemented text
+    // (i.e. starting from the end of pattern and visiting sampled positions in descending order)
+    const int64_t seedStep = revComplPatterns ? -(int64_t) k2 : k2;
+    const int64_t candidateStep = revComplPatterns ? -1 : 1;
+    const char* firstSeed = patterns + (revComplPatterns ? N2 - K : 0);
+
+    // hashing seeds of the block (with prefetching of buckets)
+    for (size_t p = 0; p < patternsCount; p++) {
+        const char* curr2 = firstSeed + p * N2;
+        uint32_t* hPtr = hArray.data() + p * seedsCount;
+        for (size_t s = 0; s < seedsCount; ++s, curr2 += seedStep) {
+            hPtr[s] = hashFunc(curr2);
+            _prefetch((char*)(cumm + hPtr[s]), 1);
         }
-        for (MyUINT1 j = posArray[0]; j < posArray[1]; ++j) {
-            const uint_read_len_max positionShift = curr2 - start2;
-            if (positionShift > sampledPositions[j])
+    }
+    // loading candidates ranges (with prefetching of the first sampled positions)
+    for (size_t i = 0; i < patternsCount * seedsCount; i++) {
+        memcpy(posArray.data() + i * 2, cumm + hArray[i], sizeof(MyUINT2) * 2);
+        if (posArray[i * 2] != posArray[i * 2 + 1])
+            _prefetch((char*)(sampledPositions + (revComplPatterns ? posArray[i * 2 + 1] - 1 : posArray[i * 2])), 1);
+    }
+    // prefetching Pg windows of the first candidates
+    for (size_t p = 0; p < patternsCount; p++) {
+        const char* curr2 = firstSeed + p * N2;
+        const MyUINT2* pPtr = posArray.data() + p * seedsCount * 2;
+        for (size_t s = 0; s < seedsCount; ++s, curr2 += seedStep) {
+            if (pPtr[s * 2] == pPtr[s * 2 + 1])
                 continue;
-            if (sampledPositions[j] - positionShift + N2 > N)
+            const uint_read_len_max positionShift = curr2 - (patterns + p * N2);
+            const MyUINT1 candidatePos = sampledPositions[revComplPatterns ? pPtr[s * 2 + 1] - 1 : pPtr[s * 2]];
+            if (positionShift > candidatePos || candidatePos - positionShift + N2 > N)
                 continue;
-            const char* curr1 = start1 + sampledPositions[j];
+            _prefetch(start1 + candidatePos - positionShift, 1);
+            _prefetch(start1 + candidatePos - positionShift + N2 - 1, 1);
+        }
+    }
 
-            uint64_t temp1, temp2;
-            uint8_t res = 0;
-            const char* patternPtr = start2;
-            const char* patGuardPtr = start2 + N2trim8;
-            const char* textPtr = curr1 - positionShift;
-            while(res <= maxMismatches && patGuardPtr != patternPtr) {
-                memcpy(&temp1, patternPtr, sizeof(uint64_t));
-                memcpy(&temp2, textPtr, sizeof(uint64_t));
-                uint64_t temp3 = ((temp1 ^ temp2) + 0x7F7F7F7F7F7F7F7F) & 0x8080808080808080;
-                res += __builtin_popcountll(temp3);
-                patternPtr += sizeof(uint64_t);
-                textPtr += sizeof(uint64_t);
-            }
-            if (res > maxMismatches) {
-                currentFalseMatchCount++;
+    // verification
+    for (size_t p = 0; p < patternsCount; p++) {
+        const char* start2 = patterns + p * N2;
+        uint8_t &mismatchesCount = mismatchesCounts[p];
+        uint8_t mismatchesLimit = mismatchesCount < maxMismatches ? mismatchesCount - 1 : maxMismatches;
+        MyUINT2* pPtr = posArray.data() + p * seedsCount * 2;
+
+        uint64_t currentFalseMatchCount = 0;
+        uint64_t &matchPosition = matchPositions[p];
+        matchPosition = NOT_MATCHED_POSITION;
+        const char* curr2 = firstSeed + p * N2;
+        for (size_t s = 0; s < seedsCount; ++s, curr2 += seedStep, pPtr += 2) {
+            if (pPtr[0] == pPtr[1])
                 continue;
-            }
-            while (patternPtr != start2 + N2) {
-                if (*patternPtr++ != *textPtr++) {
-                    if (res++ >= maxMismatches) {
-                        currentFalseMatchCount++;
-                        break;
-                    }
+            if (falseMatchCountLimit < currentFalseMatchCount) {
+                if (revComplPatterns) {
+                    if (pPtr[1] - pPtr[0] > UNLIMITED_NUMBER_OF_HASH_COLLISIONS_PER_POSITION)
+                        pPtr[0] = pPtr[1] - UNLIMITED_NUMBER_OF_HASH_COLLISIONS_PER_POSITION;
+                } else {
+                    MyUINT2 tmp = pPtr[0] + UNLIMITED_NUMBER_OF_HASH_COLLISIONS_PER_POSITION;
+                    if (pPtr[1] > tmp)
+                        pPtr[1] = tmp;
                 }
             }
-            if (res > maxMismatches){
-                currentFalseMatchCount++;
-                continue;
-            }
-            if (mismatchesCount != UINT8_MAX)
-                betterMatchCount++;
-            mismatchesCount = res;
-            matchPosition = curr1 - start1 - positionShift;
-            if (res <= minMismatches) {
-                falseMatchCount += currentFalseMatchCount;
-                return matchPosition;
+            const int64_t jBegin = revComplPatterns ? (int64_t) pPtr[1] - 1 : pPtr[0];
+            const int64_t jEnd = revComplPatterns ? (int64_t) pPtr[0] - 1 : pPtr[1];
+            bool minMismatchesReached = false;
+            for (int64_t j = jBegin; j != jEnd; j += candidateStep) {
+                const uint_read_len_max positionShift = curr2 - start2;
+                if (positionShift > sampledPositions[j])
+                    continue;
+                if (sampledPositions[j] - positionShift + N2 > N)
+                    continue;
+                const char* curr1 = start1 + sampledPositions[j];
+
+                const uint8_t res = PgSAHelpers::countMismatches(start2, curr1 - positionShift, N2, mismatchesLimit);
+                if (res > mismatchesLimit) {
+                    currentFalseMatchCount++;
+                    continue;
+                }
+                if (mismatchesCount != UINT8_MAX)
+                    betterMatchCount++;
+                mismatchesCount = res;
+                matchPosition = curr1 - start1 - positionShift;
+                if (res <= minMismatches) {
+                    minMismatchesReached = true;
+                    break;
+                }
+                mismatchesLimit = res - 1;
             }
-            maxMismatches = res - 1;
+            if (minMismatchesReached)
+                break;
         }
-        curr2 += k2;
+        falseMatchCount += currentFalseMatchCount;
     }
-    falseMatchCount += currentFalseMatchCount;
-    return matchPosition;
 }
 
-
 using namespace std;
 
 CopMEMMatcher::CopMEMMatcher(const char *srcText, const size_t srcLength, const uint32_t targetMatchLength, uint32_t minMatchLength)
@@ -620,21 +647,27 @@ CopMEMMatcher::matchTexts(vector <TextMatch> &resMatches, const string &destText
     }
 }
 
-uint64_t CopMEMMatcher::approxMatchPattern(const char *pattern, const uint_read_len_max length, uint8_t maxMismatches, uint8_t minMismatches,
-        uint8_t &mismatchesCount, uint64_t& multiMatchCount, uint64_t& falseMatchCount) {
+void CopMEMMatcher::approxMatchPatterns(const char *patterns, const size_t patternsCount,
+                                        const uint_read_len_max length, uint8_t maxMismatches, uint8_t minMismatches,
+                                        uint8_t *mismatchesCounts, uint64_t *matchPositions,
+                                        uint64_t& multiMatchCount, uint64_t& falseMatchCount,
+                                        ApproxMatchBuffers &buffers, bool revComplPatterns) {
     if (bigRef == 2) {
-        return processApproxMatchQueryTight<std::uint64_t, std::uint64_t>(buffer2, pattern, length, maxMismatches,
-                                                                          minMismatches, mismatchesCount,
-                                                                          multiMatchCount, falseMatchCount);
+        processApproxMatchQueriesTight<std::uint64_t, std::uint64_t>(buffer2, patterns, patternsCount, length,
+                                                                     maxMismatches, minMismatches, mismatchesCounts,
+                                                                     matchPositions, multiMatchCount, falseMatchCount,
+                                                                     buffers, revComplPatterns);
     } else if (bigRef == 1) {
-        return processApproxMatchQueryTight<std::uint64_t, std::uint32_t>(buffer1, pattern, length, maxMismatches,
-                                                                          minMismatches, mismatchesCount,
-                                                                          multiMatchCount, falseMatchCount);
+        processApproxMatchQueriesTight<std::uint64_t, std::uint32_t>(buffer1, patterns, patternsCount, length,
+                                                                     maxMismatches, minMismatches, mismatchesCounts,
+                                                                     matchPositions, multiMatchCount, falseMatchCount,
+                                                                     buffers, revComplPatterns);
     }
     else {
-        return processApproxMatchQueryTight<std::uint32_t, std::uint32_t>(buffer0, pattern, length, maxMismatches,
-                                                                          minMismatches, mismatchesCount,
-                                                                          multiMatchCount, falseMatchCount);
+        processApproxMatchQueriesTight<std::uint32_t, std::uint32_t>(buffer0, patterns, patternsCount, length,
+                                                                     maxMismatches, minMismatches, mismatchesCounts,
+                                                                     matchPositions, multiMatchCount, falseMatchCount,
+                                                                     buffers, revComplPatterns);
     }
 }
 
@@ -11,6 +11,7 @@ enum reverseMode { no, yes, both };
 static const int HASH_COLLISIONS_PER_POSITION_LIMIT = 12;
 static const int AVERAGE_HASH_COLLISIONS_PER_POSITION_LIMIT = 1;
 static const int UNLIMITED_NUMBER_OF_HASH_COLLISIONS_PER_POSITION = 4;
+static const int APPROX_MATCH_PATTERNS_BLOCK = 64;
 static const int HASH_SIZE_MIN_ORDER = 24;
 static const int HASH_SIZE_MAX_ORDER = 31;
 typedef std::pair<std::string, size_t> SequenceItem;
@@ -19,6 +20,22 @@ typedef std::vector<SequenceItem> SequenceVector;
 template<class MyUINT1, class MyUINT2>
 using HashBuffer =  std::pair<MyUINT1*, MyUINT2* >;
 
+// scratch buffers of approximate matching (reused by a thread for consecutive blocks of patterns)
+struct ApproxMatchBuffers {
+    vector<std::uint32_t> hArray;
+    vector<std::uint32_t> posArray32;
+    vector<std::uint64_t> posArray64;
+
+    template<typename MyUINT2>
+    vector<MyUINT2> &getPosArray();
+};
+
+template<>
+inline vector<std::uint32_t> &ApproxMatchBuffers::getPosArray<std::uint32_t>() { return posArray32; }
+
+template<>
+inline vector<std::uint64_t> &ApproxMatchBuffers::getPosArray<std::uint64_t>() { return posArray64; }
+
 class CopMEMMatcher: public TextMatcher {
 private:
     const char* start1;
@@ -71,9 +88,11 @@ private:
                                      bool destIsSrc, bool revComplMatching, uint32_t minMatchLength);
 
     template<typename MyUINT1, typename MyUINT2>
-    uint64_t processApproxMatchQueryTight(HashBuffer<MyUINT1, MyUINT2> buffer, const char *pattern, const uint_read_len_max length,
-                                 uint8_t maxMismatches, uint8_t minMismatches, uint8_t &mismatchesCount,
-                                 uint64_t& betterMatchCount, uint64_t& falseMatchCount);
+    void processApproxMatchQueriesTight(HashBuffer<MyUINT1, MyUINT2> buffer, const char *patterns, const size_t patternsCount,
+                                        const uint_read_len_max length, const uint8_t maxMismatches, uint8_t minMismatches,
+                                        uint8_t *mismatchesCounts, uint64_t *matchPositions,
+                                        uint64_t& betterMatchCount, uint64_t& falseMatchCount,
+                                        ApproxMatchBuffers &buffers, bool revComplPatterns);
 
 public:
     CopMEMMatcher(const char *srcText, const size_t srcLength, const uint32_t targetMatchLength, uint32_t minMatchLength = UINT32_MAX);
@@ -83,8 +102,12 @@ public:
     void matchTexts(vector<TextMatch> &resMatches, const string &destText, bool destIsSrc, bool revComplMatching,
                     uint32_t minMatchLength) override;
 
-    uint64_t approxMatchPattern(const char *pattern, const uint_read_len_max length, uint8_t maxMismatches, uint8_t minMismatches,
-            uint8_t &mismatchesCount, uint64_t& multiMatchCount, uint64_t& falseMatchCount);
+    // patterns of equal length are stored consecutively (in blocks of up to APPROX_MATCH_PATTERNS_BLOCK); seeds of all
+    // patterns are hashed and prefetched before verification; matchPositions are UINT64_MAX if no better match is found
+    void approxMatchPatterns(const char *patterns, const size_t patternsCount, const uint_read_len_max length,
+                             uint8_t maxMismatches, uint8_t minMismatches, uint8_t *mismatchesCounts, uint64_t *matchPositions,
+                             uint64_t& multiMatchCount, uint64_t& falseMatchCount, ApproxMatchBuffers &buffers,
+                             bool revComplPatterns = false);
 
 };
 
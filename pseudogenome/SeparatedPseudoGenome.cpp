@@ -38,15 +38,17 @@ namespace PgTools {
     }
 
     void SeparatedPseudoGenome::applyIndexesMapping(IndexesMapping *indexesMapping) {
-        for(uint_reads_cnt_std& idx: readsList->orgIdx)
-            idx = indexesMapping->getReadOriginalIndex(idx);
+        ReadsIndexValues &orgIdx = readsList->orgIdx;
+        orgIdx.adjustMode(indexesMapping->getReadsTotalCount());
+        for(uint_reads_cnt_max i = 0; i < orgIdx.size(); i++)
+            orgIdx.set(i, indexesMapping->getReadOriginalIndex(orgIdx[i]));
     }
 
     void SeparatedPseudoGenome::applyRevComplPairFile() {
-        uint_reads_cnt_std readsCount = readsList->orgIdx.size();
+        uint_reads_cnt_max readsCount = readsList->orgIdx.size();
         if (!readsList->isRevCompEnabled())
             readsList->revComp.resize(readsCount, false);
-        for(uint_reads_cnt_std i = 0; i < readsCount; i++)
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++)
             if (readsList->orgIdx[i] % 2)
                 readsList->revComp[i] = !readsList->revComp[i];
     }
@@ -72,11 +74,15 @@ namespace PgTools {
     }
 
     void SeparatedPseudoGenome::getRead_Unsafe(uint_reads_cnt_max idx, char *ptr) {
-        getRead_RawSequence(idx, ptr);
+        getRead_Unsafe(idx, this->readsList->pos[idx], ptr);
+    }
+
+    void SeparatedPseudoGenome::getRead_Unsafe(uint_reads_cnt_max idx, uint_pg_len_max pos, char *ptr) {
+        getRawSequenceOfReadLength(ptr, pos);
         if (this->readsList->revComp[idx])
             PgSAHelpers::reverseComplementInPlace(ptr, this->readsList->readLength);
         for(uint8_t i = 0; i < this->readsList->getMisCount(idx); i++) {
-            const uint8_t misPos = this->readsList->getMisOff(idx, i);
+            const uint_read_len_max misPos = this->readsList->getMisOff(idx, i);
             ptr[misPos] = PgSAHelpers::code2mismatch(ptr[misPos],
                                                this->readsList->getMisSymCode(idx, i));
         }
@@ -88,7 +94,7 @@ namespace PgTools {
             PgSAHelpers::reverseComplementInPlace(ptr, this->readsList->readLength);
         if (this->readsList->areMismatchesEnabled()) {
             for (uint8_t i = 0; i < this->readsList->getMisCount(idx); i++) {
-                const uint8_t misPos = this->readsList->getMisOff(idx, i);
+                const uint_read_len_max misPos = this->readsList->getMisOff(idx, i);
                 ptr[misPos] = PgSAHelpers::code2mismatch(ptr[misPos],
                                                          this->readsList->getMisSymCode(idx, i));
             }
@@ -101,7 +107,7 @@ namespace PgTools {
             PgSAHelpers::reverseComplementInPlace(ptr, this->readsList->readLength);
         uint8_t mismatchesCount = this->readsList->misCnt[nextRlIdx];
         for (uint8_t i = 0; i < mismatchesCount; i++) {
-            const uint8_t misPos = this->readsList->misOff[curMisCumCount];
+            const uint_read_len_max misPos = this->readsList->misOff[curMisCumCount];
             ptr[misPos] = PgSAHelpers::code2mismatch(ptr[misPos],
                                                      this->readsList->misSymCode[curMisCumCount++]);
         }
@@ -135,6 +141,22 @@ namespace PgTools {
         delta = length - overlap;
     }
 
+    void GeneratedSeparatedPseudoGenome::append(uint_read_len_max length, uint_read_len_max overlap,
+                                                uint_reads_cnt_max orgIdx, bool revComp) {
+        if (readsList->revComp.empty())
+            readsList->revComp.reserve(readsList->readsCount);
+        readsList->revComp.push_back(revComp);
+        append(length, overlap, orgIdx);
+    }
+
+    void GeneratedSeparatedPseudoGenome::resizeReadsList(uint_reads_cnt_max readsCount, bool revCompEnabled) {
+        readsList->off.resize(readsCount);
+        readsList->orgIdx.adjustMode(readsCount);
+        readsList->orgIdx.resize(readsCount);
+        if (revCompEnabled)
+            readsList->revComp.resize(readsCount);
+    }
+
     void GeneratedSeparatedPseudoGenome::append(const string &read, uint_read_len_max length, uint_read_len_max overlap,
                                                 uint_reads_cnt_max orgIdx) {
         append(length, overlap, orgIdx);
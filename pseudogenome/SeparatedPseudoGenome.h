@@ -52,6 +52,8 @@ namespace PgTools {
             getRawSequenceOfReadLength(ptr, this->readsList->pos[idx]);
         }
         void getRead_Unsafe(uint_reads_cnt_max idx, char *ptr);
+        // requires only mismatches constant access (i.e. positions can be stored separately)
+        void getRead_Unsafe(uint_reads_cnt_max idx, uint_pg_len_max pos, char *ptr);
         void getRead(uint_reads_cnt_max idx, char *ptr);
 
         // iteration routines
@@ -76,6 +78,9 @@ namespace PgTools {
 
         void append(const string& read, uint_read_len_max length, uint_read_len_max overlap, uint_reads_cnt_max orgIdx);
         void append(uint_read_len_max length, uint_read_len_max overlap, uint_reads_cnt_max orgIdx);
+        void append(uint_read_len_max length, uint_read_len_max overlap, uint_reads_cnt_max orgIdx, bool revComp);
+        // entries of the resized reads list can be set directly (e.g. concurrently for disjoint ranges)
+        void resizeReadsList(uint_reads_cnt_max readsCount, bool revCompEnabled);
 
         void validate();
     };
@@ -1,41 +1,40 @@
 #include "ParallelGreedySwipingPackedOverlapPseudoGenomeGenerator.h"
 #include <cassert>
+#include <omp.h>
 #include "AbstractOverlapPseudoGenomeGenerator.h"
 
 template<typename uint_read_len, typename uint_reads_cnt>
 void AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::removeCyclesAndPrepareComponents() {
+    free(this->headRead);
     this->headRead = (uint_reads_cnt *) calloc(this->readsTotal() + 1, sizeof(uint_reads_cnt));
+    const int64_t readsCount = this->readsTotal();
+    // each read has at most one predecessor
+    #pragma omp parallel for num_threads(numberOfThreads)
+    for(int64_t curIdx = 1; curIdx <= readsCount; curIdx++)
+        if (this->getNextRead(curIdx))
+            this->headRead[this->getNextRead(curIdx)] = curIdx;
+    const vector<uint_reads_cnt> heads = this->collectPathHeads();
+    uint_reads_cnt_max pathsReadsCount = 0;
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:pathsReadsCount) num_threads(numberOfThreads)
+    for(int64_t i = 0; i < (int64_t) heads.size(); i++)
+        pathsReadsCount += this->assignPathHead(heads[i]);
+    // reads unreachable from heads form cycles
     uint_reads_cnt cyclesCount = 0;
     uint_reads_cnt overlapLost = 0;
-    uint_reads_cnt nextIdx;
-    for(uint_reads_cnt curIdx = 1; curIdx <= this->readsTotal(); curIdx++) {
-        if (nextIdx = this->nextRead[curIdx]) {
-            if (this->isHeadOf(curIdx, nextIdx)) {
-                cyclesCount++;
-                uint_read_len minOverlap = this->overlap[curIdx];
-                uint_reads_cnt minOverlapIdx = curIdx;
-                nextIdx = curIdx;
-                while ((nextIdx = this->nextRead[nextIdx]) != curIdx) {
-                    if (minOverlap > this->overlap[nextIdx]) {
-                        uint_read_len minOverlap = this->overlap[nextIdx];
-                        uint_reads_cnt minOverlapIdx = nextIdx;
-                    }
-                }
-                overlapLost += minOverlap;
-                uint_reads_cnt headIdx = this->nextRead[minOverlapIdx];
-                this->nextRead[minOverlapIdx] = 0;
-                this->overlap[minOverlapIdx] = 0;
-                nextIdx = headIdx;
-                this->headRead[headIdx] = 0;
-                while ((nextIdx = this->nextRead[nextIdx]))
-                    this->headRead[nextIdx] = headIdx;
-            } else {
-                if (this->headRead[curIdx] == 0)
-                    this->headRead[nextIdx] = curIdx;
-                else
-                    this->headRead[nextIdx] = this->headRead[curIdx];
-            }
-        }
+    for(uint_reads_cnt curIdx = 1; pathsReadsCount < readsCount && curIdx <= readsCount; curIdx++) {
+        if (!this->hasPredecessor(curIdx) || !this->hasPredecessor(this->headRead[curIdx]))
+            continue;
+        cyclesCount++;
+        uint_reads_cnt minOverlapIdx = curIdx;
+        uint_reads_cnt nextIdx = curIdx;
+        while ((nextIdx = this->getNextRead(nextIdx)) != curIdx)
+            if (this->getOverlap(minOverlapIdx) > this->getOverlap(nextIdx))
+                minOverlapIdx = nextIdx;
+        overlapLost += this->getOverlap(minOverlapIdx);
+        uint_reads_cnt headIdx = this->getNextRead(minOverlapIdx);
+        this->setReadSuccessor(minOverlapIdx, 0, 0);
+        this->headRead[headIdx] = 0;
+        pathsReadsCount += this->assignPathHead(headIdx);
     }
     *logout << "Removed " << cyclesCount << " cycles (lost " << overlapLost << " symbols)" << endl;
 }
@@ -49,8 +48,11 @@ namespace PgSAIndex {
 
     template<typename uint_read_len, typename uint_reads_cnt>
     void AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::init(bool pgGenerationMode) {
-        nextRead = (uint_reads_cnt*) calloc(readsTotal() + 1, sizeof(uint_reads_cnt));
-        overlap = (uint_read_len *) calloc(readsTotal() + 1, sizeof(uint_read_len));
+        overlapBits = 64 - __builtin_clzll((uint64_t) getReadsSetProperties()->maxReadLength | 1);
+        successorBits = overlapBits + 64 - __builtin_clzll((uint64_t) readsTotal() | 1);
+        successorMask = ((uint64_t) 1 << successorBits) - 1;
+        const uint64_t successorsWords = ((uint64_t) (readsTotal() + 1) * successorBits + 63) / 64 + 1;
+        successors = (uint64_t*) calloc(successorsWords, sizeof(uint64_t));
         if (isGenerationCyclesAware(pgGenerationMode))
             headRead = (uint_reads_cnt *) calloc(readsTotal() + 1, sizeof(uint_reads_cnt));
         readsLeft = readsTotal();
@@ -58,8 +60,7 @@ namespace PgSAIndex {
     
     template<typename uint_read_len, typename uint_reads_cnt>
     void AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::dispose() {   
-        free(nextRead);
-        free(overlap);
+        free(successors);
         free(headRead);
     }
 
@@ -72,19 +73,23 @@ namespace PgSAIndex {
         init(false);
         performOverlapping(overlappedReadsCountStopCoef, false);
 
-        vector<uint_read_len> prevOverlap(readsTotal() + 1, 0);
+        // only the existence and completeness of predecessor overlaps are needed
+        vector<bool> overlappedByPredecessor(readsTotal() + 1, false);
+        vector<bool> coveredByPredecessor(readsTotal() + 1, false);
         for(uint_reads_cnt i = 1; i <= readsTotal(); i++)
-            if (hasSuccessor(i))
-                prevOverlap[nextRead[i]] = overlap[i];
+            if (hasSuccessor(i)) {
+                overlappedByPredecessor[getNextRead(i)] = true;
+                coveredByPredecessor[getNextRead(i)] = getOverlap(i) == readLength(getNextRead(i));
+            }
 
-        uint_reads_cnt resCount = readsTotal();
-        vector<bool> res(readsTotal(), true);
-        for(uint_reads_cnt i = 1; i <= readsTotal(); i++) {
-            if (prevOverlap[i] && hasSuccessor(i))
+        uint_reads_cnt resCount = orgReadsTotal();
+        vector<bool> res(orgReadsTotal(), true);
+        for(uint_reads_cnt i = 1; i <= orgReadsTotal(); i++) {
+            if (overlappedByPredecessor[i] && hasSuccessor(i))
                 continue;
-            if (hasSuccessor(i) && overlap[i] == readLength(i))
+            if (hasSuccessor(i) && getOverlap(i) == readLength(i))
                 continue;
-            if (prevOverlap[i] == readLength(i))
+            if (coveredByPredecessor[i])
                 continue;
             res[i-1] = false;
             resCount--;
@@ -115,8 +120,8 @@ namespace PgSAIndex {
         /* validation
         if (prevRead[nextIdx] > 0) 
             cout << curIdx << " cannot have successor " << nextIdx << " since it already success " << prevRead[nextIdx] << " by " << (int) overlap[prevRead[nextIdx]] << " symbols.\n";
-        if (nextRead[curIdx] > 0)
-            cout << nextIdx << " cannot have predecessor " << curIdx << " since it already precedes " << nextRead[curIdx] << " by " << (int) overlap[curIdx] << " symbols.\n";
+        if (getNextRead(curIdx) > 0)
+            cout << nextIdx << " cannot have predecessor " << curIdx << " since it already precedes " << getNextRead(curIdx) << " by " << (int) getOverlap(curIdx) << " symbols.\n";
         */
         setReadSuccessor(curIdx, nextIdx, overlapLenght);
         if (headRead[curIdx] == 0)
@@ -128,8 +133,17 @@ namespace PgSAIndex {
     template<typename uint_read_len, typename uint_reads_cnt>
     void AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::setReadSuccessor(
             uint_reads_cnt curIdx, uint_reads_cnt nextIdx, uint_read_len overlapLenght) {
-        nextRead[curIdx] = nextIdx;
-        overlap[curIdx] = overlapLenght;
+        // entries of different reads can be set concurrently (they may share words)
+        const uint64_t entry = ((uint64_t) nextIdx << overlapBits) | overlapLenght;
+        const uint64_t bitPos = (uint64_t) curIdx * successorBits;
+        uint64_t* word = successors + (bitPos >> 6);
+        const uint8_t shift = bitPos & 63;
+        __atomic_fetch_and(word, ~(successorMask << shift), __ATOMIC_RELAXED);
+        __atomic_fetch_or(word, entry << shift, __ATOMIC_RELAXED);
+        if (shift + successorBits > 64) {
+            __atomic_fetch_and(word + 1, ~(successorMask >> (64 - shift)), __ATOMIC_RELAXED);
+            __atomic_fetch_or(word + 1, entry >> (64 - shift), __ATOMIC_RELAXED);
+        }
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
@@ -145,17 +159,19 @@ namespace PgSAIndex {
     template<typename uint_read_len, typename uint_reads_cnt>
     uint_pg_len_max AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::countPseudoGenomeLength() {
         uint_pg_len_max len = 0;
-        for(uint_reads_cnt i = 1; i <= readsTotal(); i++)
-            if (overlap[i] < readLength(i))
-                len += (readLength(i) - overlap[i]);
+        #pragma omp parallel for reduction(+:len) num_threads(numberOfThreads)
+        for(int64_t i = 1; i <= (int64_t) readsTotal(); i++)
+            if (getOverlap(i) < readLength(i))
+                len += (readLength(i) - getOverlap(i));
 
-        return len;
+        return isRevComplGeneration() ? len / 2 : len;
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
     uint_reads_cnt AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::countComponents() {
-        uint_reads_cnt count = 0;
-        for(uint_reads_cnt i = 1; i <= readsTotal(); i++)
+        uint_reads_cnt_max count = 0;
+        #pragma omp parallel for reduction(+:count) num_threads(numberOfThreads)
+        for(int64_t i = 1; i <= (int64_t) readsTotal(); i++)
             if (!hasPredecessor(i) && hasSuccessor(i))
                 count++;
         return count;
@@ -163,8 +179,9 @@ namespace PgSAIndex {
 
     template<typename uint_read_len, typename uint_reads_cnt>
     uint_reads_cnt AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::countSingles() {
-        uint_reads_cnt count = 0;
-        for(uint_reads_cnt i = 1; i <= readsTotal(); i++)
+        uint_reads_cnt_max count = 0;
+        #pragma omp parallel for reduction(+:count) num_threads(numberOfThreads)
+        for(int64_t i = 1; i <= (int64_t) readsTotal(); i++)
             if (!hasPredecessor(i) && !hasSuccessor(i))
                 count++;
         return count;
@@ -194,20 +211,32 @@ namespace PgSAIndex {
         uint_read_len readLength = this->getReadsSetProperties()->maxReadLength;
         uint_read_len prefixDoneLength = 0;
 
+        // only one of the reverse complement counterparts of each path is assembled
+        const bool revComplGeneration = isRevComplGeneration();
+        const uint_reads_cnt orgReadsCount = orgReadsTotal();
+        vector<bool> isReadAssembled(revComplGeneration ? orgReadsCount : 0, false);
         for (uint_reads_cnt i = 1; i <= readsTotal(); i++) {
             uint_reads_cnt idx = i;
+            if (revComplGeneration && isReadAssembled[(idx - 1) % orgReadsCount])
+                continue;
             if (!hasPredecessor(idx))
                 do {
-                    genPG->append(readLength, overlap[idx], idx - 1);
-                    const uint_read_len shiftLength = readLength - overlap[idx];
+                    if (revComplGeneration) {
+                        const bool revComp = idx > orgReadsCount;
+                        const uint_reads_cnt orgIdx = revComp ? idx - 1 - orgReadsCount : idx - 1;
+                        isReadAssembled[orgIdx] = true;
+                        appendRead(genPG, readLength, getOverlap(idx), orgIdx, revComp);
+                    } else
+                        genPG->append(readLength, getOverlap(idx), idx - 1);
+                    const uint_read_len shiftLength = readLength - getOverlap(idx);
                     if (prefixDoneLength < shiftLength) {
                         getReadSuffix(seq, idx, prefixDoneLength);
                         seq += readLength - prefixDoneLength;
-                        prefixDoneLength = overlap[idx];
+                        prefixDoneLength = getOverlap(idx);
                     } else {
                         prefixDoneLength -= shiftLength;
                     }
-                    idx = nextRead[idx];
+                    idx = getNextRead(idx);
 
                 } while (idx != 0);
         }
@@ -218,6 +247,150 @@ namespace PgSAIndex {
         return genPG;
     }
 
+    template<typename T>
+    static T parallelExclusivePrefixSum(vector<T> &values) {
+        const size_t n = values.size();
+        vector<T> threadPos(numberOfThreads + 1, 0);
+        T total = 0;
+        #pragma omp parallel num_threads(numberOfThreads)
+        {
+            const int t = omp_get_thread_num();
+            const int threadsCount = omp_get_num_threads();
+            const size_t begin = n * t / threadsCount;
+            const size_t end = n * (t + 1) / threadsCount;
+            T sum = 0;
+            for (size_t i = begin; i < end; i++)
+                sum += values[i];
+            threadPos[t + 1] = sum;
+            #pragma omp barrier
+            #pragma omp single
+            {
+                for (int t2 = 0; t2 < threadsCount; t2++)
+                    threadPos[t2 + 1] += threadPos[t2];
+                total = threadPos[threadsCount];
+            }
+            sum = threadPos[t];
+            for (size_t i = begin; i < end; i++) {
+                const T value = values[i];
+                values[i] = sum;
+                sum += value;
+            }
+        }
+        return total;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    GeneratedSeparatedPseudoGenome* AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::assembleSeparatedPseudoGenome() {
+        time_checkpoint();
+        if (!getReadsSetProperties()->constantReadLength) {
+            cout << "ERROR: Unsuported variable reads length!";
+            exit(EXIT_FAILURE);
+        }
+        const uint_read_len readLength = this->getReadsSetProperties()->maxReadLength;
+        const bool revComplGeneration = isRevComplGeneration();
+        const uint_reads_cnt orgReadsCount = orgReadsTotal();
+
+        // paths are assembled in order of their heads; their reads count and length determine output ranges
+        const vector<uint_reads_cnt> heads = collectPathHeads();
+        const int64_t pathsCount = heads.size();
+        vector<uint_reads_cnt> pathReadsPos(pathsCount);
+        vector<uint_pg_len_max> pathPgPos(pathsCount);
+        #pragma omp parallel for schedule(dynamic, 64) num_threads(numberOfThreads)
+        for(int64_t p = 0; p < pathsCount; p++) {
+            uint_reads_cnt idx = heads[p];
+            uint_reads_cnt tailIdx;
+            uint_reads_cnt_max readsCount = 0;
+            uint_pg_len_max pgLength = 0;
+            do {
+                readsCount++;
+                pgLength += readLength - getOverlap(idx);
+                tailIdx = idx;
+            } while ((idx = getNextRead(idx)));
+            // only one of the reverse complement counterparts of each path is assembled
+            if (revComplGeneration &&
+                heads[p] > (tailIdx > orgReadsCount ? tailIdx - orgReadsCount : tailIdx + orgReadsCount)) {
+                readsCount = 0;
+                pgLength = 0;
+            }
+            pathReadsPos[p] = readsCount;
+            pathPgPos[p] = pgLength;
+        }
+        const uint_reads_cnt_max readsCount = parallelExclusivePrefixSum(pathReadsPos);
+        const uint_pg_len_max pgLength = parallelExclusivePrefixSum(pathPgPos);
+        assert(readsCount == orgReadsCount && pgLength == this->pseudoGenomeLength);
+
+        GeneratedSeparatedPseudoGenome* genPG =
+                new GeneratedSeparatedPseudoGenome(this->pseudoGenomeLength, getReadsSetProperties());
+        genPG->resizeReadsList(readsCount, revComplGeneration);
+        ExtendedReadsListWithConstantAccessOption* readsList = genPG->getReadsList();
+        char* pgSeq = genPG->getSequencePtr();
+        #pragma omp parallel for schedule(dynamic, 64) num_threads(numberOfThreads)
+        for(int64_t p = 0; p < pathsCount; p++) {
+            uint_reads_cnt_max r = pathReadsPos[p];
+            if (r == (p + 1 < pathsCount ? pathReadsPos[p + 1] : readsCount))
+                continue;
+            char* seq = pgSeq + pathPgPos[p];
+            // the preceding path ends with a read not overlapped by any other
+            uint_read_len_max delta = r ? readLength : 0;
+            uint_read_len prefixDoneLength = 0;
+            uint_reads_cnt idx = heads[p];
+            do {
+                readsList->off.set(r, delta);
+                if (revComplGeneration) {
+                    readsList->orgIdx.set(r, (idx - 1) % orgReadsCount);
+                    readsList->revComp[r] = idx > orgReadsCount;
+                } else
+                    readsList->orgIdx.set(r, idx - 1);
+                r++;
+                delta = readLength - getOverlap(idx);
+                if (prefixDoneLength < delta) {
+                    getReadSuffix(seq, idx, prefixDoneLength);
+                    seq += readLength - prefixDoneLength;
+                    prefixDoneLength = getOverlap(idx);
+                } else {
+                    prefixDoneLength -= delta;
+                }
+                idx = getNextRead(idx);
+            } while (idx != 0);
+        }
+
+        genPG->validate();
+        *logout << "Pseudogenome assembled in " << time_millis() << " msec\n\n";
+
+        return genPG;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    vector<uint_reads_cnt> AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::collectPathHeads() {
+        const uint_reads_cnt_max readsCount = readsTotal();
+        vector<vector<uint_reads_cnt>> threadHeads(numberOfThreads);
+        #pragma omp parallel num_threads(numberOfThreads)
+        {
+            const int t = omp_get_thread_num();
+            const int threadsCount = omp_get_num_threads();
+            const uint_reads_cnt_max begin = readsCount * t / threadsCount + 1;
+            const uint_reads_cnt_max end = readsCount * (t + 1) / threadsCount + 1;
+            for (uint_reads_cnt_max i = begin; i < end; i++)
+                if (!hasPredecessor(i))
+                    threadHeads[t].push_back(i);
+        }
+        vector<uint_reads_cnt> heads;
+        for (vector<uint_reads_cnt> &curHeads: threadHeads)
+            heads.insert(heads.end(), curHeads.begin(), curHeads.end());
+        return heads;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    uint_reads_cnt AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::assignPathHead(uint_reads_cnt headIdx) {
+        uint_reads_cnt count = 1;
+        uint_reads_cnt idx = headIdx;
+        while ((idx = getNextRead(idx))) {
+            headRead[idx] = headIdx;
+            count++;
+        }
+        return count;
+    }
+
     template<typename uint_read_len, typename uint_reads_cnt>
     bool AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::hasPredecessor(uint_reads_cnt incIdx) {
         assert(headRead != 0);
@@ -226,7 +399,7 @@ namespace PgSAIndex {
 
     template<typename uint_read_len, typename uint_reads_cnt>
     bool AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>::hasSuccessor(uint_reads_cnt incIdx) {
-        return nextRead[incIdx];
+        return getNextRead(incIdx);
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
@@ -250,7 +423,7 @@ namespace PgSAIndex {
         init();
         performOverlapping();
 
-        SeparatedPseudoGenome* pg = assemblePseudoGenomeTemplate<GeneratedSeparatedPseudoGenome>();
+        SeparatedPseudoGenome* pg = assembleSeparatedPseudoGenome();
 
         dispose();
         return pg;
@@ -276,7 +449,24 @@ namespace PgSAIndex {
         return pg;
     }
 
+    // pseudo genomes of constant length reads are limited to standard reads count
+    template<>
+    PseudoGenomeBase *
+    AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len_min, uint_reads_cnt_max>::generatePseudoGenomeBase() {
+        fprintf(stderr, "Unsupported: pseudo genome of over %u reads.\n", UINT_MAX - 1);
+        exit(EXIT_FAILURE);
+    }
+
+    template<>
+    PseudoGenomeBase *
+    AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len_std, uint_reads_cnt_max>::generatePseudoGenomeBase() {
+        fprintf(stderr, "Unsupported: pseudo genome of over %u reads.\n", UINT_MAX - 1);
+        exit(EXIT_FAILURE);
+    }
+
     template class AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len_min, uint_reads_cnt_std>;
     template class AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len_std, uint_reads_cnt_std>;
+    template class AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len_min, uint_reads_cnt_max>;
+    template class AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len_std, uint_reads_cnt_max>;
     
 }
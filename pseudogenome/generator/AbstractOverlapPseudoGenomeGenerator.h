@@ -4,6 +4,7 @@
 #include "PseudoGenomeGeneratorBase.h"
 #include <algorithm>
 #include <set>
+#include <cassert>
 #include "../persistence/SeparatedPseudoGenomePersistence.h"
 
 using namespace PgSAReadsSet;
@@ -17,11 +18,32 @@ namespace PgSAIndex {
     protected:
 
         // auxiliary structures
-        uint_reads_cnt* nextRead = 0;
-        uint_read_len* overlap = 0;
+        // successor index and overlap length of each read are bit-packed (entries may span two words)
+        uint64_t* successors = 0;
+        uint8_t overlapBits = 0;
+        uint8_t successorBits = 0;
+        uint64_t successorMask = 0;
         uint_reads_cnt* headRead = 0;
         uint_reads_cnt readsLeft;
 
+        inline uint64_t getSuccessorEntry(uint_reads_cnt incIdx) const {
+            const uint64_t bitPos = (uint64_t) incIdx * successorBits;
+            const uint64_t* word = successors + (bitPos >> 6);
+            const uint8_t shift = bitPos & 63;
+            uint64_t entry = __atomic_load_n(word, __ATOMIC_RELAXED) >> shift;
+            if (shift + successorBits > 64)
+                entry |= __atomic_load_n(word + 1, __ATOMIC_RELAXED) << (64 - shift);
+            return entry & successorMask;
+        }
+
+        inline uint_reads_cnt getNextRead(uint_reads_cnt incIdx) const {
+            return getSuccessorEntry(incIdx) >> overlapBits;
+        }
+
+        inline uint_read_len getOverlap(uint_reads_cnt incIdx) const {
+            return getSuccessorEntry(incIdx) & (((uint64_t) 1 << overlapBits) - 1);
+        }
+
         bool hasPredecessor(uint_reads_cnt incIdx);
         bool hasSuccessor(uint_reads_cnt incIdx);
         void unionOverlappedReads(uint_reads_cnt curIdx, uint_reads_cnt nextIdx, uint_read_len overlapLenght);
@@ -44,6 +66,17 @@ namespace PgSAIndex {
         template<class GeneratedPseudoGenome>
         GeneratedPseudoGenome* assemblePseudoGenomeTemplate();
 
+        // fills preallocated reads list and sequence in parallel (paths are written to disjoint ranges)
+        GeneratedSeparatedPseudoGenome* assembleSeparatedPseudoGenome();
+
+        // only separated Pgs support reverse complemented reads
+        template<class GeneratedPseudoGenome>
+        static void appendRead(GeneratedPseudoGenome* genPG, uint_read_len length, uint_read_len overlap,
+                uint_reads_cnt orgIdx, bool revComp) {
+            assert(!revComp);
+            genPG->append(length, overlap, orgIdx);
+        }
+
         virtual void findOverlappingReads(double overlappedReadsCountStopCoef, bool pgGenerationMode) = 0;
 
         uint_pg_len_max countPseudoGenomeLength();
@@ -55,7 +88,14 @@ namespace PgSAIndex {
         void dispose();
 
         virtual bool isGenerationCyclesAware(bool pgGenerationMode) = 0;
+        // reads set is followed by reverse complements of reads (each Pg path has its reverse complement counterpart)
+        virtual bool isRevComplGeneration() { return false; };
+        inline uint_reads_cnt orgReadsTotal() { return isRevComplGeneration() ? readsTotal() / 2 : readsTotal(); };
         void removeCyclesAndPrepareComponents();
+        // ascending indexes of reads without predecessor
+        vector<uint_reads_cnt> collectPathHeads();
+        // returns the number of reads in the path
+        uint_reads_cnt assignPathHead(uint_reads_cnt headIdx);
 
     public:
 
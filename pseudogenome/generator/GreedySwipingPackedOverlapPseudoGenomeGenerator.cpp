@@ -27,7 +27,7 @@ namespace PgSAIndex {
     
     template<typename uint_read_len, typename uint_reads_cnt>
     string GreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getReadUpToOverlap(uint_reads_cnt incIdx) {
-        return packedReadsSet->getReadPrefix(incIdx - 1, this->overlap[incIdx]);
+        return packedReadsSet->getReadPrefix(incIdx - 1, this->getOverlap(incIdx));
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
@@ -254,9 +254,7 @@ namespace PgSAIndex {
         if (isReadsCountStd(readsSet->readsCount()))
             return getGeneratorFullTemplate<uint_read_len, uint_reads_cnt_std>(readsSet, ownReadsSet);
         else
-            cout << "UNSUPPORTED READS COUNT!!!???";
-
-        return 0;
+            return getGeneratorFullTemplate<uint_read_len, uint_reads_cnt_max>(readsSet, ownReadsSet);
     }
 
     PseudoGenomeGeneratorBase* GreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::getGenerator(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIterator) {
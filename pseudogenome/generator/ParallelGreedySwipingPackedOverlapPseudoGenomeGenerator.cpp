@@ -2,8 +2,9 @@
 #include "../../readsset/persistance/ReadsSetPersistence.h"
 #include "AbstractOverlapPseudoGenomeGenerator.h"
 
-#include <parallel/algorithm>
+#include <omp.h>
 #include <cassert>
+#include <numeric>
 
 using namespace PgSAReadsSet;
 using namespace PgSAHelpers;
@@ -14,23 +15,27 @@ namespace PgSAIndex {
 
     template<typename uint_read_len, typename uint_reads_cnt>
     ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::ParallelGreedySwipingPackedOverlapGeneratorTemplate(
-            PackedConstantLengthReadsSet* orgReadsSet, bool ownReadsSet):
-        packedReadsSet(orgReadsSet), symbolsCount(orgReadsSet->getReadsSetProperties()->symbolsCount),
-        ownReadsSet(ownReadsSet)
+            PackedConstantLengthReadsSet* orgReadsSet, bool ownReadsSet, bool revComplMode):
+        orgReadsSet(orgReadsSet), packedReadsSet(orgReadsSet), symbolsCount(orgReadsSet->getReadsSetProperties()->symbolsCount),
+        ownReadsSet(ownReadsSet), revComplMode(revComplMode)
     {
         if (!orgReadsSet->isReadLengthConstant())
             cout << "Unsupported: variable length reads :(";
+        if (revComplMode)
+            packedReadsSet = orgReadsSet->getCopyWithReverseComplements();
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
     ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::~ParallelGreedySwipingPackedOverlapGeneratorTemplate() {
-        if (ownReadsSet && this->packedReadsSet)
+        if (revComplMode)
             delete(this->packedReadsSet);
+        if (ownReadsSet && this->orgReadsSet)
+            delete(this->orgReadsSet);
     }
     
     template<typename uint_read_len, typename uint_reads_cnt>
     string ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getReadUpToOverlap(uint_reads_cnt incIdx) {
-        return packedReadsSet->getReadPrefix(incIdx - 1, this->overlap[incIdx]);
+        return packedReadsSet->getReadPrefix(incIdx - 1, this->getOverlap(incIdx));
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
@@ -49,7 +54,19 @@ namespace PgSAIndex {
     }  
     template<typename uint_read_len, typename uint_reads_cnt>
     ReadsSetProperties* ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getReadsSetProperties() {
-        return packedReadsSet->getReadsSetProperties();
+        return orgReadsSet->getReadsSetProperties();
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    template<bool avoidCyclesMode>
+    bool ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::isOverlapAllowed(
+            uint_reads_cnt sufIncIdx, uint_reads_cnt preIncIdx) {
+        if (sufIncIdx == preIncIdx)
+            return false;
+        if (!avoidCyclesMode)
+            return true;
+        // a read overlapping its own reverse complement would make a path of the Pg its own reverse complement
+        return !this->isHeadOf(sufIncIdx, preIncIdx) && (!revComplMode || preIncIdx != getRevComplIdx(sufIncIdx));
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
@@ -97,8 +114,7 @@ namespace PgSAIndex {
     template<bool pgGenerationMode>
     void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::setDuplicateSuccessor(
             uint_reads_cnt curIdx, uint_reads_cnt nextIdx, uint_read_len overlapLenght) {
-        this->nextRead[curIdx] = nextIdx;
-        this->overlap[curIdx] = overlapLenght;
+        this->setReadSuccessor(curIdx, nextIdx, overlapLenght);
         if (pgGenerationMode) {
             if (this->headRead[curIdx] == 0)
                 this->headRead[nextIdx] = curIdx;
@@ -109,170 +125,486 @@ namespace PgSAIndex {
 
 
     template<typename uint_read_len, typename uint_reads_cnt>
-    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::prepareSortedReadsBlocks() {
-        for (uint_reads_cnt i = 1; i <= packedReadsSet->readsCount(); i++)
-            sortedReadsIdxs.push_back(i);
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::initBlocks() {
+        const uint_reads_cnt readsCount = this->readsLeft;
+        const uint_read_len readLength = packedReadsSet->maxReadLength();
+        blockPrefixLength = MIN_BLOCK_PREFIX_LENGTH;
+        blocksCount = pow(symbolsCount, blockPrefixLength);
+        while (blockPrefixLength < MAX_BLOCK_PREFIX_LENGTH && blockPrefixLength + 1 < readLength / 2 &&
+               blocksCount < (uint64_t) numberOfThreads * BLOCKS_PER_THREAD &&
+               (uint64_t) blocksCount * symbolsCount * MIN_READS_PER_BLOCK <= readsCount) {
+            blockPrefixLength++;
+            blocksCount *= symbolsCount;
+        }
+        *logout << "Reads partitioned into " << blocksCount << " blocks (prefix length " << (int) blockPrefixLength
+                << ")." << endl;
+        sortedReadsBlockPos.assign(blocksCount + 1, 0);
+        sortedReadsCount.assign(blocksCount, 0);
+        sortedSuffixBlockPlusSymbolPos.resize(blocksCount + 1);
+        sortedSuffixBlockPos.assign(blocksCount + 1, 0);
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::assignBlocksToJobs(
+            int jobsCount, const vector<uint64_t> &cumulativeBlockLoad) {
+        jobStartBlock.assign(jobsCount + 1, 0);
+        uint_blocks_cnt b = 0;
+        for(int job = 1; job < jobsCount; job++) {
+            const uint64_t threshold = ((double) job / jobsCount) * cumulativeBlockLoad[blocksCount];
+            while (b < blocksCount && cumulativeBlockLoad[b] < threshold)
+                b++;
+            jobStartBlock[job] = b;
+        }
+        jobStartBlock[jobsCount] = blocksCount;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    typename ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::uint_blocks_cnt
+            ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getReadBlock(uint_reads_cnt incIdx) {
+        if (packedReadsSet->sPacker->getBitsPerSymbol())
+            return packedReadsSet->sPacker->getPackedSymbolsWord(packedReadsSet->getPackedRead(incIdx - 1), 0,
+                    blockPrefixLength) >> (64 - blockPrefixLength * keySymbolBits);
+        char prefix[MAX_BLOCK_PREFIX_LENGTH];
+        packedReadsSet->sPacker->reverseSequence(packedReadsSet->getPackedRead(incIdx - 1), 0, blockPrefixLength, prefix);
+        uint_blocks_cnt b = 0;
+        for (uint8_t j = 0; j < blockPrefixLength; j++)
+            b = b * symbolsCount + getReadsSetProperties()->symbolOrder[(uchar) prefix[j]];
+        return b;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    typename ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::uint_blocks_cnt
+            ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getSuffixBlock(
+                    uint_reads_cnt incIdx, uint_read_len pos, uint8_t length) {
+        if (length == 0)
+            return 0;
+        char symbols[MAX_BLOCK_PREFIX_LENGTH];
+        packedReadsSet->sPacker->reverseSequence(packedReadsSet->getPackedRead(incIdx - 1), pos, length, symbols);
+        uint_blocks_cnt b = 0;
+        for (uint8_t j = 0; j < length; j++)
+            b = b * symbolsCount + getReadsSetProperties()->symbolOrder[(uchar) symbols[j]];
+        return b;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    uint64_t ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getReadKey(uint_reads_cnt incIdx) {
+        if (keySymbolsCount == 0)
+            return 0;
+        if (packedReadsSet->sPacker->getBitsPerSymbol())
+            return packedReadsSet->sPacker->getPackedSymbolsWord(packedReadsSet->getPackedRead(incIdx - 1),
+                    blockPrefixLength, keySymbolsCount);
+        char symbols[64];
+        packedReadsSet->sPacker->reverseSequence(packedReadsSet->getPackedRead(incIdx - 1), blockPrefixLength,
+                keySymbolsCount, symbols);
+        uint64_t key = 0;
+        for (uint8_t j = 0; j < keySymbolsCount; j++)
+            key = (key << keySymbolBits) | getReadsSetProperties()->symbolOrder[(uchar) symbols[j]];
+        return key << (64 - keySymbolsCount * keySymbolBits);
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::radixSortReadKeys(
+            ReadKey* keys, ReadKey* tmp, size_t n, int shift) {
+        if (n <= RADIX_SORT_SMALL_BUCKET_SIZE) {
+            std::sort(keys, keys + n, [](const ReadKey &l, const ReadKey &r) { return l.key < r.key; });
+            return;
+        }
+        size_t bucketPos[UINT8_MAX + 2] = { 0 };
+        for (size_t i = 0; i < n; i++)
+            bucketPos[((keys[i].key >> shift) & UINT8_MAX) + 1]++;
+        for (int d = 0; d <= UINT8_MAX; d++)
+            bucketPos[d + 1] += bucketPos[d];
+        size_t bucketIdx[UINT8_MAX + 1];
+        std::copy(bucketPos, bucketPos + UINT8_MAX + 1, bucketIdx);
+        for (size_t i = 0; i < n; i++)
+            tmp[bucketIdx[(keys[i].key >> shift) & UINT8_MAX]++] = keys[i];
+        std::copy(tmp, tmp + n, keys);
+        if (shift == 0)
+            return;
+        for (int d = 0; d <= UINT8_MAX; d++)
+            if (bucketPos[d + 1] - bucketPos[d] > 1)
+                radixSortReadKeys(keys + bucketPos[d], tmp + bucketPos[d], bucketPos[d + 1] - bucketPos[d], shift - 8);
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::sortReadsBlock(uint_blocks_cnt b) {
+        const size_t n = sortedReadsBlockPos[b + 1] - sortedReadsBlockPos[b];
+        if (n < 2)
+            return;
+        uint_reads_cnt* blockIdxs = sortedReadsIdxs.data() + sortedReadsBlockPos[b];
+        vector<ReadKey> keys(n);
+        vector<ReadKey> tmp(n);
+        for (size_t i = 0; i < n; i++)
+            keys[i] = { getReadKey(blockIdxs[i]), blockIdxs[i] };
+        radixSortReadKeys(keys.data(), tmp.data(), n, 56);
+        for (size_t i = 0; i < n; i++)
+            blockIdxs[i] = keys[i].incIdx;
+        if (blockPrefixLength + keySymbolsCount >= packedReadsSet->maxReadLength())
+            return;
+        // reads with equal cached keys are ordered by the remaining symbols
         PackedReadsComparator comparePacked = PackedReadsComparator(this);
-        __gnu_parallel::sort(sortedReadsIdxs.begin(), sortedReadsIdxs.end(), comparePacked);
+        for (size_t i = 0, j; i < n; i = j) {
+            for (j = i + 1; j < n && keys[j].key == keys[i].key; j++);
+            if (j - i > 1)
+                std::sort(blockIdxs + i, blockIdxs + j, comparePacked);
+        }
+    }
 
-        blocksCount = pow(symbolsCount, blockPrefixLength);
-        #pragma omp parallel for
-        for (uint16_t b = 0; b < blocksCount; b++) {
-            char *prefix = blockPrefixes[b];
-            uint16_t val = b;
-            for (uint8_t j = 0; j < blockPrefixLength; j++) {
-                uint8_t div = val % symbolsCount;
-                prefix[blockPrefixLength - j - 1] = packedReadsSet->getReadsSetProperties()->symbolsList[div];
-                val = val / symbolsCount;
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::prepareSortedReadsBlocks() {
+        initBlocks();
+        keySymbolBits = 1;
+        while ((1 << keySymbolBits) < symbolsCount)
+            keySymbolBits++;
+        keySymbolsCount = min<int>(64 / keySymbolBits,
+                packedReadsSet->maxReadLength() > blockPrefixLength ? packedReadsSet->maxReadLength() - blockPrefixLength : 0);
+
+        vector<uint_reads_cnt> uniqueReadsIdxs;
+        uniqueReadsIdxs.swap(sortedReadsIdxs);
+        distributeReads(uniqueReadsIdxs.data(), uniqueReadsIdxs.size(),
+                [this](uint_reads_cnt incIdx) { return getReadBlock(incIdx); },
+                blocksCount, sortedReadsBlockPos.data(), sortedReadsIdxs);
+        vector<uint_reads_cnt>().swap(uniqueReadsIdxs);
+
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(numberOfThreads)
+        for (int b = 0; b < blocksCount; b++)
+            sortReadsBlock(b);
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    template<typename KeyFunction>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::distributeReads(
+            const uint_reads_cnt *srcIdxs, uint_reads_cnt n, KeyFunction getKey, uint32_t keysCount,
+            uint_reads_cnt *keyPos, vector<uint_reads_cnt> &destIdxs) {
+        vector<uint32_t> readKey(n);
+        // each thread counts at least keysCount reads, so the counters take no more space than the reads indexes
+        const int threadsLimit = max<int>(1, min<uint64_t>(numberOfThreads, n / keysCount));
+        vector<uint_reads_cnt> threadKeyPos((size_t) threadsLimit * keysCount, 0);
+        vector<uint_reads_cnt> rangeStartPos(threadsLimit + 1, 0);
+        destIdxs.resize(n);
+        keyPos[0] = 0;
+        #pragma omp parallel num_threads(threadsLimit)
+        {
+            const int t = omp_get_thread_num();
+            const int threadsCount = omp_get_num_threads();
+            const uint_reads_cnt begin = (uint64_t) n * t / threadsCount;
+            const uint_reads_cnt end = (uint64_t) n * (t + 1) / threadsCount;
+            uint_reads_cnt* curKeyPos = threadKeyPos.data() + (size_t) t * keysCount;
+            for (uint_reads_cnt i = begin; i < end; i++)
+                curKeyPos[readKey[i] = getKey(srcIdxs ? srcIdxs[i] : i + 1)]++;
+            #pragma omp barrier
+            // key counts of a range are summed up (in keyPos shifted by one) row by row
+            const uint32_t keyBegin = (uint64_t) keysCount * t / threadsCount;
+            const uint32_t keyEnd = (uint64_t) keysCount * (t + 1) / threadsCount;
+            std::fill(keyPos + keyBegin + 1, keyPos + keyEnd + 1, 0);
+            for (int t2 = 0; t2 < threadsCount; t2++) {
+                const uint_reads_cnt* t2KeyPos = threadKeyPos.data() + (size_t) t2 * keysCount;
+                for (uint32_t k = keyBegin; k < keyEnd; k++)
+                    keyPos[k + 1] += t2KeyPos[k];
+            }
+            uint_reads_cnt rangeCount = 0;
+            for (uint32_t k = keyBegin; k < keyEnd; k++)
+                rangeCount += keyPos[k + 1];
+            rangeStartPos[t + 1] = rangeCount;
+            #pragma omp barrier
+            #pragma omp single
+            {
+                for (int t2 = 0; t2 < threadsCount; t2++)
+                    rangeStartPos[t2 + 1] += rangeStartPos[t2];
             }
-            PackedReadVsPatternComparator comparePackedWithPattern = PackedReadVsPatternComparator(this, prefix);
-            sortedReadsBlockPos[b] = lower_bound(sortedReadsIdxs.begin(), sortedReadsIdxs.end(),
-                                                 comparePackedWithPattern.PATTERN_INDEX,
-                                                 comparePackedWithPattern) - sortedReadsIdxs.begin();
+            uint_reads_cnt pos = rangeStartPos[t];
+            for (uint32_t k = keyBegin; k < keyEnd; k++) {
+                const uint_reads_cnt count = keyPos[k + 1];
+                keyPos[k + 1] = pos;
+                pos += count;
+            }
+            // keyPos[k + 1] advances from the start to the end of key k (i.e. the start of key k + 1)
+            for (int t2 = 0; t2 < threadsCount; t2++) {
+                uint_reads_cnt* t2KeyPos = threadKeyPos.data() + (size_t) t2 * keysCount;
+                for (uint32_t k = keyBegin; k < keyEnd; k++) {
+                    const uint_reads_cnt count = t2KeyPos[k];
+                    t2KeyPos[k] = keyPos[k + 1];
+                    keyPos[k + 1] += count;
+                }
+            }
+            #pragma omp barrier
+            for (uint_reads_cnt i = begin; i < end; i++)
+                destIdxs[curKeyPos[readKey[i]]++] = srcIdxs ? srcIdxs[i] : i + 1;
         }
-        sortedReadsBlockPos[blocksCount] = packedReadsSet->readsCount();
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
-    template<bool avoidCyclesMode>
-    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::initAndFindDuplicates() {
-        auto start_t = chrono::steady_clock::now();
-        prepareSortedReadsBlocks();
-        uint16_t b = 0;
-        threadStartBlock[UINT8_MAX] = 0;
-        for(uint8_t t = 1; t <= numberOfThreads; t++) {
-            uint_reads_cnt threshold = ((double) t / numberOfThreads) * this->readsLeft;
-            while (sortedReadsBlockPos[b] < threshold) {
-                b++;
+    uint64_t ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getOrientedReadHash(
+            uint_reads_cnt incIdx, uint_reads_cnt &orientedIncIdx) {
+        orientedIncIdx = incIdx;
+        const uint64_t hash = packedReadsSet->hashPackedRead(incIdx - 1);
+        if (revComplMode) {
+            const uint_reads_cnt rcIncIdx = getRevComplIdx(incIdx);
+            const uint64_t rcHash = packedReadsSet->hashPackedRead(rcIncIdx - 1);
+            if (rcHash < hash) {
+                orientedIncIdx = rcIncIdx;
+                return rcHash;
             }
-            threadStartBlock[t] = b;
         }
-        threadStartBlock[numberOfThreads] = blocksCount;
-        uint_reads_cnt sortedSuffixesLeftCount[MAX_BLOCKS_COUNT] = { 0 };
+        return hash;
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    template<bool avoidCyclesMode>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::collapseDuplicates() {
+        // reverse complements are chained (in reverse order) along with the duplicates of original reads
+        const uint8_t orientationsCount = revComplMode ? 2 : 1;
+        const uint_reads_cnt readsCount = packedReadsSet->readsCount() / orientationsCount;
+        uint8_t hashBucketBits = MIN_HASH_BUCKET_BITS;
+        while (hashBucketBits < MAX_HASH_BUCKET_BITS && ((uint64_t) 1 << hashBucketBits) * READS_PER_HASH_BUCKET < readsCount)
+            hashBucketBits++;
+        const uint32_t bucketsCount = 1 << hashBucketBits;
+        vector<uint_reads_cnt> bucketPos(bucketsCount + 1);
+        vector<uint_reads_cnt> bucketedReadsIdxs;
+        distributeReads(0, readsCount,
+                [this, hashBucketBits](uint_reads_cnt incIdx) {
+                    uint_reads_cnt orientedIncIdx;
+                    return (uint32_t) (getOrientedReadHash(incIdx, orientedIncIdx) >> (64 - hashBucketBits)); },
+                bucketsCount, bucketPos.data(), bucketedReadsIdxs);
+
+        // identical reads are chained in the order of indexes, their heads are moved to the front of a bucket
+        vector<uint_reads_cnt> uniqueReadsCount(bucketsCount);
         uint_reads_cnt duplicatesCount = 0;
-        #pragma omp parallel for reduction(+:sortedSuffixesLeftCount[0:MAX_BLOCKS_COUNT]) reduction(+:duplicatesCount)
-        for(uint8_t t = 0; t < numberOfThreads; t++)
+        #pragma omp parallel num_threads(numberOfThreads) reduction(+:duplicatesCount)
         {
-            for (uint16_t b = threadStartBlock[t]; b < threadStartBlock[t + 1]; b++)
+            vector<pair<uint64_t, uint_reads_cnt>> hashes;
+            vector<pair<uint_reads_cnt, uint_reads_cnt>> headAndLastIdxs;
+            #pragma omp for schedule(dynamic, 1)
+            for (int64_t bucket = 0; bucket < bucketsCount; bucket++) {
+                uint_reads_cnt* bucketIdxs = bucketedReadsIdxs.data() + bucketPos[bucket];
+                const uint_reads_cnt n = bucketPos[bucket + 1] - bucketPos[bucket];
+                hashes.resize(n);
+                for (uint_reads_cnt i = 0; i < n; i++)
+                    hashes[i].first = getOrientedReadHash(bucketIdxs[i], hashes[i].second);
+                std::sort(hashes.begin(), hashes.end());
+                uint_reads_cnt uniqueCount = 0;
+                for (uint_reads_cnt i = 0, j; i < n; i = j) {
+                    headAndLastIdxs.clear();
+                    for (j = i; j < n && hashes[j].first == hashes[i].first; j++) {
+                        const uint_reads_cnt incIdx = hashes[j].second;
+                        auto it = headAndLastIdxs.begin();
+                        while (it != headAndLastIdxs.end() && !packedReadsSet->equalPackedReads(it->first - 1, incIdx - 1))
+                            it++;
+                        if (it == headAndLastIdxs.end()) {
+                            headAndLastIdxs.push_back({incIdx, incIdx});
+                            bucketIdxs[uniqueCount++] = incIdx;
+                            continue;
+                        }
+                        this->setDuplicateSuccessor<avoidCyclesMode>(it->second, incIdx, packedReadsSet->maxReadLength());
+                        it->second = incIdx;
+                        duplicatesCount++;
+                    }
+                    if (revComplMode) {
+                        for (const auto &headAndLastIdx: headAndLastIdxs) {
+                            const uint_reads_cnt rcHeadIdx = getRevComplIdx(headAndLastIdx.second);
+                            for (uint_reads_cnt idx = headAndLastIdx.first; idx != headAndLastIdx.second;
+                                 idx = this->getNextRead(idx)) {
+                                const uint_reads_cnt rcIdx = getRevComplIdx(idx);
+                                this->setReadSuccessor(getRevComplIdx(this->getNextRead(idx)), rcIdx,
+                                                       packedReadsSet->maxReadLength());
+                                if (avoidCyclesMode)
+                                    this->headRead[rcIdx] = rcHeadIdx;
+                            }
+                        }
+                    }
+                }
+                uniqueReadsCount[bucket] = uniqueCount;
+            }
+        }
+        this->readsLeft -= orientationsCount * duplicatesCount;
+
+        vector<uint_reads_cnt> uniqueReadsPos(bucketsCount + 1, 0);
+        for (uint32_t bucket = 0; bucket < bucketsCount; bucket++)
+            uniqueReadsPos[bucket + 1] = uniqueReadsPos[bucket] + orientationsCount * uniqueReadsCount[bucket];
+        sortedReadsIdxs.resize(this->readsLeft);
+        #pragma omp parallel for schedule(guided) num_threads(numberOfThreads)
+        for (int64_t bucket = 0; bucket < bucketsCount; bucket++) {
+            const uint_reads_cnt* headIdxs = bucketedReadsIdxs.data() + bucketPos[bucket];
+            uint_reads_cnt* destIdxs = sortedReadsIdxs.data() + uniqueReadsPos[bucket];
+            for (uint_reads_cnt i = 0; i < uniqueReadsCount[bucket]; i++) {
+                *(destIdxs++) = headIdxs[i];
+                if (revComplMode) {
+                    uint_reads_cnt lastIdx = headIdxs[i];
+                    while (this->getNextRead(lastIdx))
+                        lastIdx = this->getNextRead(lastIdx);
+                    *(destIdxs++) = getRevComplIdx(lastIdx);
+                }
+            }
+        }
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    template<bool avoidCyclesMode>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::initAndFindDuplicates() {
+        collapseDuplicates<avoidCyclesMode>();
+        cout << "Found " << (readsTotal() - this->readsLeft) / (revComplMode ? 2 : 1) << " duplicates (..."
+                << time_millis() << " msec)" << endl;
+        prepareSortedReadsBlocks();
+        const int jobsCount = numberOfThreads * JOBS_PER_THREAD;
+        assignBlocksToJobs(jobsCount, vector<uint64_t>(sortedReadsBlockPos.begin(), sortedReadsBlockPos.end()));
+        vector<uint_reads_cnt> sortedSuffixesLeftCountVector(blocksCount, 0);
+        uint_reads_cnt* sortedSuffixesLeftCount = sortedSuffixesLeftCountVector.data();
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:sortedSuffixesLeftCount[0:blocksCount])
+        for(int job = 0; job < jobsCount; job++)
+        {
+            for (uint_blocks_cnt b = jobStartBlock[job]; b < jobStartBlock[job + 1]; b++)
             {
                 sortedReadsCount[b] = sortedReadsBlockPos[b + 1] - sortedReadsBlockPos[b];
                 uchar curSymOrder = 0;
                 sortedSuffixBlockPlusSymbolPos[b][curSymOrder] = sortedReadsBlockPos[b];
                 if (sortedReadsCount[b]) {
-                    uint16_t youngestNextSuffixBlock = (b % (blocksCount / symbolsCount)) * symbolsCount;
+                    uint_blocks_cnt youngestNextSuffixBlock = (b % (blocksCount / symbolsCount)) * symbolsCount;
                     const auto &blockEnd = sortedReadsIdxs.begin() + sortedReadsBlockPos[b + 1];
-                    for (auto srIt = sortedReadsIdxs.begin() + sortedReadsBlockPos[b]; srIt != blockEnd;) {
-                        srIt++;
-                        if (srIt != blockEnd && compareReads(*(srIt - 1), *srIt) == 0) {
-                            if (avoidCyclesMode)
-                                this->setDuplicateSuccessor<true>(*(srIt - 1), *srIt, packedReadsSet->maxReadLength());
-                            else
-                                this->setDuplicateSuccessor<false>(*(srIt - 1), *srIt, packedReadsSet->maxReadLength());
-                            duplicatesCount++;
-                        } else {
-                            uchar nextSuffixSymbolOrder = getSymbolOrderFromRead(*(srIt - 1), blockPrefixLength);
-                            sortedSuffixesLeftCount[youngestNextSuffixBlock + nextSuffixSymbolOrder]++;
-                            while (curSymOrder != nextSuffixSymbolOrder)
-                                sortedSuffixBlockPlusSymbolPos[b][++curSymOrder] = (srIt - 1) - sortedReadsIdxs.begin();
-                        }
+                    for (auto srIt = sortedReadsIdxs.begin() + sortedReadsBlockPos[b]; srIt != blockEnd; srIt++) {
+                        uchar nextSuffixSymbolOrder = getSymbolOrderFromRead(*srIt, blockPrefixLength);
+                        sortedSuffixesLeftCount[youngestNextSuffixBlock + nextSuffixSymbolOrder]++;
+                        while (curSymOrder != nextSuffixSymbolOrder)
+                            sortedSuffixBlockPlusSymbolPos[b][++curSymOrder] = srIt - sortedReadsIdxs.begin();
                     }
                 }
                 while (curSymOrder < symbolsCount)
                     sortedSuffixBlockPlusSymbolPos[b][++curSymOrder] = sortedReadsBlockPos[b + 1];
             }
         }
-        this->readsLeft -= duplicatesCount;
         assert(accumulate(sortedSuffixesLeftCount, sortedSuffixesLeftCount + blocksCount, 0) == this->readsLeft);
-        cout << "Found " << (readsTotal() - this->readsLeft) << " duplicates (..." << time_millis() << " msec)" << endl;
+        // suffixes of collapsed duplicates are represented by the last read of each chain
+        prepareSuffixesBuffer(prevSortedSuffixIdxs);
+        #pragma omp parallel for schedule(static) num_threads(numberOfThreads)
+        for (int64_t j = 0; j < (int64_t) this->readsLeft; j++) {
+            uint_reads_cnt incIdx = sortedReadsIdxs[j];
+            while (this->getNextRead(incIdx))
+                incIdx = this->getNextRead(incIdx);
+            prevSortedSuffixIdxs[j] = incIdx;
+        }
         sortedSuffixIdxs.resize(this->readsLeft, 0);
-        mergeSortOfLeftSuffixes(1, sortedSuffixesLeftCount, sortedSuffixIdxs.data(), sortedReadsIdxs.data());
+        mergeSortOfLeftSuffixes(1, sortedSuffixesLeftCount, sortedSuffixIdxs.data(), prevSortedSuffixIdxs.data());
+    }
 
-        #pragma omp parallel for schedule(guided)
-        for(uint16_t b = 0; b < blocksCount; b++) {
-            if (!sortedReadsCount[b])
-                continue;
-            uint_reads_cnt i = sortedReadsBlockPos[b];
-            for (uint_reads_cnt j = i; j < sortedReadsBlockPos[b] + sortedReadsCount[b]; j++) {
-                if (j == 0 || this->nextRead[sortedReadsIdxs[j - 1]] == 0)
-                    sortedReadsIdxs[i++] = sortedReadsIdxs[j];
-            }
-            sortedReadsCount[b] = i - sortedReadsBlockPos[b];
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::setSortedSuffixBlockPos(
+            const uint_reads_cnt *sortedSuffixesLeftCount, uint_blocks_cnt curBlocksCount) {
+        sortedSuffixBlockPos[0] = 0;
+        for(uint_blocks_cnt b = 1; b <= curBlocksCount; b++)
+            sortedSuffixBlockPos[b] = sortedSuffixBlockPos[b - 1] + sortedSuffixesLeftCount[b - 1];
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::mergeBlockSuffixes(
+            uint_blocks_cnt b, uint_read_len offset, const BlockPlusSymbolPositions &srcBlockPlusSymbolPos,
+            uint_reads_cnt *sortedSuffixLeftIdxsPtr, const uint_reads_cnt *sortedSuffixIdxsPtr) {
+        uint_blocks_cnt prevYoungestBlock = b / symbolsCount;
+        uint8_t lastPrefixSymbolOrder = b % symbolsCount;
+        uint_reads_cnt ssiSymbolIdx[MAX_SYMBOLS_COUNT];
+        uint_reads_cnt ssiSymbolEnd[MAX_SYMBOLS_COUNT];
+        for (uint8_t j = 0; j < symbolsCount; j++) {
+            ssiSymbolIdx[j] = srcBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
+            [lastPrefixSymbolOrder];
+            ssiSymbolEnd[j] = srcBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
+            [lastPrefixSymbolOrder + 1];
+        }
+        deque<uchar> ssiOrder;
+        for (uint8_t j = 0; j < symbolsCount; j++) {
+            while (ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
+                   this->getNextRead(sortedSuffixIdxsPtr[ssiSymbolIdx[j]]) != 0)
+                ssiSymbolIdx[j]++;
+            updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
+        }
+        uint_reads_cnt curPos = sortedSuffixBlockPos[b];
+        while (!ssiOrder.empty()) {
+            uchar j = ssiOrder.front();
+            uint_reads_cnt sufIdx = sortedSuffixIdxsPtr[ssiSymbolIdx[j]];
+            sortedSuffixLeftIdxsPtr[curPos++] = sufIdx;
+            ssiOrder.pop_front();
+            while (++ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
+                    this->getNextRead(sortedSuffixIdxsPtr[ssiSymbolIdx[j]]) != 0);
+            updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
         }
-        assert(accumulate(sortedReadsCount, sortedReadsCount + blocksCount, 0) == this->readsLeft);
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
     void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::mergeSortOfLeftSuffixes(
             uint_read_len offset, const uint_reads_cnt *sortedSuffixesLeftCount, uint_reads_cnt *sortedSuffixLeftIdxsPtr,
             const uint_reads_cnt *sortedSuffixIdxsPtr) {
-        sortedSuffixBlockPos[0] = 0;
-        for(uint16_t b = 1; b <= blocksCount; b++)
-            sortedSuffixBlockPos[b] = sortedSuffixBlockPos[b - 1] + sortedSuffixesLeftCount[b - 1];
-
+        setSortedSuffixBlockPos(sortedSuffixesLeftCount, blocksCount);
         this->sortedSuffixIdxsPtr = sortedSuffixIdxsPtr;
         #pragma omp parallel for schedule(guided)
-        for(uint16_t b = 0; b < blocksCount; b++)
-        {
-            uint16_t prevYoungestBlock = b / symbolsCount;
-            uint8_t lastPrefixSymbolOrder = b % symbolsCount;
-            uint_reads_cnt ssiSymbolIdx[MAX_SYMBOLS_COUNT];
-            uint_reads_cnt ssiSymbolEnd[MAX_SYMBOLS_COUNT];
-            for (uint8_t j = 0; j < symbolsCount; j++) {
-                ssiSymbolIdx[j] = sortedSuffixBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
-                [lastPrefixSymbolOrder];
-                ssiSymbolEnd[j] = sortedSuffixBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
-                [lastPrefixSymbolOrder + 1];
-            }
-            deque<uchar> ssiOrder;
-            for (uint8_t j = 0; j < symbolsCount; j++) {
-                while (ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
-                       this->nextRead[sortedSuffixIdxsPtr[ssiSymbolIdx[j]]] != 0)
-                    ssiSymbolIdx[j]++;
-                updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
-            }
-            uint_reads_cnt curPos = sortedSuffixBlockPos[b];
-            while (!ssiOrder.empty()) {
-                uchar j = ssiOrder.front();
-                uint_reads_cnt sufIdx = sortedSuffixIdxsPtr[ssiSymbolIdx[j]];
-                sortedSuffixLeftIdxsPtr[curPos++] = sufIdx;
-                ssiOrder.pop_front();
-                while (++ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
-                        this->nextRead[sortedSuffixIdxsPtr[ssiSymbolIdx[j]]] != 0);
-                updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
-            }
-        }
+        for(uint_blocks_cnt b = 0; b < blocksCount; b++)
+            mergeBlockSuffixes(b, offset, sortedSuffixBlockPlusSymbolPos, sortedSuffixLeftIdxsPtr, sortedSuffixIdxsPtr);
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
-    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::findOverlappingReads(
-            double overlappedReadsCountStopCoef, bool pgGenerationMode) {
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::prepareSuffixesBuffer(
+            vector<uint_reads_cnt> &buffer) {
+        // buffer is released when reads left take only a fraction of it
+        if (buffer.capacity() > 2 * (size_t) this->readsLeft)
+            vector<uint_reads_cnt>().swap(buffer);
+        buffer.resize(this->readsLeft);
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::prepareMergeWithOverlapping(
+            const uint_reads_cnt *sortedSuffixesLeftCount) {
+        setSortedSuffixBlockPos(sortedSuffixesLeftCount, blocksCount);
+        prevSortedSuffixIdxs.swap(sortedSuffixIdxs);
+        prepareSuffixesBuffer(sortedSuffixIdxs);
+        prevSortedSuffixBlockPlusSymbolPos.swap(sortedSuffixBlockPlusSymbolPos);
+        sortedSuffixBlockPlusSymbolPos.resize(blocksCount + 1);
+    }
 
-        initAndFindDuplicates<false>();
+    template<typename uint_read_len, typename uint_reads_cnt>
+    template<bool avoidCyclesMode>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::overlapReads(
+            double overlappedReadsCountStopCoef) {
+        initAndFindDuplicates<avoidCyclesMode>();
         *logout << "Start overlapping.\n";
 
         uint_read_len overlapIterations = packedReadsSet->maxReadLength() * overlappedReadsCountStopCoef;
-        uint16_t curBlocksCount = blocksCount;
+        uint_blocks_cnt curBlocksCount = blocksCount;
         for (int i = 1; i < overlapIterations; i++) {
             if (i < packedReadsSet->maxReadLength() - blockPrefixLength) {
-                uint_reads_cnt sortedSuffixesLeftCount[MAX_BLOCKS_COUNT] = {0};
-                overlapSortedReadsAndSuffixes<false>(i, sortedSuffixesLeftCount);
-                vector<uint_reads_cnt> sortedSuffixLeft(this->readsLeft, 0);
-                mergeSortOfLeftSuffixes(i + 1, sortedSuffixesLeftCount, sortedSuffixLeft.data(),
-                                        sortedSuffixIdxs.data());
-                sortedSuffixIdxs.swap(sortedSuffixLeft);
+                vector<uint_reads_cnt> sortedSuffixesLeftCount(blocksCount, 0);
+                // suffixes of the first offset are merged during initialization
+                overlapSortedReadsAndSuffixes<avoidCyclesMode>(i, sortedSuffixesLeftCount.data(), i > 1);
+                if (i + 1 < packedReadsSet->maxReadLength() - blockPrefixLength) {
+                    // suffixes of each block are merged within the next overlapping pass
+                    prepareMergeWithOverlapping(sortedSuffixesLeftCount.data());
+                } else {
+                    prepareSuffixesBuffer(prevSortedSuffixIdxs);
+                    mergeSortOfLeftSuffixes(i + 1, sortedSuffixesLeftCount.data(), prevSortedSuffixIdxs.data(),
+                                            sortedSuffixIdxs.data());
+                    sortedSuffixIdxs.swap(prevSortedSuffixIdxs);
+                }
             } else {
-                blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge<false>(i, curBlocksCount);
+                blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge<avoidCyclesMode>(i, curBlocksCount);
                 curBlocksCount /= symbolsCount;
             }
 
             *logout << this->readsLeft << " reads left after "
                     << (uint_read_len_max) (packedReadsSet->maxReadLength() - i) << " overlap (..." << time_millis() << ") msec" << endl;
         }
+    }
+
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::findOverlappingReads(
+            double overlappedReadsCountStopCoef, bool pgGenerationMode) {
+
+        // reverse complement overlaps are applied symmetrically, so all overlaps have to be verified
+        if (revComplMode)
+            overlapReads<true>(overlappedReadsCountStopCoef);
+        else
+            overlapReads<false>(overlappedReadsCountStopCoef);
 
         sortedReadsIdxs.clear();
         sortedReadsIdxs.shrink_to_fit();
         sortedSuffixIdxs.clear();
         sortedSuffixIdxs.shrink_to_fit();
+        prevSortedSuffixIdxs.clear();
+        prevSortedSuffixIdxs.shrink_to_fit();
 
         if (pgGenerationMode) {
             this->removeCyclesAndPrepareComponents();
@@ -286,33 +618,36 @@ namespace PgSAIndex {
     template<typename uint_read_len, typename uint_reads_cnt>
     template<bool avoidCyclesMode>
     void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::
-            overlapSortedReadsAndSuffixes(uint_read_len suffixesOffset, uint_reads_cnt *sortedSuffixesLeftCount) {
-        uint8_t threadsInIteration = suffixesOffset<25?2:(suffixesOffset<40?4:numberOfThreads);
+            overlapSortedReadsAndSuffixes(uint_read_len suffixesOffset, uint_reads_cnt *sortedSuffixesLeftCount,
+                    bool mergeSuffixes) {
+        int threadsInIteration = suffixesOffset<25?2:(suffixesOffset<40?4:numberOfThreads);
         if (!avoidCyclesMode || threadsInIteration > numberOfThreads)
             threadsInIteration = numberOfThreads;
 
-        uint16_t b = 0;
-        uint_reads_cnt readsAndSuffixesCount = 0;
-        threadStartBlock[UINT8_MAX] = 0;
-        for(uint8_t t = 1; t <= threadsInIteration; t++) {
-            uint_reads_cnt threshold = ((double) t / threadsInIteration) * this->readsLeft * 2;
-            while (readsAndSuffixesCount < threshold) {
-                readsAndSuffixesCount += sortedReadsCount[b] + sortedSuffixBlockPos[b + 1] - sortedSuffixBlockPos[b];
-                b++;
-            }
-            threadStartBlock[t] = b;
-        }
-        threadStartBlock[numberOfThreads] = blocksCount;
+        // blocks are rebalanced for every offset according to the current reads and suffixes counts
+        vector<uint64_t> cumulativeBlockLoad(blocksCount + 1, 0);
+        for(uint_blocks_cnt b = 0; b < blocksCount; b++)
+            cumulativeBlockLoad[b + 1] = cumulativeBlockLoad[b] + sortedReadsCount[b] +
+                    sortedSuffixBlockPos[b + 1] - sortedSuffixBlockPos[b];
+        const int jobsCount = threadsInIteration * JOBS_PER_THREAD;
+        assignBlocksToJobs(jobsCount, cumulativeBlockLoad);
+        if (mergeSuffixes)
+            this->sortedSuffixIdxsPtr = prevSortedSuffixIdxs.data();
+        if (avoidCyclesMode)
+            threadOverlapCandidates.resize(threadsInIteration);
         uint_reads_cnt overlapsCount = 0;
-#pragma omp parallel for reduction(+:sortedSuffixesLeftCount[0:MAX_BLOCKS_COUNT]) num_threads(threadsInIteration) \
-                        reduction(+:overlapsCount)
-        for(uint8_t t = 0; t < threadsInIteration; t++)
+#pragma omp parallel for schedule(dynamic, 1) reduction(+:sortedSuffixesLeftCount[0:blocksCount]) \
+                        num_threads(threadsInIteration) reduction(+:overlapsCount)
+        for(int job = 0; job < jobsCount; job++)
         {
-            for (uint16_t b = threadStartBlock[t]; b < threadStartBlock[t + 1]; b++)
+            for (uint_blocks_cnt b = jobStartBlock[job]; b < jobStartBlock[job + 1]; b++)
             {
+                if (mergeSuffixes)
+                    mergeBlockSuffixes(b, suffixesOffset, prevSortedSuffixBlockPlusSymbolPos, sortedSuffixIdxs.data(),
+                                       prevSortedSuffixIdxs.data());
                 uchar curSymOrder = 0;
                 sortedSuffixBlockPlusSymbolPos[b][curSymOrder] = sortedSuffixBlockPos[b];
-                uint16_t youngestNextSuffixBlock = (b % (blocksCount / symbolsCount)) * symbolsCount;
+                uint_blocks_cnt youngestNextSuffixBlock = (b % (blocksCount / symbolsCount)) * symbolsCount;
                 auto preIt = sortedReadsIdxs.begin() + sortedReadsBlockPos[b];
                 auto sufIt = sortedSuffixIdxs.begin() + sortedSuffixBlockPos[b];
                 const auto &preEnd = preIt + sortedReadsCount[b];
@@ -327,7 +662,7 @@ namespace PgSAIndex {
                         while (preIt != preEnd) {
                             if ((cmpRes = compareSuffixWithPrefix(*sufIt, *preIt, suffixesOffset)) != 0)
                                 break;
-                            if ((*sufIt != *preIt) && (!avoidCyclesMode || !this->isHeadOf(*sufIt, *preIt)))
+                            if (isOverlapAllowed<avoidCyclesMode>(*sufIt, *preIt))
                                 break;
                             cmpRes = -1;
                             preIt++;
@@ -344,21 +679,7 @@ namespace PgSAIndex {
                             *preIt = preIdx;
                         }
 
-                        if (cmpRes == 0) {
-                            if (avoidCyclesMode) {
-                                bool cycleCheck = false;
-#pragma omp critical
-                                {
-                                    if (!(cycleCheck = this->isHeadOf(*sufIt, *preIt))) {
-                                        if (this->headRead[*sufIt] == 0)
-                                            this->headRead[*preIt] = *sufIt;
-                                        else
-                                            this->headRead[*preIt] = this->headRead[*sufIt];
-                                    }
-                                }
-                                if (cycleCheck)
-                                    continue;
-                            }
+                        if (cmpRes == 0 && !avoidCyclesMode) {
                             this->setReadSuccessor(*sufIt, *preIt,
                                                        packedReadsSet->maxReadLength() - suffixesOffset);
                             overlapsCount++;
@@ -369,6 +690,12 @@ namespace PgSAIndex {
                         } else {
                             uchar nextSuffixSymbolOrder = getSymbolOrderFromRead(*sufIt, suffixesOffset +
                                                                                          blockPrefixLength);
+                            if (cmpRes == 0) {
+                                // both reads are kept until the candidate is verified
+                                threadOverlapCandidates[omp_get_thread_num()].push_back(
+                                        { *sufIt, *preIt, youngestNextSuffixBlock + nextSuffixSymbolOrder });
+                                sortedReadsIdxs[sortedReadsBlockPos[b] + sortedReadsCount[b]++] = (*(preIt++));
+                            }
                             sortedSuffixesLeftCount[youngestNextSuffixBlock + nextSuffixSymbolOrder]++;
                             while (curSymOrder != nextSuffixSymbolOrder)
                                 sortedSuffixBlockPlusSymbolPos[b][++curSymOrder] = sufIt - sortedSuffixIdxs.begin();
@@ -381,19 +708,70 @@ namespace PgSAIndex {
             }
         }
         this->readsLeft -= overlapsCount;
+        if (avoidCyclesMode)
+            this->readsLeft -= resolveOverlapCandidates(packedReadsSet->maxReadLength() - suffixesOffset,
+                    sortedSuffixesLeftCount, blocksCount);
         assert(accumulate(sortedSuffixesLeftCount, sortedSuffixesLeftCount + blocksCount, 0) == this->readsLeft);
     }
 
+    template<typename uint_read_len, typename uint_reads_cnt>
+    uint_reads_cnt ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::resolveOverlapCandidates(
+            uint_read_len overlapLength, uint_reads_cnt *sortedSuffixesLeftCount, uint_blocks_cnt curBlocksCount) {
+        uint_reads_cnt overlapsCount = 0;
+        const uint_read_len rcSufNextOffset = packedReadsSet->maxReadLength() - overlapLength + 1;
+        const uint8_t rcSufNextBlockLength = min<uint_read_len>(blockPrefixLength, overlapLength - 1);
+        for (vector<OverlapCandidate> &candidates: threadOverlapCandidates) {
+            for (const OverlapCandidate &c: candidates) {
+                // reads of candidates can be already overlapped by reverse complement counterparts of other overlaps
+                if (revComplMode && (this->getNextRead(c.sufIncIdx) || this->headRead[c.preIncIdx]))
+                    continue;
+                if (this->isHeadOf(c.sufIncIdx, c.preIncIdx))
+                    continue;
+                this->headRead[c.preIncIdx] = this->headRead[c.sufIncIdx] == 0 ? c.sufIncIdx : this->headRead[c.sufIncIdx];
+                this->setReadSuccessor(c.sufIncIdx, c.preIncIdx, overlapLength);
+                sortedSuffixesLeftCount[c.sufLeftBlock]--;
+                overlapsCount++;
+                if (revComplMode) {
+                    const uint_reads_cnt rcSufIncIdx = getRevComplIdx(c.preIncIdx);
+                    const uint_reads_cnt rcPreIncIdx = getRevComplIdx(c.sufIncIdx);
+                    this->headRead[rcPreIncIdx] = this->headRead[rcSufIncIdx] == 0 ? rcSufIncIdx : this->headRead[rcSufIncIdx];
+                    this->setReadSuccessor(rcSufIncIdx, rcPreIncIdx, overlapLength);
+                    sortedSuffixesLeftCount[getSuffixBlock(rcSufIncIdx, rcSufNextOffset, rcSufNextBlockLength)]--;
+                    overlapsCount++;
+                }
+            }
+            candidates.clear();
+        }
+        if (overlapsCount == 0)
+            return 0;
+        // overlapped suffixes are skipped while merging, but overlapped prefixes have to be removed
+        #pragma omp parallel for schedule(guided)
+        for (uint_blocks_cnt b = 0; b < curBlocksCount; b++) {
+            uint_reads_cnt* blockIdxs = sortedReadsIdxs.data() + sortedReadsBlockPos[b];
+            uint_reads_cnt count = 0;
+            for (uint_reads_cnt i = 0; i < sortedReadsCount[b]; i++)
+                if (this->headRead[blockIdxs[i]] == 0)
+                    blockIdxs[count++] = blockIdxs[i];
+            sortedReadsCount[b] = count;
+        }
+        return overlapsCount;
+    }
+
     template<typename uint_read_len, typename uint_reads_cnt>
     template<bool avoidCyclesMode>
     void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::
-    blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge(uint_read_len suffixesOffset, uint16_t curBlocksCount) {
-        uint_reads_cnt sortedSuffixesLeftCount[MAX_BLOCKS_COUNT] = {0};
+    blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge(uint_read_len suffixesOffset, uint_blocks_cnt curBlocksCount) {
+        const uint_blocks_cnt nextBlocksCount = curBlocksCount / symbolsCount;
+        vector<uint_reads_cnt> sortedSuffixesLeftCountVector(nextBlocksCount > 0 ? nextBlocksCount : 1, 0);
+        uint_reads_cnt* sortedSuffixesLeftCount = sortedSuffixesLeftCountVector.data();
+        if (avoidCyclesMode)
+            threadOverlapCandidates.resize(omp_get_max_threads());
         uint_reads_cnt overlapsCount = 0;
-#pragma omp parallel for schedule(guided) reduction(+:sortedSuffixesLeftCount[0:MAX_BLOCKS_COUNT]) reduction(+:overlapsCount)
-        for (uint16_t b = 0; b < curBlocksCount; b++)
+#pragma omp parallel for schedule(guided) reduction(+:sortedSuffixesLeftCount[0:sortedSuffixesLeftCountVector.size()]) \
+                        reduction(+:overlapsCount)
+        for (uint_blocks_cnt b = 0; b < curBlocksCount; b++)
         {
-            uint16_t nextSuffixBlock = (b % (curBlocksCount / symbolsCount));
+            uint_blocks_cnt nextSuffixBlock = (b % (curBlocksCount / symbolsCount));
             auto preIt = sortedReadsIdxs.begin() + sortedReadsBlockPos[b];
             auto sufIt = sortedSuffixIdxs.begin() + sortedSuffixBlockPos[b];
             const auto &preEnd = preIt + sortedReadsCount[b];
@@ -407,7 +785,7 @@ namespace PgSAIndex {
                     auto curPreIt = preIt;
                     while (preIt != preEnd) {
                         cmpRes = 0;
-                        if ((*sufIt != *preIt) && (!avoidCyclesMode || !this->isHeadOf(*sufIt, *preIt)))
+                        if (isOverlapAllowed<avoidCyclesMode>(*sufIt, *preIt))
                             break;
                         cmpRes = -1;
                         preIt++;
@@ -424,26 +802,16 @@ namespace PgSAIndex {
                         *preIt = preIdx;
                     }
 
-                    if (cmpRes == 0) {
-                        if (avoidCyclesMode) {
-                            bool cycleCheck = false;
-#pragma omp critical
-                            {
-                                if (!(cycleCheck = this->isHeadOf(*sufIt, *preIt))) {
-                                    if (this->headRead[*sufIt] == 0)
-                                        this->headRead[*preIt] = *sufIt;
-                                    else
-                                        this->headRead[*preIt] = this->headRead[*sufIt];
-                                }
-                            }
-                            if (cycleCheck)
-                                continue;
-                        }
+                    if (cmpRes == 0 && !avoidCyclesMode) {
                         this->setReadSuccessor(*sufIt, *preIt,
                                                packedReadsSet->maxReadLength() - suffixesOffset);
                         overlapsCount++;
                         preIt++;
                     } else {
+                        if (cmpRes == 0) {
+                            threadOverlapCandidates[omp_get_thread_num()].push_back({ *sufIt, *preIt, nextSuffixBlock });
+                            sortedReadsIdxs[sortedReadsBlockPos[b] + sortedReadsCount[b]++] = (*(preIt++));
+                        }
                         sortedSuffixesLeftCount[nextSuffixBlock]++;
                     }
                     sufIt++;
@@ -451,12 +819,15 @@ namespace PgSAIndex {
             }
         }
         this->readsLeft -= overlapsCount;
+        if (avoidCyclesMode)
+            this->readsLeft -= resolveOverlapCandidates(packedReadsSet->maxReadLength() - suffixesOffset,
+                    sortedSuffixesLeftCount, curBlocksCount);
         assert(accumulate(sortedSuffixesLeftCount, sortedSuffixesLeftCount + (curBlocksCount / symbolsCount), 0) == this->readsLeft);
 
         if (curBlocksCount > symbolsCount) {
 #pragma omp parallel for schedule(guided)
-            for (uint16_t b = 0; b < curBlocksCount / symbolsCount; b++) {
-                const uint16_t rootBlock = b * symbolsCount;
+            for (uint_blocks_cnt b = 0; b < curBlocksCount / symbolsCount; b++) {
+                const uint_blocks_cnt rootBlock = b * symbolsCount;
                 auto srIt = sortedReadsIdxs.begin() + sortedReadsBlockPos[rootBlock] + sortedReadsCount[rootBlock];
                 for (uint8_t b2 = 1; b2 < symbolsCount; b2++) {
                     auto it = sortedReadsIdxs.begin() + sortedReadsBlockPos[rootBlock + b2];
@@ -466,32 +837,30 @@ namespace PgSAIndex {
                 }
                 sortedReadsCount[rootBlock] = srIt - (sortedReadsIdxs.begin() + sortedReadsBlockPos[rootBlock]);
             }
-            for (uint16_t b = 1; b < curBlocksCount / symbolsCount; b++) {
-                const uint16_t prevBlock = b * symbolsCount;
+            for (uint_blocks_cnt b = 1; b < curBlocksCount / symbolsCount; b++) {
+                const uint_blocks_cnt prevBlock = b * symbolsCount;
                 sortedReadsBlockPos[b] = sortedReadsBlockPos[prevBlock];
                 sortedReadsCount[b] = sortedReadsCount[prevBlock];
             }
-            for(uint16_t b = 0; b <= curBlocksCount; b++)
+            for(uint_blocks_cnt b = 0; b <= curBlocksCount; b++)
                 sortedSuffixBlockPlusSymbolPos[b][0] = sortedSuffixBlockPos[b];
-            sortedSuffixBlockPos[0] = 0;
-            for(uint16_t b = 1; b <= curBlocksCount / symbolsCount; b++)
-                sortedSuffixBlockPos[b] = sortedSuffixBlockPos[b - 1] + sortedSuffixesLeftCount[b - 1];
+            setSortedSuffixBlockPos(sortedSuffixesLeftCount, curBlocksCount / symbolsCount);
 
-            vector<uint_reads_cnt> sortedSuffixLeft(this->readsLeft, 0);
+            prepareSuffixesBuffer(prevSortedSuffixIdxs);
 #pragma omp parallel for schedule(guided)
-            for (uint16_t b = 0; b < curBlocksCount / symbolsCount; b++) {
-                auto leftIt = sortedSuffixLeft.begin() + sortedSuffixBlockPos[b];
-                for (uint16_t b2 = b; b2 < curBlocksCount; b2 += (curBlocksCount / symbolsCount)) {
+            for (uint_blocks_cnt b = 0; b < curBlocksCount / symbolsCount; b++) {
+                auto leftIt = prevSortedSuffixIdxs.begin() + sortedSuffixBlockPos[b];
+                for (uint_blocks_cnt b2 = b; b2 < curBlocksCount; b2 += (curBlocksCount / symbolsCount)) {
                     auto it = sortedSuffixIdxs.begin() + sortedSuffixBlockPlusSymbolPos[b2][0];
                     const auto &endIt = sortedSuffixIdxs.begin() + sortedSuffixBlockPlusSymbolPos[b2 + 1][0];
                     while (it != endIt) {
-                        if (this->nextRead[*it] == 0)
+                        if (this->getNextRead(*it) == 0)
                             *(leftIt++) = *it;
                         it++;
                     }
                 }
             }
-            sortedSuffixIdxs.swap(sortedSuffixLeft);
+            sortedSuffixIdxs.swap(prevSortedSuffixIdxs);
         }
     }
 
@@ -513,18 +882,18 @@ namespace PgSAIndex {
 
     template<typename uint_read_len, typename uint_reads_cnt>
     PseudoGenomeGeneratorBase* ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::getGeneratorFullTemplate(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet) {
-        return new ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>(readsSet, ownReadsSet);
+        return new ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>(readsSet, ownReadsSet,
+                revComplMode);
     }
 
     template<typename uint_read_len>
     PseudoGenomeGeneratorBase* ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::getGeneratorPartialTemplate(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet) {
 
-        if (isReadsCountStd(readsSet->readsCount()))
+        // reverse complements of reads are indexed after the reads
+        if (isReadsCountStd((revComplMode ? 2 : 1) * (uint_max) readsSet->readsCount()))
             return getGeneratorFullTemplate<uint_read_len, uint_reads_cnt_std>(readsSet, ownReadsSet);
         else
-            cout << "UNSUPPORTED READS COUNT!!!???";
-
-        return 0;
+            return getGeneratorFullTemplate<uint_read_len, uint_reads_cnt_max>(readsSet, ownReadsSet);
     }
 
     PseudoGenomeGeneratorBase* ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::getGenerator(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIterator) {
@@ -579,8 +948,9 @@ namespace PgSAIndex {
     }
 
     SeparatedPseudoGenome* ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::generateSeparatedPg(
-            PackedConstantLengthReadsSet *readsSet) {
-        ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory* pggf = new ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory();
+            PackedConstantLengthReadsSet *readsSet, bool revComplMode) {
+        ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory* pggf =
+                new ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory(revComplMode);
         PseudoGenomeGeneratorBase* pggb = pggf->getGenerator(readsSet, false);
         SeparatedPseudoGenome* pg = pggb->generateSeparatedPseudoGenome();
         delete(pggb);
@@ -606,8 +976,9 @@ namespace PgSAIndex {
     }
 
     const vector<bool> ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::getHQReads(
-            PackedConstantLengthReadsSet *readsSet, double qualityCoef) {
-        ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory* pggf = new ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory();
+            PackedConstantLengthReadsSet *readsSet, double qualityCoef, bool revComplMode) {
+        ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory* pggf =
+                new ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory(revComplMode);
         PseudoGenomeGeneratorBase* pggb = pggf->getGenerator(readsSet, false);
         const vector<bool> res = pggb->getBothSidesOverlappedReads(qualityCoef);
         delete(pggb);
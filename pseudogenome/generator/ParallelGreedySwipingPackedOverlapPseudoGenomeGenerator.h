@@ -6,11 +6,18 @@
 #include "../../readsset/PackedConstantLengthReadsSet.h"
 #include <algorithm>
 #include <deque>
+#include <array>
 
-#define MAX_BLOCK_PREFIX_LENGTH 4
+#define MIN_BLOCK_PREFIX_LENGTH 3
+#define MAX_BLOCK_PREFIX_LENGTH 8
 #define MAX_SYMBOLS_COUNT 5
-#define MAX_BLOCKS_COUNT 625 // MAX_SYMBOLS_COUNT^MAX_BLOCK_PREFIX_LENGTH
+#define BLOCKS_PER_THREAD 16
+#define JOBS_PER_THREAD 4
+#define MIN_READS_PER_BLOCK 64
 #define PARALLEL_PG_GENERATION_READS_COUNT_THRESHOLD 50000
+#define MIN_HASH_BUCKET_BITS 8
+#define MAX_HASH_BUCKET_BITS 20
+#define READS_PER_HASH_BUCKET 256
 
 using namespace PgSAReadsSet;
 
@@ -22,24 +29,42 @@ namespace PgSAIndex {
     private:
 
         bool ownReadsSet = false;
+        PackedConstantLengthReadsSet* orgReadsSet = 0;
+        // in reverse complement mode reads are followed by their reverse complements
+        bool revComplMode = false;
         PackedConstantLengthReadsSet* packedReadsSet = 0;
         const uint_symbols_cnt symbolsCount;
 
         vector<uint_reads_cnt> sortedReadsIdxs;
         vector<uint_reads_cnt> sortedSuffixIdxs;
+        // merge source (suffixes left after the previous offset) or spare buffer for merge results
+        vector<uint_reads_cnt> prevSortedSuffixIdxs;
         const uint_reads_cnt* sortedSuffixIdxsPtr;
 
-        const uint8_t blockPrefixLength = 3;
-        char blockPrefixes[MAX_BLOCKS_COUNT][MAX_SYMBOLS_COUNT] = { 0 };
-        uint16_t blocksCount;
+        typedef uint32_t uint_blocks_cnt;
 
-        uint_reads_cnt sortedReadsBlockPos[MAX_BLOCKS_COUNT + 1];
-        uint_reads_cnt sortedReadsCount[MAX_BLOCKS_COUNT] = { 0 };
+        // reads are partitioned into blocks by prefix symbols (prefix length adapted to threads and reads count)
+        uint8_t blockPrefixLength;
+        uint_blocks_cnt blocksCount;
 
-        uint_reads_cnt sortedSuffixBlockPlusSymbolPos[MAX_BLOCKS_COUNT + 1][MAX_SYMBOLS_COUNT + 1];
-        uint_reads_cnt sortedSuffixBlockPos[MAX_BLOCKS_COUNT + 1];
+        vector<uint_reads_cnt> sortedReadsBlockPos;
+        vector<uint_reads_cnt> sortedReadsCount;
 
-        uint16_t threadStartBlock[UINT8_MAX] = { 0 };
+        typedef vector<array<uint_reads_cnt, MAX_SYMBOLS_COUNT + 1>> BlockPlusSymbolPositions;
+        BlockPlusSymbolPositions sortedSuffixBlockPlusSymbolPos;
+        BlockPlusSymbolPositions prevSortedSuffixBlockPlusSymbolPos;
+        vector<uint_reads_cnt> sortedSuffixBlockPos;
+
+        // contiguous ranges of blocks processed as single (dynamically scheduled) jobs
+        vector<uint_blocks_cnt> jobStartBlock;
+
+        // overlaps found in cycles aware mode are verified after each pass
+        struct OverlapCandidate {
+            uint_reads_cnt sufIncIdx;
+            uint_reads_cnt preIncIdx;
+            uint_blocks_cnt sufLeftBlock;
+        };
+        vector<vector<OverlapCandidate>> threadOverlapCandidates;
 
         struct PackedReadsComparator {
             ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* myGenerator;
@@ -50,24 +75,16 @@ namespace PgSAIndex {
             }
         };
 
-        struct PackedReadVsPatternComparator {
-            const uint_reads_cnt PATTERN_INDEX = -1;
-
-            ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* myGenerator;
-            char* pattern;
-            int patLength;
-            PackedReadVsPatternComparator(ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* generator,
-                    char* pattern) : myGenerator(generator), pattern(pattern), patLength(strlen(pattern)) {};
-
-            bool operator() (uint_reads_cnt lIncIdx, uint_reads_cnt rIncIdx) const {
-                if (lIncIdx == PATTERN_INDEX)
-                    return myGenerator->packedReadsSet->compareReadWithPattern(rIncIdx - 1, pattern, patLength) >= 0;
-                else if (rIncIdx == PATTERN_INDEX)
-                    return myGenerator->packedReadsSet->compareReadWithPattern(lIncIdx - 1, pattern, patLength) < 0;
-                return myGenerator->compareReads(lIncIdx, rIncIdx) < 0;
-            }
+        // symbols following the block prefix cached next to the read index (MSB aligned)
+        struct ReadKey {
+            uint64_t key;
+            uint_reads_cnt incIdx;
         };
 
+        static const size_t RADIX_SORT_SMALL_BUCKET_SIZE = 64;
+        uint8_t keySymbolBits;
+        uint8_t keySymbolsCount;
+
         int compareReads(uint_reads_cnt lIncIdx, uint_reads_cnt rIncIdx);
 
         uchar getSymbolOrderFromRead(uint_reads_cnt incIdx, uint_read_len offset);
@@ -85,22 +102,58 @@ namespace PgSAIndex {
 
         virtual ReadsSetProperties* getReadsSetProperties() override;
 
-        bool isGenerationCyclesAware(bool pgGenerationMode) { return false; };
-
+        bool isGenerationCyclesAware(bool pgGenerationMode) { return revComplMode; };
+        bool isRevComplGeneration() override { return revComplMode; };
+
+        inline uint_reads_cnt getRevComplIdx(uint_reads_cnt incIdx) {
+            const uint_reads_cnt orgReadsCount = packedReadsSet->readsCount() / 2;
+            return incIdx > orgReadsCount ? incIdx - orgReadsCount : incIdx + orgReadsCount;
+        }
+        template<bool avoidCyclesMode>
+        inline bool isOverlapAllowed(uint_reads_cnt sufIncIdx, uint_reads_cnt preIncIdx);
+        // duplicates of a read are oriented as the one of lower hash (forward in case of equal hashes)
+        uint64_t getOrientedReadHash(uint_reads_cnt incIdx, uint_reads_cnt &orientedIncIdx);
+
+        // stable counting sort of reads (given by srcIdxs or all reads if srcIdxs is null) by keys less than keysCount
+        template<typename KeyFunction>
+        void distributeReads(const uint_reads_cnt *srcIdxs, uint_reads_cnt n, KeyFunction getKey, uint32_t keysCount,
+                uint_reads_cnt *keyPos, vector<uint_reads_cnt> &destIdxs);
+        // chains identical reads (grouped by hashes) and stores heads of chains in sortedReadsIdxs
+        template<bool pgGenerationMode>
+        void collapseDuplicates();
         template<bool pgGenerationMode>
         void initAndFindDuplicates();
+        void initBlocks();
+        // splits blocks into contiguous ranges of similar load (cumulativeBlockLoad[b] is the load of blocks before b)
+        void assignBlocksToJobs(int jobsCount, const vector<uint64_t> &cumulativeBlockLoad);
+        uint_blocks_cnt getReadBlock(uint_reads_cnt incIdx);
+        uint_blocks_cnt getSuffixBlock(uint_reads_cnt incIdx, uint_read_len pos, uint8_t length);
+        uint64_t getReadKey(uint_reads_cnt incIdx);
+        static void radixSortReadKeys(ReadKey* keys, ReadKey* tmp, size_t n, int shift);
+        void sortReadsBlock(uint_blocks_cnt b);
         void prepareSortedReadsBlocks();
+        void setSortedSuffixBlockPos(const uint_reads_cnt *sortedSuffixesLeftCount, uint_blocks_cnt curBlocksCount);
+        void mergeBlockSuffixes(uint_blocks_cnt b, uint_read_len offset, const BlockPlusSymbolPositions &srcBlockPlusSymbolPos,
+                uint_reads_cnt *sortedSuffixLeftIdxsPtr, const uint_reads_cnt *sortedSuffixIdxsPtr);
         void mergeSortOfLeftSuffixes(uint_read_len offset, const uint_reads_cnt *sortedSuffixesLeftCount,
                 uint_reads_cnt *sortedSuffixLeftIdxsPtr, const uint_reads_cnt *sortedSuffixIdxsPtr);
+        void prepareSuffixesBuffer(vector<uint_reads_cnt> &buffer);
+        void prepareMergeWithOverlapping(const uint_reads_cnt *sortedSuffixesLeftCount);
 
         template<bool pgGenerationMode>
-        void overlapSortedReadsAndSuffixes(uint_read_len suffixesOffset, uint_reads_cnt *sortedSuffixesLeftCount);
+        void overlapSortedReadsAndSuffixes(uint_read_len suffixesOffset, uint_reads_cnt *sortedSuffixesLeftCount,
+                bool mergeSuffixes);
+        uint_reads_cnt resolveOverlapCandidates(uint_read_len overlapLength, uint_reads_cnt *sortedSuffixesLeftCount,
+                uint_blocks_cnt curBlocksCount);
         template<bool pgGenerationMode>
         void blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge(uint_read_len suffixesOffset,
-                                                                          uint16_t curBlocksCount);
+                                                                          uint_blocks_cnt curBlocksCount);
 
         void validateSortedSuffixes(uint_read_len offset) const;
 
+        template<bool avoidCyclesMode>
+        void overlapReads(double overlappedReadsCountStopCoef);
+
         void findOverlappingReads(double overlappedReadsCountStopCoef, bool pgGenerationMode) override;
 
     protected:
@@ -109,7 +162,8 @@ namespace PgSAIndex {
 
     public:
 
-        ParallelGreedySwipingPackedOverlapGeneratorTemplate(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet = false);
+        ParallelGreedySwipingPackedOverlapGeneratorTemplate(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet = false,
+                bool revComplMode = false);
         virtual ~ParallelGreedySwipingPackedOverlapGeneratorTemplate();
 
         bool isPseudoGenomeLengthStandardVirtual();
@@ -121,6 +175,8 @@ namespace PgSAIndex {
     {
     private:
 
+        bool revComplMode;
+
         template<typename uint_read_len, typename uint_reads_cnt>
         PseudoGenomeGeneratorBase* getGeneratorFullTemplate(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet);
 
@@ -129,18 +185,20 @@ namespace PgSAIndex {
 
     public:
 
-        ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory() {};
+        ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory(bool revComplMode = false)
+            : revComplMode(revComplMode) {};
 
         PseudoGenomeGeneratorBase* getGenerator(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIterator);
         PseudoGenomeGeneratorBase* getGenerator(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet);
 
         static PseudoGenomeBase* generatePg(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIterator);
         static PseudoGenomeBase* generatePg(PackedConstantLengthReadsSet *readsSet);
-        static SeparatedPseudoGenome* generateSeparatedPg(PackedConstantLengthReadsSet *readsSet);
+        static SeparatedPseudoGenome* generateSeparatedPg(PackedConstantLengthReadsSet *readsSet,
+                                                          bool revComplMode = false);
         static const vector<bool> getHQReads(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIterator,
                                              double qualityCoef);
         static const vector<bool> getHQReads(PackedConstantLengthReadsSet *readsSet,
-                                             double qualityCoef);
+                                             double qualityCoef, bool revComplMode = false);
     };
 
 }
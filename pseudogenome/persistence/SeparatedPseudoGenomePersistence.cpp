@@ -19,8 +19,8 @@ namespace PgTools {
     void SeparatedPseudoGenomePersistence::writeSeparatedPseudoGenome(SeparatedPseudoGenome *sPg,
             const string &pseudoGenomePrefix, bool skipPgSequence) {
         time_checkpoint();
-        SeparatedPseudoGenomeOutputBuilder builder(sPg->getReadsList()->isRevCompEnabled(),
-                sPg->getReadsList()->areMismatchesEnabled());
+        SeparatedPseudoGenomeOutputBuilder builder(!sPg->getReadsList()->isRevCompEnabled(),
+                !sPg->getReadsList()->areMismatchesEnabled());
         builder.feedSeparatedPseudoGenome(sPg, skipPgSequence);
         builder.build(pseudoGenomePrefix);
         cout << "Writing (" << pseudoGenomePrefix << ") pseudo genome files in " << time_millis() << " msec." << endl << endl;
@@ -150,7 +150,7 @@ namespace PgTools {
     bool SeparatedPseudoGenomePersistence::enableReadPositionRepresentation = false;
     bool SeparatedPseudoGenomePersistence::enableRevOffsetMismatchesRepresentation = true;
 
-    void SeparatedPseudoGenomePersistence::appendIndexesFromPg(string pgFilePrefix, vector<uint_reads_cnt_std> &idxs) {
+    void SeparatedPseudoGenomePersistence::appendIndexesFromPg(string pgFilePrefix, ReadsIndexValues &idxs) {
         bool plainTextReadMode;
         PseudoGenomeHeader* pgh;
         ReadsSetProperties* rsProp;
@@ -158,9 +158,9 @@ namespace PgTools {
         ifstream orgIdxsSrc = getPseudoGenomeElementSrc(pgFilePrefix, SeparatedPseudoGenomeBase::READSLIST_ORIGINAL_INDEXES_FILE_SUFFIX);
         const uint_reads_cnt_max readsCount = pgh->getReadsCount();
         idxs.reserve(idxs.size() + readsCount);
-        for(uint_reads_cnt_std i = 0; i < readsCount; i++) {
-            uint_reads_cnt_std idx;
-            readValue<uint_reads_cnt_std>(orgIdxsSrc, idx, plainTextReadMode);
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
+            uint_reads_cnt_max idx;
+            readValue<uint_reads_cnt_max>(orgIdxsSrc, idx, plainTextReadMode);
             idxs.push_back(idx);
         }
         delete(pgh);
@@ -168,27 +168,29 @@ namespace PgTools {
     }
 
     void SeparatedPseudoGenomePersistence::writePairMapping(string &pgFilePrefix,
-                                                            vector<uint_reads_cnt_std> orgIdxs) {
+                                                            const ReadsIndexValues &orgIdxs) {
         ofstream pair1OffsetsDest = getPseudoGenomeElementDest(pgFilePrefix, SeparatedPseudoGenomeBase::READSLIST_PAIR_FIRST_OFFSETS_FILE_SUFFIX, true);
         ofstream pair1SrcFlagDest = getPseudoGenomeElementDest(pgFilePrefix, SeparatedPseudoGenomeBase::READSLIST_PAIR_FIRST_SOURCE_FLAG_FILE_SUFFIX, true);
         ofstream pair1IndexesDest = getPseudoGenomeElementDest(pgFilePrefix, SeparatedPseudoGenomeBase::READSLIST_PAIR_FIRST_INDEXES_FILE_SUFFIX, true);
         writeReadMode(pair1OffsetsDest, PgSAHelpers::plainTextWriteMode);
         writeReadMode(pair1IndexesDest, PgSAHelpers::plainTextWriteMode);
-        uint_reads_cnt_std readsCount = orgIdxs.size();
-        vector<uint_reads_cnt_std> rev(readsCount);
-        for(uint_reads_cnt_std i = 0; i < readsCount; i++)
-            rev[orgIdxs[i]] = i;
+        uint_reads_cnt_max readsCount = orgIdxs.size();
+        const bool stdIdxs = isReadsCountStd(readsCount);
+        ReadsIndexValues rev(readsCount);
+        rev.resize(readsCount);
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++)
+            rev.set(orgIdxs[i], i);
         vector<bool> isReadDone(readsCount, false);
-        for(uint32_t i = 0; i < readsCount; i++) {
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
             if (isReadDone[i])
                 continue;
-            uint_reads_cnt_std idx = orgIdxs[i];
-            uint_reads_cnt_std pairIdx = idx % 2?(idx-1):(idx+1);
-            uint_reads_cnt_std pairI = rev[pairIdx];
+            uint_reads_cnt_max idx = orgIdxs[i];
+            uint_reads_cnt_max pairIdx = idx % 2?(idx-1):(idx+1);
+            uint_reads_cnt_max pairI = rev[pairIdx];
             isReadDone[pairI] = true;
-            writeValue<uint_reads_cnt_std>(pair1OffsetsDest, pairI > i?pairI - i: readsCount - (i - pairI));
+            ReadsIndexValues::writeIndex(pair1OffsetsDest, pairI > i?pairI - i: readsCount - (i - pairI), stdIdxs);
             writeValue<uint8_t>(pair1SrcFlagDest, idx % 2);
-            writeValue<uint_reads_cnt_std>(pair1IndexesDest, idx);
+            ReadsIndexValues::writeIndex(pair1IndexesDest, idx, stdIdxs);
         }
         pair1IndexesDest.close();
         pair1OffsetsDest.close();
@@ -197,7 +199,7 @@ namespace PgTools {
 
     void SeparatedPseudoGenomePersistence::dumpPgPairs(vector<string> pgFilePrefixes) {
         time_checkpoint();
-        vector<uint_reads_cnt_std> orgIdxs;
+        ReadsIndexValues orgIdxs;
         for(string pgFilePrefix: pgFilePrefixes)
             SeparatedPseudoGenomePersistence::appendIndexesFromPg(pgFilePrefix, orgIdxs);
 
@@ -206,21 +208,24 @@ namespace PgTools {
     }
 
     void SeparatedPseudoGenomePersistence::compressReadsOrder(ostream &pgrcOut,
-            const vector<uint_reads_cnt_std>& orgIdxs, uint8_t coder_level,
+            const ReadsIndexValues& orgIdxs, uint8_t coder_level,
             bool completeOrderInfo, bool ignorePairOrderInformation, bool singleFileMode) {
         time_checkpoint();
-        uint_reads_cnt_std readsCount = orgIdxs.size();
-        int lzma_reads_dataperiod_param = readsCount <= UINT32_MAX ? PGRC_DATAPERIODCODE_32_t : PGRC_DATAPERIODCODE_64_t;
-        vector<uint_reads_cnt_std> rev(readsCount);
-        for (uint_reads_cnt_std i = 0; i < readsCount; i++)
-            rev[orgIdxs[i]] = i;
+        // reads indexes are coded in 64-bit values only if reads count exceeds the standard range
+        uint_reads_cnt_max readsCount = orgIdxs.size();
+        int lzma_reads_dataperiod_param = isReadsCountStd(readsCount) ? PGRC_DATAPERIODCODE_32_t : PGRC_DATAPERIODCODE_64_t;
+        ReadsIndexValues rev(readsCount);
+        rev.resize(readsCount);
+        for (uint_reads_cnt_max i = 0; i < readsCount; i++)
+            rev.set(orgIdxs[i], i);
         if (completeOrderInfo && singleFileMode) {
             *logout << "Reverse index of original indexes... ";
-            writeCompressed(pgrcOut, (char *) rev.data(), rev.size() * sizeof(uint_reads_cnt_std), LZMA_CODER,
-                    coder_level, lzma_reads_dataperiod_param);
+            writeCompressed(pgrcOut, rev.data(), rev.size() * rev.valueBytes(),
+                    selectLzmaCoder(rev.size() * rev.valueBytes()), coder_level, lzma_reads_dataperiod_param);
         } else {
+            ParallelStreamsCompressor psc;
             // absolute pair base index of original pair
-            vector<uint_reads_cnt_std> revPairBaseOrgIdx;
+            ReadsIndexValues revPairBaseOrgIdx(readsCount);
             if (completeOrderInfo)
                 revPairBaseOrgIdx.resize(readsCount / 2);
             // flag indicating a processed pair base file (0 - Second, 1 - First)
@@ -240,22 +245,22 @@ namespace PgTools {
             deltaInInt8Flag.reserve(readsCount / 4); // estimated
             vector<int8_t> deltaInInt8Value;
             deltaInInt8Value.reserve(readsCount / 16); // estimated
-            vector<uint_reads_cnt_std> fullOffset;
+            ReadsIndexValues fullOffset(readsCount);
             deltaInInt8Value.reserve(readsCount / 8); // estimated
 
             vector<bool> isReadDone(readsCount, false);
             int64_t refPrev = 0;
             int64_t prev = 0;
             bool match = false;
-            for (uint32_t i1 = 0; i1 < readsCount; i1++) {
+            for (uint_reads_cnt_max i1 = 0; i1 < readsCount; i1++) {
                 if (isReadDone[i1])
                     continue;
-                uint_reads_cnt_std orgIdx = orgIdxs[i1];
-                uint_reads_cnt_std pairOrgIdx = orgIdx % 2 ? (orgIdx - 1) : (orgIdx + 1);
-                uint_reads_cnt_std i2 = rev[pairOrgIdx]; // i2 > i1
+                uint_reads_cnt_max orgIdx = orgIdxs[i1];
+                uint_reads_cnt_max pairOrgIdx = orgIdx % 2 ? (orgIdx - 1) : (orgIdx + 1);
+                uint_reads_cnt_max i2 = rev[pairOrgIdx]; // i2 > i1
                 isReadDone[i2] = true;
                 if (completeOrderInfo)
-                    revPairBaseOrgIdx[orgIdx / 2] = offsetInUint8Flag.size() * 2 + orgIdx % 2;
+                    revPairBaseOrgIdx.set(orgIdx / 2, offsetInUint8Flag.size() * 2 + orgIdx % 2);
                 int64_t pairRelativeOffset = i2 - i1;
                 offsetInUint8Flag.push_back((uint8_t) (pairRelativeOffset <= UINT8_MAX));
                 if (pairRelativeOffset <= UINT8_MAX) {
@@ -282,61 +287,73 @@ namespace PgTools {
                 prev = pairRelativeOffset;
             }
 
-            *logout << "Uint8 reads list relative offsets of pair reads (flag)... ";
-            writeCompressed(pgrcOut, (char *) offsetInUint8Flag.data(), offsetInUint8Flag.size() * sizeof(uint8_t),
+            psc.addStream("Uint8 reads list relative offsets of pair reads (flag)",
+                            (char *) offsetInUint8Flag.data(), offsetInUint8Flag.size() * sizeof(uint8_t),
                             PPMD7_CODER, coder_level, 3, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-            *logout << "Uint8 reads list relative offsets of pair reads (value)... ";
-            writeCompressed(pgrcOut, (char *) offsetInUint8Value.data(), offsetInUint8Value.size() * sizeof(uint8_t),
+            psc.addStream("Uint8 reads list relative offsets of pair reads (value)",
+                            (char *) offsetInUint8Value.data(), offsetInUint8Value.size() * sizeof(uint8_t),
                             PPMD7_CODER, coder_level, 2);
-            *logout << "Relative offsets deltas of pair reads (flag)... ";
-            writeCompressed(pgrcOut, (char *) deltaInInt8Flag.data(), deltaInInt8Flag.size() * sizeof(uint8_t),
+            psc.addStream("Relative offsets deltas of pair reads (flag)",
+                            (char *) deltaInInt8Flag.data(), deltaInInt8Flag.size() * sizeof(uint8_t),
                             PPMD7_CODER, coder_level, 3, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-            *logout << "Relative offsets deltas of pair reads (value)... ";
-            writeCompressed(pgrcOut, (char*) deltaInInt8Value.data(), deltaInInt8Value.size() * sizeof(uint8_t),
+            psc.addStream("Relative offsets deltas of pair reads (value)",
+                            (char*) deltaInInt8Value.data(), deltaInInt8Value.size() * sizeof(uint8_t),
                             LZMA_CODER, coder_level, PGRC_DATAPERIODCODE_8_t);
 //            writeCompressed(pgrcOut, (char *) deltaInInt8Value.data(), deltaInInt8Value.size() * sizeof(int8_t), PPMD7_CODER, coder_level, 2);
-            *logout << "Full reads list relative offsets of pair reads ... ";
-            double estimated_reads_ratio = simpleUintCompressionEstimate(readsCount, readsCount <= UINT32_MAX?UINT32_MAX:UINT64_MAX);
-            writeCompressed(pgrcOut, (char *) fullOffset.data(), fullOffset.size() * sizeof(uint_reads_cnt_std),
-                            LZMA_CODER, coder_level, lzma_reads_dataperiod_param, estimated_reads_ratio);
+            double estimated_reads_ratio = simpleUintCompressionEstimate(readsCount, isReadsCountStd(readsCount)?UINT32_MAX:UINT64_MAX);
+            psc.addStream("Full reads list relative offsets of pair reads",
+                            fullOffset.data(), fullOffset.size() * fullOffset.valueBytes(),
+                            selectLzmaCoder(fullOffset.size() * fullOffset.valueBytes()), coder_level,
+                            lzma_reads_dataperiod_param, estimated_reads_ratio);
             if (completeOrderInfo) {
-                *logout << "Original indexes of pair bases... ";
-                writeCompressed(pgrcOut, (char *) revPairBaseOrgIdx.data(), revPairBaseOrgIdx.size() * sizeof(uint_reads_cnt_std),
-                                LZMA_CODER, coder_level, lzma_reads_dataperiod_param, estimated_reads_ratio);
+                psc.addStream("Original indexes of pair bases",
+                                revPairBaseOrgIdx.data(), revPairBaseOrgIdx.size() * revPairBaseOrgIdx.valueBytes(),
+                                selectLzmaCoder(revPairBaseOrgIdx.size() * revPairBaseOrgIdx.valueBytes()), coder_level,
+                                lzma_reads_dataperiod_param, estimated_reads_ratio);
             } else if (!ignorePairOrderInformation) {
-                *logout << "File flags of pair bases (for offsets)... ";
-                writeCompressed(pgrcOut, (char *) offsetPairBaseFileFlag.data(), offsetPairBaseFileFlag.size() * sizeof(uint8_t),
+                psc.addStream("File flags of pair bases (for offsets)",
+                                (char *) offsetPairBaseFileFlag.data(), offsetPairBaseFileFlag.size() * sizeof(uint8_t),
                                 PPMD7_CODER, coder_level, 2, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-                *logout << "File flags of pair bases (for non-offsets)... ";
-                writeCompressed(pgrcOut, (char *) nonOffsetPairBaseFileFlag.data(), nonOffsetPairBaseFileFlag.size() * sizeof(uint8_t),
+                psc.addStream("File flags of pair bases (for non-offsets)",
+                                (char *) nonOffsetPairBaseFileFlag.data(), nonOffsetPairBaseFileFlag.size() * sizeof(uint8_t),
                                 PPMD7_CODER, coder_level, 2, COMPRESSION_ESTIMATION_UINT8_BITMAP);
             }
+            psc.write(pgrcOut);
         }
         *logout << "... compressing order information completed in " << time_millis() << " msec. " << endl;
         *logout << endl;
     }
 
+    static void readCompressedIndexes(istream &pgrcIn, ReadsIndexValues &values) {
+        if (values.isMaxMode())
+            readCompressed<uint_reads_cnt_max>(pgrcIn, values.maxValues);
+        else
+            readCompressed<uint_reads_cnt_std>(pgrcIn, values.stdValues);
+    }
+
     void SeparatedPseudoGenomePersistence::decompressReadsOrder(istream &pgrcIn,
-                                                                vector<uint_reads_cnt_std> &rlIdxOrder,
+                                                                ReadsIndexValues &rlIdxOrder,
+                                                                uint_reads_cnt_max readsTotalCount,
                                                                 bool completeOrderInfo, bool ignorePairOrderInformation,
                                                                 bool singleFileMode) {
+        rlIdxOrder = ReadsIndexValues(readsTotalCount);
         if (singleFileMode) {
             if (!completeOrderInfo)
                 return;
-            readCompressed<uint_reads_cnt_std>(pgrcIn, rlIdxOrder);
+            readCompressedIndexes(pgrcIn, rlIdxOrder);
         } else {
             vector<uint8_t> offsetInUint8Flag;
             vector<uint8_t> offsetInUint8Value;
             vector<uint8_t> deltaInInt8Flag;
             vector<int8_t> deltaInInt8Value;
-            vector<uint_reads_cnt_std> fullOffset;
+            ReadsIndexValues fullOffset(readsTotalCount);
             readCompressed<uint8_t>(pgrcIn, offsetInUint8Flag);
             readCompressed<uint8_t>(pgrcIn, offsetInUint8Value);
             readCompressed<uint8_t>(pgrcIn, deltaInInt8Flag);
             readCompressed<int8_t>(pgrcIn, deltaInInt8Value);
-            readCompressed<uint_reads_cnt_std>(pgrcIn, fullOffset);
+            readCompressedIndexes(pgrcIn, fullOffset);
 
-            uint_reads_cnt_std readsCount = offsetInUint8Flag.size() * 2;
+            uint_reads_cnt_max readsCount = offsetInUint8Flag.size() * 2;
             rlIdxOrder.resize(readsCount);
             vector<bool> isReadDone(readsCount, false);
             int64_t pairOffset = 0;
@@ -349,7 +366,7 @@ namespace PgTools {
             int64_t prev = 0;
             bool match = false;
 
-            for(uint_reads_cnt_std i = 0; i < readsCount; i++) {
+            for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
                 if (isReadDone[i])
                     continue;
                 if (offsetInUint8Flag[++pairCounter])
@@ -366,20 +383,20 @@ namespace PgTools {
                     match = false;
                     prev = pairOffset;
                 }
-                rlIdxOrder[pairCounter * 2] = i;
-                rlIdxOrder[pairCounter * 2 + 1] = i + pairOffset;
+                rlIdxOrder.set(pairCounter * 2, i);
+                rlIdxOrder.set(pairCounter * 2 + 1, i + pairOffset);
                 isReadDone[i + pairOffset] = true;
             }
             if (completeOrderInfo) {
-                vector<uint_reads_cnt_std> revPairBaseOrgIdx;
+                ReadsIndexValues revPairBaseOrgIdx(readsCount);
                 revPairBaseOrgIdx.reserve(readsCount);
-                readCompressed<uint_reads_cnt_std>(pgrcIn, revPairBaseOrgIdx);
+                readCompressedIndexes(pgrcIn, revPairBaseOrgIdx);
                 revPairBaseOrgIdx.resize(readsCount);
-                vector<uint_reads_cnt_std> peRlIdxOrder = std::move(rlIdxOrder);
-                for(uint_reads_cnt_std p = readsCount / 2; p-- > 0;) {
-                    uint_reads_cnt_std rlIdx = revPairBaseOrgIdx[p];
-                    revPairBaseOrgIdx[p * 2] = peRlIdxOrder[rlIdx];
-                    revPairBaseOrgIdx[p * 2 + 1] = peRlIdxOrder[rlIdx % 2?rlIdx - 1:rlIdx + 1];
+                ReadsIndexValues peRlIdxOrder = std::move(rlIdxOrder);
+                for(uint_reads_cnt_max p = readsCount / 2; p-- > 0;) {
+                    uint_reads_cnt_max rlIdx = revPairBaseOrgIdx[p];
+                    revPairBaseOrgIdx.set(p * 2, peRlIdxOrder[rlIdx]);
+                    revPairBaseOrgIdx.set(p * 2 + 1, peRlIdxOrder[rlIdx % 2?rlIdx - 1:rlIdx + 1]);
                 }
                 rlIdxOrder = std::move(revPairBaseOrgIdx);
             } else if (!ignorePairOrderInformation) {
@@ -389,36 +406,53 @@ namespace PgTools {
                 readCompressed<uint8_t>(pgrcIn, nonOffsetPairBaseFileFlag);
                 int64_t offIdx = -1;
                 int64_t nonOffIdx = -1;
-                for(uint_reads_cnt_std p = 0; p < readsCount / 2; p++) {
+                for(uint_reads_cnt_max p = 0; p < readsCount / 2; p++) {
                     bool swapPair = offsetInUint8Flag[p]?offsetPairBaseFileFlag[++offIdx]:nonOffsetPairBaseFileFlag[++nonOffIdx];
                     if (swapPair) {
-                        uint_reads_cnt_std tmpIdx = rlIdxOrder[p * 2];
-                        rlIdxOrder[p * 2] = rlIdxOrder[p * 2 + 1];
-                        rlIdxOrder[p * 2 + 1] = tmpIdx;
+                        uint_reads_cnt_max tmpIdx = rlIdxOrder[p * 2];
+                        rlIdxOrder.set(p * 2, rlIdxOrder[p * 2 + 1]);
+                        rlIdxOrder.set(p * 2 + 1, tmpIdx);
                     }
                 }
             }
         }
     }
 
+    template<typename uint_reads_cnt, typename uint_pg_len>
+    static void stableSortIndexesByPositions(vector<uint_reads_cnt> &idxs, const vector<uint_pg_len> &positions) {
+        __gnu_parallel::stable_sort(idxs.begin(), idxs.end(),
+                [&](const uint_reads_cnt &idx1, const uint_reads_cnt &idx2) -> bool
+                    { return positions[idx1] < positions[idx2]; });
+    }
+
+    template<typename uint_pg_len>
+    static void stableSortIndexesByPositions(ReadsIndexValues &idxs, const vector<uint_pg_len> &positions) {
+        if (idxs.isMaxMode())
+            stableSortIndexesByPositions(idxs.maxValues, positions);
+        else
+            stableSortIndexesByPositions(idxs.stdValues, positions);
+    }
+
     template <typename uint_pg_len>
     void SeparatedPseudoGenomePersistence::compressReadsPgPositions(ostream &pgrcOut,
             vector<uint_pg_len_max> orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
             bool singleFileMode, bool deltaPairEncodingEnabled) {
         time_checkpoint();
-        uint_reads_cnt_std readsTotalCount = orgIdx2PgPos.size();
+        uint_reads_cnt_max readsTotalCount = orgIdx2PgPos.size();
         int lzma_pos_dataperiod_param = sizeof(uint_pg_len) == 4 ? PGRC_DATAPERIODCODE_32_t : PGRC_DATAPERIODCODE_64_t;
         double estimated_pos_ratio = simpleUintCompressionEstimate(joinedPgLength, sizeof(uint_pg_len) == 4?UINT32_MAX:UINT64_MAX);
         if (singleFileMode) {
             uint_pg_len_max* const maxPgPosPtr = orgIdx2PgPos.data();
             if (sizeof(uint_pg_len) < sizeof(uint_pg_len_max)) {
                 uint_pg_len* PgPosPtr = (uint_pg_len*) maxPgPosPtr;
-                for (uint_reads_cnt_std i = 0; i < readsTotalCount; i++)
+                for (uint_reads_cnt_max i = 0; i < readsTotalCount; i++)
                     *(PgPosPtr++) = (uint_pg_len) orgIdx2PgPos[i];
             }
             writeCompressed(pgrcOut, (char*) maxPgPosPtr, readsTotalCount * sizeof(uint_pg_len),
-                            LZMA_CODER, coder_level, lzma_pos_dataperiod_param, estimated_pos_ratio);
+                            selectLzmaCoder(readsTotalCount * sizeof(uint_pg_len)), coder_level,
+                            lzma_pos_dataperiod_param, estimated_pos_ratio);
         } else {
+            ParallelStreamsCompressor psc;
             vector<uint_pg_len> basePairPos;
             // pair relative offset info
             vector<uint8_t> offsetInUint16Flag;
@@ -428,7 +462,7 @@ namespace PgTools {
             vector<uint8_t> deltaIsBaseFirstFlag;
             vector<int16_t> deltaInInt16Value;
             vector<uint_pg_len> notBasePairPos;
-            const uint_reads_cnt_std pairsCount = readsTotalCount / 2;
+            const uint_reads_cnt_max pairsCount = readsTotalCount / 2;
             basePairPos.reserve(pairsCount);
             offsetInUint16Flag.reserve(pairsCount);
             offsetIsBaseFirstFlag.reserve(pairsCount);
@@ -440,21 +474,19 @@ namespace PgTools {
             }
             notBasePairPos.reserve(pairsCount / 4);
 
-            vector<uint_reads_cnt_std> bppRank;
+            ReadsIndexValues bppRank(pairsCount);
             bppRank.reserve(pairsCount);
-            for (uint_reads_cnt_std i = 0; i < readsTotalCount; i += 2) {
+            for (uint_reads_cnt_max i = 0; i < readsTotalCount; i += 2) {
                 basePairPos.push_back(orgIdx2PgPos[i]);
                 bppRank.push_back(i >> 1);
             }
-            __gnu_parallel::stable_sort(bppRank.begin(), bppRank.end(),
-                    [&](const uint_reads_cnt_std &idx1, const uint_reads_cnt_std &idx2) -> bool
-                        { return basePairPos[idx1] < basePairPos[idx2]; });
+            stableSortIndexesByPositions(bppRank, basePairPos);
             *logout << "... reordering bases checkpoint: " << time_millis() << " msec. " << endl;
             int64_t refPrev = 0;
             int64_t prev = 0;
             bool match = false;
-            for (uint_reads_cnt_std p = 0; p < pairsCount; p++) {
-                uint_reads_cnt_std i = bppRank[p] * 2;
+            for (uint_reads_cnt_max p = 0; p < pairsCount; p++) {
+                uint_reads_cnt_max i = bppRank[p] * 2;
 
                 bool isBaseBefore = orgIdx2PgPos[i] < orgIdx2PgPos[i + 1];
                 uint_pg_len relativeAbsOffset = isBaseBefore?(orgIdx2PgPos[i + 1] - orgIdx2PgPos[i]):
@@ -486,34 +518,36 @@ namespace PgTools {
                     notBasePairPos.push_back((uint_pg_len) orgIdx2PgPos[i + 1]);
                 }
             }
-            pgrcOut.put(deltaPairEncodingEnabled);
-            *logout << "Base pair position... ";
-            writeCompressed(pgrcOut, (char *) basePairPos.data(), basePairPos.size() * sizeof(uint_pg_len),
-                            LZMA_CODER, coder_level, lzma_pos_dataperiod_param, estimated_pos_ratio);
-            *logout << "Uint16 relative offset of pair positions (flag)... ";
-            writeCompressed(pgrcOut, (char *) offsetInUint16Flag.data(), offsetInUint16Flag.size() * sizeof(uint8_t),
+            psc.addRawBytes(string(1, (char) deltaPairEncodingEnabled));
+            psc.addStream("Base pair position", (char *) basePairPos.data(), basePairPos.size() * sizeof(uint_pg_len),
+                            selectLzmaCoder(basePairPos.size() * sizeof(uint_pg_len)), coder_level,
+                            lzma_pos_dataperiod_param, estimated_pos_ratio);
+            psc.addStream("Uint16 relative offset of pair positions (flag)",
+                            (char *) offsetInUint16Flag.data(), offsetInUint16Flag.size() * sizeof(uint8_t),
                             PPMD7_CODER, coder_level, 3, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-            *logout << "Is uint16 relative offset of pair positions positive (flag)... ";
-            writeCompressed(pgrcOut, (char *) offsetIsBaseFirstFlag.data(), offsetIsBaseFirstFlag.size() * sizeof(uint8_t),
+            psc.addStream("Is uint16 relative offset of pair positions positive (flag)",
+                            (char *) offsetIsBaseFirstFlag.data(), offsetIsBaseFirstFlag.size() * sizeof(uint8_t),
                             PPMD7_CODER, coder_level, 3, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-            *logout << "Uint16 relative offset of pair positions (value)... ";
-            writeCompressed(pgrcOut, (char*) offsetInUint16Value.data(), offsetInUint16Value.size() * sizeof(uint16_t),
+            psc.addStream("Uint16 relative offset of pair positions (value)",
+                            (char*) offsetInUint16Value.data(), offsetInUint16Value.size() * sizeof(uint16_t),
                             PPMD7_CODER, coder_level, 3);
             if (deltaPairEncodingEnabled) {
-                *logout << "Relative offset deltas of pair positions (flag)... ";
-                writeCompressed(pgrcOut, (char *) deltaInInt16Flag.data(), deltaInInt16Flag.size() * sizeof(uint8_t),
+                psc.addStream("Relative offset deltas of pair positions (flag)",
+                                (char *) deltaInInt16Flag.data(), deltaInInt16Flag.size() * sizeof(uint8_t),
                                 PPMD7_CODER, coder_level, 3, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-                *logout << "Is relative offset (for deltas stream) of pair positions positive (flag)... ";
-                writeCompressed(pgrcOut, (char *) deltaIsBaseFirstFlag.data(),
+                psc.addStream("Is relative offset (for deltas stream) of pair positions positive (flag)",
+                                (char *) deltaIsBaseFirstFlag.data(),
                                 deltaIsBaseFirstFlag.size() * sizeof(uint8_t),
                                 PPMD7_CODER, coder_level, 3, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-                *logout << "Relative offset deltas of pair positions (value)... ";
-                writeCompressed(pgrcOut, (char *) deltaInInt16Value.data(), deltaInInt16Value.size() * sizeof(int16_t),
+                psc.addStream("Relative offset deltas of pair positions (value)",
+                                (char *) deltaInInt16Value.data(), deltaInInt16Value.size() * sizeof(int16_t),
                                 PPMD7_CODER, coder_level, 3);
             }
-            *logout << "Not-base pair position... ";
-            writeCompressed(pgrcOut, (char *) notBasePairPos.data(), notBasePairPos.size() * sizeof(uint_pg_len),
-                            LZMA_CODER, coder_level, lzma_pos_dataperiod_param, estimated_pos_ratio);
+            psc.addStream("Not-base pair position",
+                            (char *) notBasePairPos.data(), notBasePairPos.size() * sizeof(uint_pg_len),
+                            selectLzmaCoder(notBasePairPos.size() * sizeof(uint_pg_len)), coder_level,
+                            lzma_pos_dataperiod_param, estimated_pos_ratio);
+            psc.write(pgrcOut);
         }
         *logout << "... compressing reads positions completed in " << time_millis() << " msec. " << endl;
         *logout << endl;
@@ -527,7 +561,7 @@ namespace PgTools {
 
     template <typename uint_pg_len>
     void SeparatedPseudoGenomePersistence::decompressReadsPgPositions(istream &pgrcIn, vector<uint_pg_len> &pgPos,
-                                                                          uint_reads_cnt_std readsTotalCount, bool singleFileMode) {
+                                                                          uint_reads_cnt_max readsTotalCount, bool singleFileMode) {
         if (singleFileMode)
             readCompressed(pgrcIn, pgPos);
         else {
@@ -550,14 +584,12 @@ namespace PgTools {
                 readCompressed(pgrcIn, deltaInInt16Value);
             }
             readCompressed(pgrcIn, notBasePairPos);
-            const uint_reads_cnt_std pairsCount = readsTotalCount / 2;
-            vector<uint_reads_cnt_std> bppRank;
+            const uint_reads_cnt_max pairsCount = readsTotalCount / 2;
+            ReadsIndexValues bppRank(pairsCount);
             bppRank.reserve(pairsCount);
-            for (uint_reads_cnt_std p = 0; p < pairsCount; p++)
+            for (uint_reads_cnt_max p = 0; p < pairsCount; p++)
                 bppRank.push_back(p);
-            __gnu_parallel::stable_sort(bppRank.begin(), bppRank.end(),
-                             [&](const uint_reads_cnt_std &idx1, const uint_reads_cnt_std &idx2) -> bool
-                             { return pgPos[idx1] < pgPos[idx2]; });
+            stableSortIndexesByPositions(bppRank, pgPos);
 
             pgPos.resize(readsTotalCount);
             int64_t nbpPos = 0;
@@ -568,8 +600,8 @@ namespace PgTools {
             int64_t refPrev = 0;
             int64_t prev = 0;
             bool match = false;
-            for (uint_reads_cnt_std i = 0; i < pairsCount; i++) {
-                uint_reads_cnt_std p = bppRank[i];
+            for (uint_reads_cnt_max i = 0; i < pairsCount; i++) {
+                uint_reads_cnt_max p = bppRank[i];
                 if (offsetInUint16Flag[i] == 1) {
                     int64_t delta = offsetInUint16Value[++offIdx];
                     if (offsetIsBaseFirstFlag[offIdx] == 0)
@@ -597,8 +629,8 @@ namespace PgTools {
             }
         }
     }
-    template void SeparatedPseudoGenomePersistence::decompressReadsPgPositions<uint_pg_len_std>(istream &pgrcIn, vector<uint_pg_len_std> &pgPos, uint_reads_cnt_std readsTotalCount, bool singleFileMode);
-    template void SeparatedPseudoGenomePersistence::decompressReadsPgPositions<uint_pg_len_max>(istream &pgrcIn, vector<uint_pg_len_max> &pgPos, uint_reads_cnt_std readsTotalCount, bool singleFileMode);
+    template void SeparatedPseudoGenomePersistence::decompressReadsPgPositions<uint_pg_len_std>(istream &pgrcIn, vector<uint_pg_len_std> &pgPos, uint_reads_cnt_max readsTotalCount, bool singleFileMode);
+    template void SeparatedPseudoGenomePersistence::decompressReadsPgPositions<uint_pg_len_max>(istream &pgrcIn, vector<uint_pg_len_max> &pgPos, uint_reads_cnt_max readsTotalCount, bool singleFileMode);
 
     SeparatedPseudoGenomeOutputBuilder::SeparatedPseudoGenomeOutputBuilder(const string pseudoGenomePrefix,
             bool disableRevComp, bool disableMismatches) : pseudoGenomePrefix(pseudoGenomePrefix),
@@ -626,7 +658,8 @@ namespace PgTools {
             initDest(rlPosDest, SeparatedPseudoGenomeBase::READSLIST_POSITIONS_FILE_SUFFIX);
         else
             initDest(rlOffDest, SeparatedPseudoGenomeBase::READSLIST_OFFSETS_FILE_SUFFIX);
-        initDest(rlOrgIdxDest, SeparatedPseudoGenomeBase::READSLIST_ORIGINAL_INDEXES_FILE_SUFFIX);
+        if (onTheFlyMode())
+            initDest(rlOrgIdxDest, SeparatedPseudoGenomeBase::READSLIST_ORIGINAL_INDEXES_FILE_SUFFIX);
         if (!disableRevComp)
             initDest(rlRevCompDest, SeparatedPseudoGenomeBase::READSLIST_REVERSECOMPL_FILE_SUFFIX);
         if (!disableMismatches) {
@@ -715,7 +748,11 @@ namespace PgTools {
 
         destToFile(rlPosDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_POSITIONS_FILE_SUFFIX);
         destToFile(rlOffDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_OFFSETS_FILE_SUFFIX);
-        destToFile(rlOrgIdxDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_ORIGINAL_INDEXES_FILE_SUFFIX);
+        ofstream orgIdxDest = SeparatedPseudoGenomePersistence::getPseudoGenomeElementDest(pgPrefix,
+                SeparatedPseudoGenomeBase::READSLIST_ORIGINAL_INDEXES_FILE_SUFFIX);
+        for(uint_reads_cnt_max i = 0; i < rlOrgIdxValues.size(); i++)
+            PgSAHelpers::writeValue<uint_reads_cnt_max>(orgIdxDest, rlOrgIdxValues[i]);
+        orgIdxDest.close();
         destToFile(rlRevCompDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_REVERSECOMPL_FILE_SUFFIX);
         destToFile(rlMisCntDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_MISMATCHES_COUNT_FILE_SUFFIX);
         destToFile(rlMisSymDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_MISMATCHED_SYMBOLS_FILE_SUFFIX);
@@ -724,7 +761,8 @@ namespace PgTools {
         destToFile(rlMisPosDest, pgPrefix + SeparatedPseudoGenomeBase::READSLIST_MISMATCHES_POSITIONS_FILE_SUFFIX);
     }
 
-    void SeparatedPseudoGenomeOutputBuilder::compressDest(ostream* dest, ostream &pgrcOut, uint8_t coder_type,
+    void SeparatedPseudoGenomeOutputBuilder::compressDest(ostream* dest, ParallelStreamsCompressor &psc,
+                                                          const string &label, uint8_t coder_type,
                                                           uint8_t coder_level, int coder_param,
                                                           double estimated_compression,
                                                           SymbolsPackingFacility* symPacker) {
@@ -734,18 +772,22 @@ namespace PgTools {
         }
         string tmp = ((ostringstream*) dest)->str();
         if (symPacker) {
-            PgSAHelpers::writeValue<uint64_t>(pgrcOut, tmp.length(), false);
+            ostringstream lengthDest;
+            PgSAHelpers::writeValue<uint64_t>(lengthDest, tmp.length(), false);
+            psc.addRawBytes(lengthDest.str());
             tmp = symPacker->packSequence(tmp.data(), tmp.length());
         }
-        writeCompressed(pgrcOut, tmp, coder_type, coder_level, coder_param, estimated_compression);
+        psc.addStream(label, std::move(tmp), coder_type, coder_level, coder_param, estimated_compression);
     }
 
-    void SeparatedPseudoGenomeOutputBuilder::compressRlMisRevOffDest(ostream &pgrcOut, uint8_t coder_level,
+    void SeparatedPseudoGenomeOutputBuilder::compressRlMisRevOffDest(ParallelStreamsCompressor &psc, uint8_t coder_level,
             bool transposeMode) {
         uint8_t mismatches_dests_count = coder_level == PGRC_CODER_LEVEL_FAST?1:(UINT8_MAX-1);
         if (mismatches_dests_count == 1) {
-            PgSAHelpers::writeValue<uint8_t>(pgrcOut, 1);
-            compressDest(rlMisRevOffDest, pgrcOut, PPMD7_CODER, coder_level, 3);
+            ostringstream headerDest;
+            PgSAHelpers::writeValue<uint8_t>(headerDest, 1);
+            psc.addRawBytes(headerDest.str());
+            compressDest(rlMisRevOffDest, psc, "Mismatches offsets", PPMD7_CODER, coder_level, 3);
             return;
         }
         vector<uint8_t> misCnt2DestIdx; // NOT-TESTED => {0, 1, 2, 3, 4, 5, 6, 7, 7, 9, 9, 9 };
@@ -782,44 +824,40 @@ namespace PgTools {
         }
         while (mismatches_dests_count > 0 && dests[mismatches_dests_count].tellp() == 0)
             mismatches_dests_count--;
-        PgSAHelpers::writeValue<uint8_t>(pgrcOut, mismatches_dests_count);
+        ostringstream headerDest;
+        PgSAHelpers::writeValue<uint8_t>(headerDest, mismatches_dests_count);
         for(uint8_t m = 1; m < mismatches_dests_count; m++)
-            PgSAHelpers::writeValue<uint8_t>(pgrcOut, misCnt2DestIdx[m]);
-        for(uint8_t m = 1; m <= mismatches_dests_count; m++) {
-            *logout << (int) m << ": ";
-            compressDest(&dests[m], pgrcOut, PPMD7_CODER, coder_level, 2);
-        }
+            PgSAHelpers::writeValue<uint8_t>(headerDest, misCnt2DestIdx[m]);
+        psc.addRawBytes(headerDest.str());
+        for(uint8_t m = 1; m <= mismatches_dests_count; m++)
+            compressDest(&dests[m], psc, "Mismatches offsets (rev-coded) " + toString(m), PPMD7_CODER,
+                         coder_level, 2);
     }
 
     void SeparatedPseudoGenomeOutputBuilder::compressedBuild(ostream &pgrcOut, uint8_t coder_level, bool ignoreOffDest) {
         prebuildAssert(false);
         buildProps();
         writeReadMode(*pgPropDest, false);
-        const string tmp = ((ostringstream*) pgPropDest)->str();
-        pgrcOut.write(tmp.data(), tmp.length());
-
-        if (!ignoreOffDest) {
-            *logout << "Reads list offsets... ";
-            compressDest(rlOffDest, pgrcOut, PPMD7_CODER, coder_level, 3);
-        }
-        if (!this->disableRevComp) {
-            *logout << "Reverse complements info... ";
-            compressDest(rlRevCompDest, pgrcOut, PPMD7_CODER, coder_level, 2, COMPRESSION_ESTIMATION_UINT8_BITMAP);
-        }
+        ParallelStreamsCompressor psc;
+        psc.addRawBytes(((ostringstream*) pgPropDest)->str());
+
+        if (!ignoreOffDest)
+            compressDest(rlOffDest, psc, "Reads list offsets", PPMD7_CODER, coder_level, 3);
+        if (!this->disableRevComp)
+            compressDest(rlRevCompDest, psc, "Reverse complements info", PPMD7_CODER, coder_level, 2,
+                    COMPRESSION_ESTIMATION_UINT8_BITMAP);
         if (!this->disableMismatches) {
-            *logout << "Mismatches counts... ";
-            compressDest(rlMisCntDest, pgrcOut, PPMD7_CODER, coder_level, 2, COMPRESSION_ESTIMATION_MIS_CNT);
-            *logout << "Mismatched symbols codes... ";
-            compressDest(rlMisSymDest, pgrcOut, PPMD7_CODER, coder_level, 2, COMPRESSION_ESTIMATION_MIS_SYM);
-            *logout << "Mismatches offsets (rev-coded)... " << endl;
-            compressRlMisRevOffDest(pgrcOut, coder_level);
+            compressDest(rlMisCntDest, psc, "Mismatches counts", PPMD7_CODER, coder_level, 2,
+                    COMPRESSION_ESTIMATION_MIS_CNT);
+            compressDest(rlMisSymDest, psc, "Mismatched symbols codes", PPMD7_CODER, coder_level, 2,
+                    COMPRESSION_ESTIMATION_MIS_SYM);
+            compressRlMisRevOffDest(psc, coder_level);
         }
+        psc.write(pgrcOut);
     }
 
     void SeparatedPseudoGenomeOutputBuilder::updateOriginalIndexesIn(SeparatedPseudoGenome *sPg) {
-        string tmp = ((ostringstream *) rlOrgIdxDest)->str();
-        uint_reads_cnt_std *orgIdxPtr = (uint_reads_cnt_std *) tmp.data();
-        sPg->getReadsList()->orgIdx.assign(orgIdxPtr, orgIdxPtr + readsCounter);
+        sPg->getReadsList()->orgIdx = std::move(rlOrgIdxValues);
         sPg->getReadsList()->readsCount = readsCounter;
     }
 
@@ -829,7 +867,10 @@ namespace PgTools {
             PgSAHelpers::writeValue<uint_pg_len_max>(*rlPosDest, rlEntry.pos);
         else
             PgSAHelpers::writeReadLengthValue(*rlOffDest, rlEntry.offset);
-        PgSAHelpers::writeValue<uint_reads_cnt_std>(*rlOrgIdxDest, rlEntry.idx);
+        if (rlOrgIdxDest)
+            PgSAHelpers::writeValue<uint_reads_cnt_max>(*rlOrgIdxDest, rlEntry.idx);
+        else
+            rlOrgIdxValues.push_back(rlEntry.idx);
         if (!disableRevComp)
             PgSAHelpers::writeValue<uint8_t>(*rlRevCompDest, rlEntry.revComp?1:0);
         if (!disableMismatches) {
@@ -838,7 +879,7 @@ namespace PgTools {
                 for (uint8_t i = 0; i < rlEntry.mismatchesCount; i++)
                     PgSAHelpers::writeValue<uint8_t>(*rlMisSymDest, rlEntry.mismatchCode[i]);
                 if (SeparatedPseudoGenomePersistence::enableRevOffsetMismatchesRepresentation) {
-                    uint8_t currentPos = pgh->getMaxReadLength() - 1;
+                    uint_read_len_max currentPos = pgh->getMaxReadLength() - 1;
                     for (int16_t i = rlEntry.mismatchesCount - 1; i >= 0; i--) {
                         PgSAHelpers::writeReadLengthValue(*rlMisRevOffDest,
                                                                    currentPos - rlEntry.mismatchOffset[i]);
@@ -904,8 +945,8 @@ namespace PgTools {
         if (rsProp == 0)
             rsProp = new ReadsSetProperties(*(pgb->getReadsSetProperties()));
         if (pgh->getReadsCount() != readsCounter) {
-            fprintf(stderr, "Incorrect reads count validation while building separated Pg (%u instead of %u).\n",
-                    readsCounter, pgh->getReadsCount());
+            fprintf(stderr, "Incorrect reads count validation while building separated Pg (%llu instead of %llu).\n",
+                    (unsigned long long) readsCounter, (unsigned long long) pgh->getReadsCount());
             exit(EXIT_FAILURE);
         }
 
@@ -963,8 +1004,8 @@ namespace PgTools {
         if (rsProp == 0)
             rsProp = new ReadsSetProperties(*(sPg->getReadsSetProperties()));
         if (pgh->getReadsCount() != readsCounter) {
-            fprintf(stderr, "Incorrect reads count validation while building separated Pg (%u instead of %u).\n",
-                    readsCounter, pgh->getReadsCount());
+            fprintf(stderr, "Incorrect reads count validation while building separated Pg (%llu instead of %llu).\n",
+                    (unsigned long long) readsCounter, (unsigned long long) pgh->getReadsCount());
             exit(EXIT_FAILURE);
         }
     }
@@ -17,8 +17,8 @@ namespace PgTools {
 
         static bool acceptTemporaryPseudoGenomeElement(const string &pseudoGenomePrefix, const string& fileSuffix, bool alwaysRemoveExisting);
 
-        static void appendIndexesFromPg(string pgFilePrefix, vector<uint_reads_cnt_std> &idxs);
-        static void writePairMapping(basic_string<char> &pgFilePrefix, vector<uint_reads_cnt_std> orgIdxs);
+        static void appendIndexesFromPg(string pgFilePrefix, ReadsIndexValues &idxs);
+        static void writePairMapping(basic_string<char> &pgFilePrefix, const ReadsIndexValues &orgIdxs);
 
     public:
         static void writePseudoGenome(PseudoGenomeBase* pgb, const string &pseudoGenomePrefix,
@@ -43,9 +43,9 @@ namespace PgTools {
         static bool enableRevOffsetMismatchesRepresentation;
 
         static void dumpPgPairs(vector<string> pgFilePrefixes);
-        static void compressReadsOrder(ostream &pgrcOut, const vector<uint_reads_cnt_std>& orgIdxs, uint8_t coder_level,
+        static void compressReadsOrder(ostream &pgrcOut, const ReadsIndexValues& orgIdxs, uint8_t coder_level,
                 bool completeOrderInfo = false, bool ignorePairOrderInformation = false, bool singleFileMode = true);
-        static void decompressReadsOrder(istream &pgrcIn, vector<uint_reads_cnt_std>& rlIdxOrder,
+        static void decompressReadsOrder(istream &pgrcIn, ReadsIndexValues& rlIdxOrder, uint_reads_cnt_max readsTotalCount,
                                        bool completeOrderInfo = false, bool ignorePairOrderInformation = false, bool singleFileMode = true);
 
         static void writePseudoGenomeSequence(string &pgSequence, string pgPrefix);
@@ -54,7 +54,7 @@ namespace PgTools {
         static void compressReadsPgPositions(ostream &pgrcOut, vector<uint_pg_len_max> orgIdx2PgPos,
                 uint_pg_len_max joinedPgLength, uint8_t coder_level, bool singleFileMode, bool deltaPairEncodingEnabled = true);
         template <typename uint_pg_len>
-        static void decompressReadsPgPositions(istream &pgrcIn, vector<uint_pg_len> &pgPos, uint_reads_cnt_std readsTotalCount, bool singleFileMode);
+        static void decompressReadsPgPositions(istream &pgrcIn, vector<uint_pg_len> &pgPos, uint_reads_cnt_max readsTotalCount, bool singleFileMode);
     };
 
     class SeparatedPseudoGenomeOutputBuilder {
@@ -75,6 +75,9 @@ namespace PgTools {
         ostream* rlOffDest = 0;
         ostream* rlMisRevOffDest = 0;
 
+        // original indexes are collected directly (instead of rlOrgIdxDest) if not in on-the-fly mode
+        ReadsIndexValues rlOrgIdxValues;
+
         bool disableRevComp = false;
         bool disableMismatches = false;
 
@@ -96,9 +99,10 @@ namespace PgTools {
         void freeDest(ostream* &dest);
         void freeDests();
 
-        void compressDest(ostream* dest, ostream &pgrcOut, uint8_t coder_type, uint8_t coder_level, int coder_param = -1,
-                          double estimated_compression = 1, SymbolsPackingFacility* symPacker = 0);
-        void compressRlMisRevOffDest(ostream &pgrcOut, uint8_t coder_level, bool transposeMode = false);
+        void compressDest(ostream* dest, ParallelStreamsCompressor &psc, const string &label, uint8_t coder_type,
+                          uint8_t coder_level, int coder_param = -1, double estimated_compression = 1,
+                          SymbolsPackingFacility* symPacker = 0);
+        void compressRlMisRevOffDest(ParallelStreamsCompressor &psc, uint8_t coder_level, bool transposeMode = false);
         void destToFile(ostream *dest, const string &fileName);
     public:
 
@@ -1,5 +1,6 @@
 #include "SeparatedExtendedReadsList.h"
 
+#include <memory>
 #include "../../utils/LzmaLib.h"
 #include "../SeparatedPseudoGenomeBase.h"
 
@@ -165,9 +166,9 @@ namespace PgTools {
     template <int maxMismatches>
     bool SeparatedExtendedReadsListIterator<maxMismatches>::moveNext() {
         if (++current < pgh->getReadsCount()) {
-            uint_reads_cnt_std idx = 0;
+            uint_reads_cnt_max idx = 0;
             uint8_t revComp = 0;
-            PgSAHelpers::readValue<uint_reads_cnt_std>(*rlOrgIdxSrc, idx, plainTextReadMode);
+            PgSAHelpers::readValue<uint_reads_cnt_max>(*rlOrgIdxSrc, idx, plainTextReadMode);
             if (rlRevCompSrc)
                 PgSAHelpers::readValue<uint8_t>(*rlRevCompSrc, revComp, plainTextReadMode);
             if (rlOffSrc) {
@@ -223,6 +224,17 @@ namespace PgTools {
         return rlMisCntSrc;
     }
 
+    // original indexes elements are persisted in 64-bit values
+    static void readOriginalIndexes(istream &src, ReadsIndexValues &orgIdx, uint_reads_cnt_max readsCount) {
+        vector<uint_reads_cnt_max> idxs(readsCount);
+        PgSAHelpers::readArray(src, idxs.data(), sizeof(uint_reads_cnt_max) * readsCount);
+        orgIdx = ReadsIndexValues(idxs.empty() ? 0 : *std::max_element(idxs.begin(), idxs.end()));
+        if (orgIdx.isMaxMode())
+            orgIdx.maxValues = std::move(idxs);
+        else
+            orgIdx.stdValues.assign(idxs.begin(), idxs.end());
+    }
+
     ExtendedReadsListWithConstantAccessOption *ExtendedReadsListWithConstantAccessOption::loadConstantAccessExtendedReadsList(
             const string &pseudoGenomePrefix, uint_pg_len_max pgLengthPosGuard, bool skipMismatches) {
         DefaultSeparatedExtendedReadsListIterator rl(pseudoGenomePrefix);
@@ -239,11 +251,10 @@ namespace PgTools {
         }
 
         const uint_reads_cnt_max readsCount = rl.pgh->getReadsCount();
-        if (rl.rlOrgIdxSrc) {
+        if (rl.rlOrgIdxSrc)
+            readOriginalIndexes(*(rl.rlOrgIdxSrc), res->orgIdx, readsCount);
+        else
             res->orgIdx.resize(readsCount);
-            PgSAHelpers::readArray(*(rl.rlOrgIdxSrc), res->orgIdx.data(), sizeof(uint_reads_cnt_std) * readsCount);
-        } else
-            res->orgIdx.resize(readsCount, 0);
         if (rl.rlRevCompSrc) {
             res->revComp.resize(readsCount);
             PgSAHelpers::readArray(*(rl.rlRevCompSrc), res->revComp.data(), sizeof(uint8_t) * readsCount);
@@ -277,12 +288,20 @@ namespace PgTools {
             PgSAHelpers::readArray(*(rl.rlMisSymSrc), res->misSymCode.data(), sizeof(uint8_t) * cumCount);
             res->misOff.resize(cumCount);
             bool misRevOffMode = rl.rlMisOffSrc == 0;
-            PgSAHelpers::readArray(misRevOffMode?*(rl.rlMisRevOffSrc):*(rl.rlMisOffSrc), res->misOff.data(),
-                    sizeof(uint8_t) * cumCount);
+            istream &misOffSrc = misRevOffMode?*(rl.rlMisRevOffSrc):*(rl.rlMisOffSrc);
+            uint_read_len_max misOff = 0;
+            for (uint_reads_cnt_max i = 0; i < cumCount; i++) {
+                PgSAHelpers::readReadLengthValue(misOffSrc, misOff, rl.plainTextReadMode);
+                res->misOff.set(i, misOff);
+            }
             if (misRevOffMode) {
                 for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
-                    PgSAHelpers::convertMisRevOffsets2Offsets<uint8_t>(res->misOff.data() + res->misCumCount[i],
-                            res->getMisCount(i), res->readLength);
+                    if (res->misOff.isStdMode())
+                        PgSAHelpers::convertMisRevOffsets2Offsets<uint_read_len_std>(
+                                res->misOff.stdValues.data() + res->misCumCount[i], res->getMisCount(i), res->readLength);
+                    else
+                        PgSAHelpers::convertMisRevOffsets2Offsets<uint_read_len_min>(
+                                res->misOff.minValues.data() + res->misCumCount[i], res->getMisCount(i), res->readLength);
                 }
             }
         }
@@ -290,46 +309,67 @@ namespace PgTools {
         return res;
     }
 
+    template<typename uint_read_len>
+    static void addMismatchesOffsetsStreams(ParallelStreamsDecompressor *psd, istream &pgrcIn,
+            ExtendedReadsListWithConstantAccessOption *res, const uint_reads_cnt_max readsCount,
+            const vector<uint8_t> &misCnt2SrcIdx, const uint8_t mismatchesCountSrcsLimit) {
+        std::shared_ptr<vector<vector<uint_read_len>>> srcs = std::make_shared<vector<vector<uint_read_len>>>(UINT8_MAX);
+        for (uint8_t m = 1; m <= mismatchesCountSrcsLimit; m++)
+            psd->addStream(pgrcIn, (*srcs)[m]);
+        psd->addFinalizer([res, readsCount, misCnt2SrcIdx, srcs]() {
+            vector<uint64_t> srcCounter(UINT8_MAX, 0);
+            res->misOff.reserve(res->misSymCode.size());
+            for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
+                uint8_t misCnt = res->misCnt[i];
+                uint8_t srcIdx = misCnt2SrcIdx[misCnt];
+                uint64_t misOffStartIdx = res->misOff.size();
+                for (uint8_t m = 0; m < misCnt; m++)
+                    res->misOff.push_back((*srcs)[srcIdx][srcCounter[srcIdx]++]);
+                PgSAHelpers::convertMisRevOffsets2Offsets<uint_read_len>(
+                        res->misOff.getValues<uint_read_len>().data() + misOffStartIdx, res->misCnt[i], res->readLength);
+            }
+            srcs->clear();
+        });
+    }
+
     ExtendedReadsListWithConstantAccessOption* ExtendedReadsListWithConstantAccessOption::loadConstantAccessExtendedReadsList(
             istream& pgrcIn, PseudoGenomeHeader* pgh, ReadsSetProperties* rsProp, const string validationPgPrefix,
-            bool preserveOrderMode, bool disableRevCompl, bool disableMismatches) {
+            bool preserveOrderMode, bool disableRevCompl, bool disableMismatches, ParallelStreamsDecompressor *psd) {
         ExtendedReadsListWithConstantAccessOption *res = new ExtendedReadsListWithConstantAccessOption(pgh->getMaxReadLength());
         const uint_reads_cnt_max readsCount = pgh->getReadsCount();
-        if (!preserveOrderMode)
-            readCompressed(pgrcIn, res->off);
+        ParallelStreamsDecompressor ownPsd;
+        if (!psd)
+            psd = &ownPsd;
+        if (!preserveOrderMode) {
+            if (res->off.isStdMode())
+                psd->addStream(pgrcIn, res->off.stdValues);
+            else
+                psd->addStream(pgrcIn, res->off.minValues);
+        }
         if (!disableRevCompl)
-            readCompressed(pgrcIn, res->revComp);
+            psd->addStream(pgrcIn, res->revComp);
         if (!disableMismatches) {
-            readCompressed(pgrcIn, res->misCnt);
-            readCompressed(pgrcIn, res->misSymCode);
+            psd->addStream(pgrcIn, res->misCnt);
+            psd->addStream(pgrcIn, res->misSymCode);
             uint8_t mismatchesCountSrcsLimit = 0;
             PgSAHelpers::readValue<uint8_t>(pgrcIn, mismatchesCountSrcsLimit, false);
             vector<uint8_t> misCnt2SrcIdx(UINT8_MAX, mismatchesCountSrcsLimit);
             for (uint8_t m = 1; m < mismatchesCountSrcsLimit; m++)
                 PgSAHelpers::readValue<uint8_t>(pgrcIn, misCnt2SrcIdx[m], false);
-            vector<uint8_t> srcs[UINT8_MAX];
-            vector<uint_reads_cnt_std> srcCounter(UINT8_MAX, 0);
-            for (uint8_t m = 1; m <= mismatchesCountSrcsLimit; m++) {
-                *logout << (int) m << ": ";
-                readCompressed(pgrcIn, srcs[m]);
-            }
-            res->misOff.reserve(res->misSymCode.size());
-            for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
-                uint8_t misCnt = res->misCnt[i];
-                uint8_t srcIdx = misCnt2SrcIdx[misCnt];
-                uint64_t misOffStartIdx = res->misOff.size();
-                for (uint8_t m = 0; m < misCnt; m++)
-                    res->misOff.push_back(srcs[srcIdx][srcCounter[srcIdx]++]);
-                PgSAHelpers::convertMisRevOffsets2Offsets<uint8_t>(res->misOff.data() + misOffStartIdx,
-                                                                   res->misCnt[i], res->readLength);
-            }
+            if (!res->misOff.isStdMode())
+                addMismatchesOffsetsStreams<uint_read_len_min>(psd, pgrcIn, res, readsCount, misCnt2SrcIdx, mismatchesCountSrcsLimit);
+            else
+                addMismatchesOffsetsStreams<uint_read_len_std>(psd, pgrcIn, res, readsCount, misCnt2SrcIdx, mismatchesCountSrcsLimit);
         }
         if (!validationPgPrefix.empty()) {
             std::ifstream in((validationPgPrefix + SeparatedPseudoGenomeBase::READSLIST_ORIGINAL_INDEXES_FILE_SUFFIX).c_str(), std::ifstream::binary);
-            res->orgIdx.resize(readsCount);
-            readArray(in, res->orgIdx.data(), readsCount * sizeof(uint_reads_cnt_std));
+            readOriginalIndexes(in, res->orgIdx, readsCount);
+        }
+        // with an external decompressor the list is complete (and reported) only after its decompress call
+        if (psd == &ownPsd) {
+            ownPsd.decompress();
+            cout << "Loaded Pg reads list containing " << readsCount << " reads." << endl;
         }
-        cout << "Loaded Pg reads list containing " << readsCount << " reads." << endl;
         return res;
     }
 
@@ -359,12 +399,12 @@ namespace PgTools {
         return !this->misCumCount.empty() || !this->misOff.empty();
     }
 
-    bool ExtendedReadsListWithConstantAccessOption::getRevComp(uint_reads_cnt_std idx) {
+    bool ExtendedReadsListWithConstantAccessOption::getRevComp(uint_reads_cnt_max idx) {
         return isRevCompEnabled()?revComp[idx]:false;
     }
 
     void ExtendedReadsListWithConstantAccessOption::enableConstantAccess(bool disableIterationMode) {
-        if (pos.empty()) {
+        if (pos.empty() && !off.empty()) {
             pos.reserve(readsCount + 1);
             uint_pg_len_max currPos = 0;
             for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
@@ -6,6 +6,8 @@
 #include "../../utils/SymbolsPackingFacility.h"
 #include "../DefaultPseudoGenome.h"
 
+class ParallelStreamsDecompressor;
+
 namespace PgTools {
 
     template<int maxMismatches>
@@ -14,6 +16,51 @@ namespace PgTools {
     typedef SeparatedExtendedReadsListIterator<UINT8_MAX> DefaultSeparatedExtendedReadsListIterator;
     typedef SeparatedExtendedReadsListIterator<0> SimpleSeparatedReadsListIterator;
 
+    // read length values are stored in single bytes for reads up to 255 bases
+    class ReadLengthValues {
+        bool stdMode;
+    public:
+        vector<uint_read_len_min> minValues;
+        vector<uint_read_len_std> stdValues;
+
+        ReadLengthValues(uint_read_len_max readLength) : stdMode(!PgSAReadsSet::isReadLengthMin(readLength)) {}
+
+        bool isStdMode() const { return stdMode; }
+
+        template<typename uint_read_len>
+        vector<uint_read_len> &getValues();
+
+        inline uint_read_len_max operator[](uint64_t idx) const {
+            return stdMode ? stdValues[idx] : minValues[idx];
+        }
+
+        inline void set(uint64_t idx, uint_read_len_max value) {
+            if (stdMode)
+                stdValues[idx] = value;
+            else
+                minValues[idx] = value;
+        }
+
+        void push_back(uint_read_len_max value) {
+            if (stdMode)
+                stdValues.push_back(value);
+            else
+                minValues.push_back(value);
+        }
+
+        void reserve(uint64_t count) { stdMode ? stdValues.reserve(count) : minValues.reserve(count); }
+        void resize(uint64_t count) { stdMode ? stdValues.resize(count) : minValues.resize(count); }
+        uint64_t size() const { return stdMode ? stdValues.size() : minValues.size(); }
+        bool empty() const { return size() == 0; }
+        void clear() { minValues.clear(); stdValues.clear(); }
+    };
+
+    template<>
+    inline vector<uint_read_len_min> &ReadLengthValues::getValues<uint_read_len_min>() { return minValues; }
+
+    template<>
+    inline vector<uint_read_len_std> &ReadLengthValues::getValues<uint_read_len_std>() { return stdValues; }
+
     class ExtendedReadsListWithConstantAccessOption : public DefaultReadsListIteratorInterface {
 
         DefaultReadsListEntry entry;
@@ -23,20 +70,21 @@ namespace PgTools {
     public:
 
         uint_read_len_max readLength;
-        uint_reads_cnt_std readsCount;
+        uint_reads_cnt_max readsCount;
 
-        vector<uint_read_len_min> off;
-        vector<uint_reads_cnt_std> orgIdx;
+        ReadLengthValues off;
+        ReadsIndexValues orgIdx;
         vector<uint8_t> revComp;
         vector<uint_read_len_min> misCnt;
         vector<uint8_t> misSymCode;
-        vector<uint_read_len_min> misOff;
+        ReadLengthValues misOff;
 
         // constant access features
         vector<uint_pg_len_max> pos;
-        vector<uint_reads_cnt_max> misCumCount;
+        ReadsIndexValues misCumCount;
 
-        ExtendedReadsListWithConstantAccessOption(uint_read_len_max readLength) : readLength(readLength) {}
+        ExtendedReadsListWithConstantAccessOption(uint_read_len_max readLength) : readLength(readLength),
+                off(readLength), misOff(readLength) {}
 
         virtual ~ExtendedReadsListWithConstantAccessOption() {};
 
@@ -52,7 +100,7 @@ namespace PgTools {
             return misSymCode[misCumCount[rlIdx] + misIdx];
         }
 
-        inline uint8_t getMisOff(uint_reads_cnt_max rlIdx, uint8_t misIdx) {
+        inline uint_read_len_max getMisOff(uint_reads_cnt_max rlIdx, uint8_t misIdx) {
             return misOff[misCumCount[rlIdx] + misIdx];
         }
 
@@ -76,9 +124,11 @@ namespace PgTools {
                                                                                     uint_pg_len_max pgLengthPosGuard = 0,
                                                                                     bool skipMismatches = false);
 
+        // if psd is provided, the reads list is complete after psd->decompress() is called
         static ExtendedReadsListWithConstantAccessOption *loadConstantAccessExtendedReadsList(istream &pgrcIn,
                 PseudoGenomeHeader *pgh, ReadsSetProperties *rsProp, const string validationPgPrefix = "",
-                bool preserveOrderMode = false, bool disableRevCompl = false, bool disableMismatches = false);
+                bool preserveOrderMode = false, bool disableRevCompl = false, bool disableMismatches = false,
+                ParallelStreamsDecompressor *psd = 0);
 
         static ExtendedReadsListWithConstantAccessOption *loadConstantAccessExtendedReadsList(
                 DefaultSeparatedExtendedReadsListIterator &rl,
@@ -88,7 +138,7 @@ namespace PgTools {
 
         bool areMismatchesEnabled();
 
-        bool getRevComp(uint_reads_cnt_std idx);
+        bool getRevComp(uint_reads_cnt_max idx);
     };
 
     template<int maxMismatches>
@@ -166,7 +216,8 @@ namespace PgTools {
         loadConstantAccessExtendedReadsList(istream &pgrcIn,
                                             PseudoGenomeHeader *pgh, ReadsSetProperties *rsProp,
                                             const string validationPgPrefix,
-                                            bool preserveOrderMode, bool disableRevCompl, bool disableMismatches);
+                                            bool preserveOrderMode, bool disableRevCompl, bool disableMismatches,
+                                            ParallelStreamsDecompressor *psd);
     };
 
 }
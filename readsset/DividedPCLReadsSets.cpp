@@ -1,6 +1,9 @@
 #include "DividedPCLReadsSets.h"
 
 #include "iterator/DivisionReadsSetDecorators.h"
+#include "persistance/ReadsSetPersistence.h"
+
+#include <thread>
 
 namespace PgTools {
     static const char *const DNA_SYMBOLS = "ACGT";
@@ -59,26 +62,29 @@ namespace PgTools {
     DividedPCLReadsSets::getQualityDivisionBasedReadsSets(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt,
                                                           uint_read_len_max readLength,
                                                           double error_limit, bool separateNReadsSet, bool nReadsLQ) {
+        if (numberOfThreads > 1)
+            return getQualityDivisionBasedReadsSetsInParallel(readsIt, readLength, error_limit, separateNReadsSet,
+                    nReadsLQ);
         DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, separateNReadsSet, nReadsLQ);
         time_checkpoint();
         QualityDividingReadsSetIterator<uint_read_len_max> *divReadsIt =
                 new QualityDividingReadsSetIterator<uint_read_len_max>(readsIt, error_limit);
-        vector<uint_reads_cnt_max> lqMapping, nMapping;
+        ReadsIndexValues lqMapping, nMapping;
         while (divReadsIt->moveNext()) {
             if (separateNReadsSet || nReadsLQ) {
                 if (divReadsIt->containsN()) {
                     (separateNReadsSet ? readsSets->nReadsSet : readsSets->lqReadsSet)->addRead(
-                            divReadsIt->getRead().data(), divReadsIt->getReadLength());
+                            divReadsIt->peekRead(), divReadsIt->getReadLength());
                     (separateNReadsSet ? nMapping : lqMapping).push_back(divReadsIt->getReadOriginalIndex());
                     continue;
                 }
             }
             if (!divReadsIt->isQualityHigh()) {
                 readsSets->lqReadsSet->addRead(
-                        divReadsIt->getRead().data(), divReadsIt->getReadLength());
+                        divReadsIt->peekRead(), divReadsIt->getReadLength());
                 lqMapping.push_back(divReadsIt->getReadOriginalIndex());
             } else {
-                readsSets->hqReadsSet->addRead(divReadsIt->getRead().data(), divReadsIt->getReadLength());
+                readsSets->hqReadsSet->addRead(divReadsIt->peekRead(), divReadsIt->getReadLength());
             }
         };
         cout << "Filtered " << (lqMapping.size() + nMapping.size());
@@ -96,6 +102,152 @@ namespace PgTools {
         return readsSets;
     }
 
+    // total size of read and quality buffers of all ingest chunks (independent of the number of threads)
+    const static size_t INGEST_BUFFERS_BYTES = (size_t) 256 << 20;
+    const static uint_reads_cnt_max INGEST_CHUNK_MAX_READS_COUNT = 1 << 16;
+
+    const static uint8_t HQ_READ_CLASS = 0;
+    const static uint8_t LQ_READ_CLASS = 1;
+    const static uint8_t N_READ_CLASS = 2;
+    const static uint8_t READ_CLASSES_COUNT = 3;
+
+    struct IngestChunk {
+        uint_reads_cnt_max readsCount = 0;
+        string reads;
+        string qualities;
+        vector<uint8_t> qualityAvailable;
+
+        vector<uint8_t> readClass;
+        uint_reads_cnt_max classBegIdx[READ_CLASSES_COUNT];
+    };
+
+    // returns false if the source is exhausted
+    static bool readIngestChunks(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt,
+                                 uint_read_len_max readLength, uint_reads_cnt_max chunkReadsCount,
+                                 vector<IngestChunk> &chunks) {
+        for(IngestChunk &chunk: chunks)
+            chunk.readsCount = 0;
+        for(IngestChunk &chunk: chunks) {
+            while (chunk.readsCount < chunkReadsCount) {
+                if (!readsIt->moveNext())
+                    return false;
+                if (readsIt->getReadLength() != readLength) {
+                    fprintf(stderr, "Unsupported variable length reads.\n");
+                    exit(EXIT_FAILURE);
+                }
+                const size_t offset = (size_t) chunk.readsCount * readLength;
+                memcpy((char*) chunk.reads.data() + offset, readsIt->peekRead(), readLength);
+                const char* quality = readsIt->peekQualityInfo();
+                chunk.qualityAvailable[chunk.readsCount] = quality != 0;
+                if (quality)
+                    memcpy((char*) chunk.qualities.data() + offset, quality, readLength);
+                chunk.readsCount++;
+            }
+        }
+        return true;
+    }
+
+    DividedPCLReadsSets*
+    DividedPCLReadsSets::getQualityDivisionBasedReadsSetsInParallel(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt,
+                                                                    uint_read_len_max readLength, double error_limit,
+                                                                    bool separateNReadsSet, bool nReadsLQ) {
+        DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, separateNReadsSet, nReadsLQ);
+        time_checkpoint();
+        PackedConstantLengthReadsSet* classReadsSets[READ_CLASSES_COUNT] =
+                { readsSets->hqReadsSet, readsSets->lqReadsSet, readsSets->nReadsSet };
+        ReadsIndexValues lqMapping, nMapping;
+        ReadsIndexValues* classMappings[READ_CLASSES_COUNT] = { 0, &lqMapping, &nMapping };
+        const bool checkN = separateNReadsSet || nReadsLQ;
+        const uint8_t nReadClass = separateNReadsSet ? N_READ_CLASS : LQ_READ_CLASS;
+
+        // chunks are read (and parsed) by a producer thread while the previous ones are classified and packed
+        const size_t chunksCount = numberOfThreads * 2;
+        const size_t chunkReadBytes = (size_t) readLength * 2 + 2;
+        const uint_reads_cnt_max chunkReadsCount = std::max<size_t>(1, std::min<size_t>(INGEST_CHUNK_MAX_READS_COUNT,
+                INGEST_BUFFERS_BYTES / (2 * chunksCount * chunkReadBytes)));
+        vector<IngestChunk> chunks(chunksCount), nextChunks(chunksCount);
+        for(vector<IngestChunk>* chunksPtr: { &chunks, &nextChunks }) {
+            for (IngestChunk &chunk: *chunksPtr) {
+                chunk.reads.resize((size_t) chunkReadsCount * readLength);
+                chunk.qualities.resize((size_t) chunkReadsCount * readLength);
+                chunk.qualityAvailable.resize(chunkReadsCount);
+                chunk.readClass.resize(chunkReadsCount);
+            }
+        }
+        bool sourceAvailable = readIngestChunks(readsIt, readLength, chunkReadsCount, chunks);
+        uint_reads_cnt_max readsTotalCount = 0;
+        while (chunks[0].readsCount > 0) {
+            std::thread producer;
+            if (sourceAvailable)
+                producer = std::thread([&]() { sourceAvailable = readIngestChunks(readsIt, readLength, chunkReadsCount, nextChunks); });
+            else
+                for (IngestChunk &chunk: nextChunks)
+                    chunk.readsCount = 0;
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(numberOfThreads)
+            for(int c = 0; c < (int) chunks.size(); c++) {
+                IngestChunk &chunk = chunks[c];
+                for(uint_reads_cnt_max i = 0; i < chunk.readsCount; i++) {
+                    const size_t offset = (size_t) i * readLength;
+                    if (checkN && memchr(chunk.reads.data() + offset, 'N', readLength))
+                        chunk.readClass[i] = nReadClass;
+                    else if (chunk.qualityAvailable[i] &&
+                            qualityScoreErrorExceeds(chunk.qualities.data() + offset, readLength, error_limit))
+                        chunk.readClass[i] = LQ_READ_CLASS;
+                    else
+                        chunk.readClass[i] = HQ_READ_CLASS;
+                }
+            }
+            uint_reads_cnt_max classReadsCount[READ_CLASSES_COUNT];
+            for(uint8_t rc = 0; rc < READ_CLASSES_COUNT; rc++)
+                classReadsCount[rc] = classReadsSets[rc] ? classReadsSets[rc]->readsCount() : 0;
+            for(IngestChunk &chunk: chunks) {
+                for(uint8_t rc = 0; rc < READ_CLASSES_COUNT; rc++)
+                    chunk.classBegIdx[rc] = classReadsCount[rc];
+                for(uint_reads_cnt_max i = 0; i < chunk.readsCount; i++)
+                    classReadsCount[chunk.readClass[i]]++;
+            }
+            uint_reads_cnt_max batchReadsTotalCount = readsTotalCount;
+            for(IngestChunk &chunk: chunks)
+                batchReadsTotalCount += chunk.readsCount;
+            for(uint8_t rc = 0; rc < READ_CLASSES_COUNT; rc++) {
+                if (!classReadsSets[rc])
+                    continue;
+                classReadsSets[rc]->resize(classReadsCount[rc]);
+                if (classMappings[rc]) {
+                    classMappings[rc]->adjustMode(batchReadsTotalCount);
+                    classMappings[rc]->resize(classReadsCount[rc]);
+                }
+            }
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(numberOfThreads)
+            for(int c = 0; c < (int) chunks.size(); c++) {
+                IngestChunk &chunk = chunks[c];
+                uint_reads_cnt_max orgIdx = readsTotalCount + (uint_reads_cnt_max) c * chunkReadsCount;
+                for(uint_reads_cnt_max i = 0; i < chunk.readsCount; i++, orgIdx++) {
+                    const uint8_t rc = chunk.readClass[i];
+                    const uint_reads_cnt_max destIdx = chunk.classBegIdx[rc]++;
+                    classReadsSets[rc]->packRead(chunk.reads.data() + (size_t) i * readLength, readLength, destIdx);
+                    if (classMappings[rc])
+                        classMappings[rc]->set(destIdx, orgIdx);
+                }
+            }
+            readsTotalCount = batchReadsTotalCount;
+            if (producer.joinable())
+                producer.join();
+            chunks.swap(nextChunks);
+        }
+        cout << "Filtered " << (lqMapping.size() + nMapping.size());
+        if (separateNReadsSet)
+            cout << " (including " << nMapping.size() << " containing N)";
+        cout << " reads (out of " << readsTotalCount << ") in " << time_millis() << " msec." << endl;
+        *logout << endl;
+
+        readsSets->lqMapping = new VectorMapping(std::move(lqMapping), readsTotalCount);
+        if (separateNReadsSet)
+            readsSets->nMapping = new VectorMapping(std::move(nMapping), readsTotalCount);
+
+        return readsSets;
+    }
+
     DividedPCLReadsSets *
     DividedPCLReadsSets::getSimpleDividedPCLReadsSets(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt,
                                                       uint_read_len_max readLength, bool separateNReadsSet,
@@ -104,7 +256,7 @@ namespace PgTools {
             return DividedPCLReadsSets::getQualityDivisionBasedReadsSets(readsIt, readLength, 1, separateNReadsSet, nReadsLQ);
         DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, false, false);
         while (readsIt->moveNext()) {
-            readsSets->hqReadsSet->addRead(readsIt->getRead().data(), readsIt->getReadLength());
+            readsSets->hqReadsSet->addRead(readsIt->peekRead(), readsIt->getReadLength());
         }
         readsSets->lqMapping = new VectorMapping({}, readsSets->hqReadsSet->readsCount());
         return readsSets;
@@ -125,14 +277,14 @@ namespace PgTools {
         uint_reads_cnt_max nCounter = 0;
         while (readsIt->moveNext()) {
             if (readsSets->lqMapping->getReadOriginalIndex(lqCounter) == allCounter) {
-                readsSets->lqReadsSet->addRead(readsIt->getRead().data(), readsIt->getReadLength());
+                readsSets->lqReadsSet->addRead(readsIt->peekRead(), readsIt->getReadLength());
                 lqCounter++;
             } else if (separateNReadsSet &&
                     readsSets->nMapping->getReadOriginalIndex(nCounter) == allCounter) {
-                readsSets->nReadsSet->addRead(readsIt->getRead().data(), readsIt->getReadLength());
+                readsSets->nReadsSet->addRead(readsIt->peekRead(), readsIt->getReadLength());
                 nCounter++;
             } else if (!skipHQReadsSet)
-                readsSets->hqReadsSet->addRead(readsIt->getRead().data(), readsIt->getReadLength());
+                readsSets->hqReadsSet->addRead(readsIt->peekRead(), readsIt->getReadLength());
             allCounter++;
         }
 
@@ -152,10 +304,10 @@ namespace PgTools {
         uint_reads_cnt_max lqCounter = lqReadsSet->readsCount();
         bool ignoreLqSet = (lqCounter-- == 0);
         lqReadsSet->resize(newLqCounter);
-        vector<uint_reads_cnt_max> &lqReadIdx = lqMapping->getMappingVector();
+        ReadsIndexValues &lqReadIdx = lqMapping->getMappingVector();
         lqReadIdx.resize(newLqCounter + 1);
         uint_reads_cnt_max allCounter = lqMapping->getReadsTotalCount();
-        lqReadIdx[newLqCounter--] = allCounter;
+        lqReadIdx.set(newLqCounter--, allCounter);
         uint_reads_cnt_max nCounter = separateNReadsSet?nReadsSet->readsCount():0;
         bool ignoreNSet = (nCounter-- == 0);
         uint_reads_cnt_max hqCounter = hqReadsSet->readsCount();
@@ -170,7 +322,7 @@ namespace PgTools {
             if (!ignoreLqSet) {
                 if(lqMapping->getReadOriginalIndex(lqCounter) == allCounter) {
                     lqReadsSet->copyRead(lqCounter, newLqCounter);
-                    lqReadIdx[newLqCounter] = allCounter;
+                    lqReadIdx.set(newLqCounter, allCounter);
                     ignoreLqSet = (lqCounter-- == 0);
                     if (newLqCounter-- == 0)
                         break;
@@ -179,7 +331,7 @@ namespace PgTools {
             }
             if (!isReadHqInHqReadsSet[--hqCounter]) {
                 lqReadsSet->copyPackedRead(hqReadsSet->getPackedRead(hqCounter), newLqCounter);
-                lqReadIdx[newLqCounter] = allCounter;
+                lqReadIdx.set(newLqCounter, allCounter);
                 if (newLqCounter-- == 0)
                     break;
             }
@@ -193,8 +345,57 @@ namespace PgTools {
         hqReadsSet->resize(hqReadsSet->readsCount() - readsToMoveCount);
     }
 
+    void DividedPCLReadsSets::writeReadsStore(const string &storeFile) {
+        std::ofstream dest(storeFile, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (dest.fail()) {
+            fprintf(stderr, "cannot write to reads store file %s\n", storeFile.c_str());
+            exit(EXIT_FAILURE);
+        }
+        time_checkpoint();
+        const uint_read_len_max readLength = hqReadsSet->maxReadLength();
+        const uint_reads_cnt_max readsCount = lqMapping->getReadsTotalCount();
+        const size_t packedReadLength = ReadsSetPersistence::packedReadsStoreReadLength(readLength);
+        ReadsSetPersistence::writePackedReadsStoreHeader(dest, readLength, readsCount);
+        const ReadsIndexValues &lqIdxs = lqMapping->getMappingVector();
+        ReadsIndexValues noNIdxs(readsCount);
+        noNIdxs.push_back(readsCount);
+        const ReadsIndexValues &nIdxs = separateNReadsSet ? nMapping->getMappingVector() : noNIdxs;
+        const uint_reads_cnt_max chunksCount = (readsCount + INGEST_CHUNK_MAX_READS_COUNT - 1) / INGEST_CHUNK_MAX_READS_COUNT;
+        vector<string> packedChunks(numberOfThreads);
+        for(uint_reads_cnt_max batchBeg = 0; batchBeg < chunksCount; batchBeg += numberOfThreads) {
+            const int batchSize = batchBeg + numberOfThreads < chunksCount ? numberOfThreads : chunksCount - batchBeg;
+            #pragma omp parallel for schedule(static, 1) num_threads(numberOfThreads)
+            for(int c = 0; c < batchSize; c++) {
+                const uint_reads_cnt_max beg = (batchBeg + c) * INGEST_CHUNK_MAX_READS_COUNT;
+                const uint_reads_cnt_max end = beg + INGEST_CHUNK_MAX_READS_COUNT < readsCount ?
+                        beg + INGEST_CHUNK_MAX_READS_COUNT : readsCount;
+                uint_reads_cnt_max lqCounter = lqIdxs.lowerBound(beg);
+                uint_reads_cnt_max nCounter = nIdxs.lowerBound(beg);
+                uint_reads_cnt_max hqCounter = beg - lqCounter - nCounter;
+                string &packed = packedChunks[c];
+                packed.resize((end - beg) * packedReadLength);
+                string read(readLength, ' ');
+                char_pg* readPtr = (char_pg*) &read[0];
+                for(uint_reads_cnt_max i = beg; i < end; i++) {
+                    if (lqIdxs[lqCounter] == i)
+                        lqReadsSet->getRead(lqCounter++, readPtr);
+                    else if (nIdxs[nCounter] == i)
+                        nReadsSet->getRead(nCounter++, readPtr);
+                    else
+                        hqReadsSet->getRead(hqCounter++, readPtr);
+                    SymbolsPackingFacility::ACGTNPacker.packSequence(readPtr, readLength,
+                            (uint8_t*) &packed[(i - beg) * packedReadLength]);
+                }
+            }
+            for(int c = 0; c < batchSize; c++)
+                dest.write(packedChunks[c].data(), packedChunks[c].size());
+        }
+        dest.close();
+        *logout << "Stored " << readsCount << " reads in " << time_millis() << " msec." << endl;
+    }
+
     IndexesMapping* DividedPCLReadsSets::generateHqReadsIndexesMapping() {
-        vector<uint_reads_cnt_max> hqReadIdx;
+        ReadsIndexValues hqReadIdx(lqMapping->getReadsTotalCount());
 //        hqReadIdx.reserve(lqMapping->getReadsTotalCount() -
 //            lqReadsSet->readsCount() - (separateNReadsSet?nReadsSet->readsCount():0));
         int64_t allCounter = -1;
@@ -213,32 +414,32 @@ namespace PgTools {
     }
 
     void DividedPCLReadsSets::removeReadsFromLqReadsSet(const vector<bool> &isLqReadMappedIntoHqPg) {
-        vector<uint_reads_cnt_max> &lqReadIdx = lqMapping->getMappingVector();
+        ReadsIndexValues &lqReadIdx = lqMapping->getMappingVector();
         uint_reads_cnt_max newLqCounter = 0;
         for(uint_reads_cnt_max lqCounter = 0; lqCounter < lqReadsSet->readsCount(); lqCounter++) {
             if (!isLqReadMappedIntoHqPg[lqCounter]) {
-                lqReadIdx[newLqCounter] = lqReadIdx[lqCounter];
+                lqReadIdx.set(newLqCounter, lqReadIdx[lqCounter]);
                 lqReadsSet->copyRead(lqCounter, newLqCounter++);
             }
         }
         lqReadsSet->resize(newLqCounter);
-        lqReadIdx[newLqCounter++] = lqMapping->getReadsTotalCount();
+        lqReadIdx.set(newLqCounter++, lqMapping->getReadsTotalCount());
         lqReadIdx.resize(newLqCounter);
     }
 
 
     void DividedPCLReadsSets::removeReadsFromNReadsSet(const vector<bool> &isReadMappedIntoHqPg,
             uint_reads_cnt_max nBegIdx) {
-        vector<uint_reads_cnt_max> &nReadIdx = nMapping->getMappingVector();
+        ReadsIndexValues &nReadIdx = nMapping->getMappingVector();
         uint_reads_cnt_max newNCounter = 0;
         for(uint_reads_cnt_max nCounter = 0; nCounter < nReadsSet->readsCount(); nCounter++) {
             if (!isReadMappedIntoHqPg[nCounter + nBegIdx]) {
-                nReadIdx[newNCounter] = nReadIdx[nCounter];
+                nReadIdx.set(newNCounter, nReadIdx[nCounter]);
                 nReadsSet->copyRead(nCounter, newNCounter++);
             }
         }
         nReadsSet->resize(newNCounter);
-        nReadIdx[newNCounter++] = nMapping->getReadsTotalCount();
+        nReadIdx.set(newNCounter++, nMapping->getReadsTotalCount());
         nReadIdx.resize(newNCounter);
     }
 
@@ -18,6 +18,10 @@ namespace PgTools {
         VectorMapping* lqMapping = 0;
         VectorMapping* nMapping = 0;
 
+        static DividedPCLReadsSets* getQualityDivisionBasedReadsSetsInParallel(
+                ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt, uint_read_len_max readLength,
+                double error_limit, bool separateNReadsSet, bool nReadsLQ);
+
     public:
         DividedPCLReadsSets(uint_read_len_max readLength, bool separateNReadsSet = false, bool nReadsLQ = false);
 
@@ -50,6 +54,9 @@ namespace PgTools {
 
         IndexesMapping *generateHqReadsIndexesMapping();
 
+        // writes all reads in original order (see ReadsSetPersistence::createPackedReadsStoreIterator)
+        void writeReadsStore(const string &storeFile);
+
         void removeReadsFromLqReadsSet(const vector<bool> &isLqReadMappedIntoHqPg);
         void removeReadsFromNReadsSet(const vector<bool> &isReadMappedIntoHqPg,
                                                            uint_reads_cnt_max nBegIdx);
@@ -2,6 +2,10 @@
 
 #include "tools/ReadsSetAnalyzer.h"
 
+#define XXH_INLINE_ALL
+#define XXH_PRIVATE_API
+#include "../matching/copmem/xxhash.h"
+
 namespace PgSAReadsSet {
 
     PackedConstantLengthReadsSet::PackedConstantLengthReadsSet(uint_read_len_max readLength, const char *symbolsList,
@@ -56,6 +60,34 @@ namespace PgSAReadsSet {
                   packedReads.begin() + (size_t) packedLength * destIdx);
     }
 
+    void PackedConstantLengthReadsSet::packRead(const char *read, uint_read_len_max readLength,
+                                                uint_reads_cnt_max destIdx) {
+        if (readLength != properties->minReadLength) {
+            fprintf(stderr, "Unsupported variable length reads.\n");
+            exit(EXIT_FAILURE);
+        }
+        sPacker->packSequence(read, readLength, packedReads.data() + (size_t) packedLength * destIdx);
+    }
+
+    PackedConstantLengthReadsSet* PackedConstantLengthReadsSet::getCopyWithReverseComplements() {
+        PackedConstantLengthReadsSet* res = new PackedConstantLengthReadsSet(properties->maxReadLength,
+                properties->symbolsList, properties->symbolsCount);
+        const uint_reads_cnt_max readsCount = properties->readsCount;
+        res->resize(2 * readsCount);
+        res->copyPackedRead(packedReads.data(), 0, readsCount);
+        #pragma omp parallel num_threads(numberOfThreads)
+        {
+            string read(properties->maxReadLength, ' ');
+            #pragma omp for schedule(static)
+            for (int64_t i = 0; i < (int64_t) readsCount; i++) {
+                getRead(i, &read[0]);
+                reverseComplementInPlace(read);
+                res->packRead(read.data(), read.length(), readsCount + i);
+            }
+        }
+        return res;
+    }
+
     template<class ReadsSourceIterator>
     PackedConstantLengthReadsSet* PackedConstantLengthReadsSet::loadReadsSet(ReadsSourceIterator* readsIterator,
                                                                              ReadsSetProperties *properties) {
@@ -76,7 +108,7 @@ namespace PgSAReadsSet {
 
         readsIterator->rewind();
         while (readsIterator->moveNext())
-            readsSet->addRead(readsIterator->getRead().data(), properties->minReadLength);
+            readsSet->addRead(readsIterator->peekRead(), properties->minReadLength);
 
         if (ownProperties)
             delete(properties);
@@ -97,6 +129,15 @@ namespace PgSAReadsSet {
         return sPacker->compareSequences(packedReads.data() + lIdx * (size_t) packedLength, packedReads.data() + rIdx * (size_t) packedLength, offset, properties->maxReadLength - offset);
     }
 
+    uint64_t PackedConstantLengthReadsSet::hashPackedRead(uint_reads_cnt_max i) {
+        return XXH64(packedReads.data() + i * (size_t) packedLength, packedLength, 0);
+    }
+
+    bool PackedConstantLengthReadsSet::equalPackedReads(uint_reads_cnt_max lIdx, uint_reads_cnt_max rIdx) {
+        return memcmp(packedReads.data() + lIdx * (size_t) packedLength, packedReads.data() + rIdx * (size_t) packedLength,
+                packedLength) == 0;
+    }
+
     int PackedConstantLengthReadsSet::compareSuffixWithPrefix(uint_reads_cnt_max sufIdx, uint_reads_cnt_max preIdx, uint_read_len_max sufOffset) {
         return sPacker->compareSuffixWithPrefix(packedReads.data() + sufIdx * (size_t) packedLength, packedReads.data() + preIdx * (size_t) packedLength, sufOffset, properties->maxReadLength - sufOffset);
     }
@@ -15,7 +15,7 @@ namespace PgSAReadsSet {
     {
         private:
             vector<uint_ps_element_min> packedReads;
-            uchar packedLength;
+            size_t packedLength;
 
         public:
 
@@ -30,6 +30,10 @@ namespace PgSAReadsSet {
             void copyRead(uint_reads_cnt_max srcIdx, uint_reads_cnt_max destIdx, uint_reads_cnt_max n = 1);
             void copyPackedRead(const uint_ps_element_min *packedSequence, uint_reads_cnt_max destIdx,
                     uint_reads_cnt_max n = 1);
+            // thread-safe for distinct destIdx (requires resize in advance)
+            void packRead(const char* read, uint_read_len_max readLength, uint_reads_cnt_max destIdx);
+            // reads of the copy are followed by their reverse complements (in the same order)
+            PackedConstantLengthReadsSet* getCopyWithReverseComplements();
 
             inline uint_read_len_max minReadLength() { return properties->minReadLength; };
             inline uint_read_len_max maxReadLength() { return properties->maxReadLength; };
@@ -48,6 +52,9 @@ namespace PgSAReadsSet {
 
             int comparePackedReads(uint_reads_cnt_max lIdx, uint_reads_cnt_max rIdx);
             int comparePackedReads(uint_reads_cnt_max lIdx, uint_reads_cnt_max rIdx, uint_read_len_max offset);
+            // packed representation is unique for each read, so equal reads have equal hashes
+            uint64_t hashPackedRead(uint_reads_cnt_max i);
+            bool equalPackedReads(uint_reads_cnt_max lIdx, uint_reads_cnt_max rIdx);
             int compareSuffixWithPrefix(uint_reads_cnt_max sufIdx, uint_reads_cnt_max preIdx, uint_read_len_max sufOffset);
 
             int compareReadWithPattern(const uint_reads_cnt_max i, const char *pattern);
@@ -26,7 +26,8 @@ namespace PgTools {
 
     template<typename uint_read_len>
     bool QualityDividingReadsSetIterator<uint_read_len>::isQualityHigh() {
-        return (1 - qualityScore2correctProb(getQualityInfo()) <= error_level);
+        const char* quality = coreIterator->peekQualityInfo();
+        return quality == 0 || !qualityScoreErrorExceeds(quality, getReadLength(), error_level);
     }
 
     template<typename uint_read_len>
@@ -39,6 +40,16 @@ namespace PgTools {
         return coreIterator->getQualityInfo();
     }
 
+    template<typename uint_read_len>
+    const char* QualityDividingReadsSetIterator<uint_read_len>::peekRead() {
+        return coreIterator->peekRead();
+    }
+
+    template<typename uint_read_len>
+    const char* QualityDividingReadsSetIterator<uint_read_len>::peekQualityInfo() {
+        return coreIterator->peekQualityInfo();
+    }
+
     template<typename uint_read_len>
     uint_read_len QualityDividingReadsSetIterator<uint_read_len>::getReadLength() {
         return coreIterator->getReadLength();
@@ -57,7 +68,7 @@ namespace PgTools {
 
     template<typename uint_read_len>
     bool QualityDividingReadsSetIterator<uint_read_len>::containsN() {
-        return coreIterator->getRead().find('N') != string::npos;
+        return memchr(coreIterator->peekRead(), 'N', coreIterator->getReadLength()) != 0;
     }
 
     template<typename uint_read_len>
@@ -72,9 +83,16 @@ namespace PgTools {
             :coreIterator(coreIterator), divSource(divSource), visitComplement(visitComplement),
             ignoreNReads(ignoreNReads), ignoreNoNReads(ignoreNoNReads) {
         plainTextReadMode = confirmTextReadMode(*divSource);
+        readDivisionHeader();
+    }
+
+    template<typename uint_read_len>
+    void DividedReadsSetIterator<uint_read_len>::readDivisionHeader() {
         uint_reads_cnt_max readsCount = 0;
         readValue(*divSource, readsCount, plainTextReadMode);
-        readValue(*divSource, currentDivIdx, plainTextReadMode);
+        stdDivIdxs = isReadsCountStd(readsCount);
+        indexesMapping = ReadsIndexValues(readsCount);
+        currentDivIdx = ReadsIndexValues::readIndex(*divSource, stdDivIdxs, plainTextReadMode);
     }
 
     template<typename uint_read_len>
@@ -87,10 +105,10 @@ namespace PgTools {
                     return true;
                 }
 
-                readValue(*divSource, currentDivIdx, plainTextReadMode);
+                currentDivIdx = ReadsIndexValues::readIndex(*divSource, stdDivIdxs, plainTextReadMode);
             } else {
                 if (allCounter == currentDivIdx) {
-                    readValue(*divSource, currentDivIdx, plainTextReadMode);
+                    currentDivIdx = ReadsIndexValues::readIndex(*divSource, stdDivIdxs, plainTextReadMode);
                     if (!isIgnored()) {
                         indexesMapping.push_back(allCounter);
                         return true;
@@ -109,8 +127,10 @@ namespace PgTools {
 
     template<typename uint_read_len>
     bool DividedReadsSetIterator<uint_read_len>::isIgnored() {
-        return (ignoreNReads && coreIterator->getRead().find('N') != string::npos)
-            || (ignoreNoNReads && coreIterator->getRead().find('N') == string::npos);
+        if (!ignoreNReads && !ignoreNoNReads)
+            return false;
+        bool containsN = memchr(coreIterator->peekRead(), 'N', coreIterator->getReadLength()) != 0;
+        return (ignoreNReads && containsN) || (ignoreNoNReads && !containsN);
     }
 
     template<typename uint_read_len>
@@ -123,6 +143,16 @@ namespace PgTools {
         return coreIterator->getQualityInfo();
     }
 
+    template<typename uint_read_len>
+    const char* DividedReadsSetIterator<uint_read_len>::peekRead() {
+        return coreIterator->peekRead();
+    }
+
+    template<typename uint_read_len>
+    const char* DividedReadsSetIterator<uint_read_len>::peekQualityInfo() {
+        return coreIterator->peekQualityInfo();
+    }
+
     template<typename uint_read_len>
     uint_read_len DividedReadsSetIterator<uint_read_len>::getReadLength() {
         return coreIterator->getReadLength();
@@ -135,9 +165,7 @@ namespace PgTools {
         divSource->clear();
         divSource->seekg(0);
         confirmTextReadMode(*divSource);
-        uint_reads_cnt_max readsCount = 0;
-        readValue(*divSource, readsCount, plainTextReadMode);
-        readValue(*divSource, currentDivIdx, plainTextReadMode);
+        readDivisionHeader();
         coreIterator->rewind();
     }
 
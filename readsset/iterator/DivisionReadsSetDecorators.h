@@ -26,6 +26,9 @@ namespace PgTools {
         uint_read_len getReadLength();
         void rewind();
 
+        const char* peekRead() override;
+        const char* peekQualityInfo() override;
+
         bool isQualityHigh();
         bool containsN();
 
@@ -37,15 +40,17 @@ namespace PgTools {
     private:
         ReadsSourceIteratorTemplate<uint_read_len>* coreIterator;
         int64_t allCounter = -1;
-        uint64_t currentDivIdx;
+        uint_reads_cnt_max currentDivIdx;
         std::istream* divSource;
+        bool stdDivIdxs = true;
         bool visitComplement;
         bool ignoreNReads;
         bool ignoreNoNReads;
         bool plainTextReadMode = false;
 
-        vector<uint_reads_cnt_max> indexesMapping;
+        ReadsIndexValues indexesMapping;
         bool isIgnored();
+        void readDivisionHeader();
     public:
         DividedReadsSetIterator(ReadsSourceIteratorTemplate<uint_read_len> *coreIterator, std::istream* divSource,
                 bool visitComplement = false, bool ignoreNReads = false, bool ignoreNoNReads = false);
@@ -56,6 +61,9 @@ namespace PgTools {
         uint_read_len getReadLength();
         void rewind();
 
+        const char* peekRead() override;
+        const char* peekQualityInfo() override;
+
         IndexesMapping* retainVisitedIndexesMapping() override;
     };
 
@@ -1,5 +1,7 @@
 #include "ReadsSetIterator.h"
 
+#include "../../utils/GzipInputStream.h"
+
 namespace PgSAReadsSet {
 
     using namespace PgSAHelpers;
@@ -11,11 +13,11 @@ namespace PgSAReadsSet {
             exit(EXIT_FAILURE);
         }
         writeReadMode(mappingDest, PgSAHelpers::plainTextWriteMode);
-        writeValue(mappingDest, readsCount);
-        for(uint_reads_cnt_max orgIdx: this->mappingWithGuard) {
-            writeValue(mappingDest, orgIdx);
-        }
-        writeValue(mappingDest, readsCount);
+        writeValue<uint_reads_cnt_max>(mappingDest, readsCount);
+        const bool stdIdxs = isReadsCountStd(readsCount);
+        for(uint_reads_cnt_max i = 0; i < mappingWithGuard.size(); i++)
+            ReadsIndexValues::writeIndex(mappingDest, mappingWithGuard[i], stdIdxs);
+        ReadsIndexValues::writeIndex(mappingDest, readsCount, stdIdxs);
         mappingDest.close();
     }
 
@@ -28,17 +30,18 @@ namespace PgSAReadsSet {
         bool plainTextReadMode = confirmTextReadMode(*divSource);
         uint_reads_cnt_max readsCount;
         readValue(*divSource, readsCount, plainTextReadMode);
-        VectorMapping* mapping = new VectorMapping({}, readsCount);
+        const bool stdIdxs = isReadsCountStd(readsCount);
+        ReadsIndexValues mapping(readsCount);
         uint_reads_cnt_max orgIdx = 0;
         do {
-            readValue(*divSource, orgIdx, plainTextReadMode);
-            mapping->mappingWithGuard.push_back(orgIdx);
+            orgIdx = ReadsIndexValues::readIndex(*divSource, stdIdxs, plainTextReadMode);
+            mapping.push_back(orgIdx);
         } while (orgIdx != readsCount);
         delete(divSource);
-        return mapping;
+        return new VectorMapping(std::move(mapping), readsCount);
     }
 
-    vector<uint_reads_cnt_max> &VectorMapping::getMappingVector() {
+    ReadsIndexValues &VectorMapping::getMappingVector() {
         return mappingWithGuard;
     }
 
@@ -148,36 +151,102 @@ namespace PgSAReadsSet {
         return new DirectMapping(counter + 1);
     }
 
+    BufferedRecordsReader::BufferedRecordsReader(std::istream *source, size_t bufferSize): source(source) {
+        buffer.resize(bufferSize);
+    }
+
+    bool BufferedRecordsReader::refill() {
+        if (sourceExhausted)
+            return false;
+        if (begin > 0) {
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size())
+            buffer.resize(buffer.size() * 2);
+        source->read(buffer.data() + end, buffer.size() - end);
+        size_t readCount = source->gcount();
+        end += readCount;
+        if (readCount == 0)
+            sourceExhausted = true;
+        return readCount > 0;
+    }
+
+    bool BufferedRecordsReader::nextRecord(const char **lines, size_t *lengths, uint8_t linesCount) {
+        size_t lineStart[UINT8_MAX];
+        size_t recLen = 0;
+        uint8_t l = 0;
+        while (l < linesCount) {
+            const char* recPtr = buffer.data() + begin;
+            const char* eolPtr = (const char*) memchr(recPtr + recLen, '\n', end - begin - recLen);
+            if (eolPtr) {
+                lineStart[l] = recLen;
+                lengths[l++] = eolPtr - recPtr - recLen;
+                recLen = eolPtr - recPtr + 1;
+            } else if (!refill()) {
+                if (begin + recLen == end)
+                    break;
+                lineStart[l] = recLen;
+                lengths[l++] = end - begin - recLen;
+                recLen = end - begin;
+            }
+        }
+        if (l == 0)
+            return false;
+        for(uint8_t i = 0; i < linesCount; i++) {
+            lines[i] = buffer.data() + begin + (i < l ? lineStart[i] : recLen);
+            if (i >= l)
+                lengths[i] = 0;
+        }
+        begin += recLen;
+        return true;
+    }
+
+    void BufferedRecordsReader::rewind() {
+        begin = 0;
+        end = 0;
+        sourceExhausted = false;
+    }
+
     template<typename uint_read_len>
     FASTQReadsSourceIterator<uint_read_len>::FASTQReadsSourceIterator(const string &srcFile, const string &pairFile) {
         ownStreams = true;
-        source = new ifstream(srcFile, ios_base::in | ios_base::binary);
+        source = openPlainOrGzipInputStream(srcFile);
         if (source->fail()) {
             fprintf(stderr, "cannot open reads file %s\n", srcFile.c_str());
             exit(EXIT_FAILURE);
         }
         if (pairFile != "") {
-            pairSource = new ifstream(pairFile, ios_base::in | ios_base::binary);
+            pairSource = openPlainOrGzipInputStream(pairFile);
             if (pairSource->fail()) {
                 fprintf(stderr, "cannot open reads pair file %s\n", pairFile.c_str());
                 exit(EXIT_FAILURE);
             }
         }
+        initReaders();
     }
 
     template<typename uint_read_len>
-    FASTQReadsSourceIterator<uint_read_len>::FASTQReadsSourceIterator(std::ifstream* source, std::ifstream* pairSource) {
+    FASTQReadsSourceIterator<uint_read_len>::FASTQReadsSourceIterator(std::istream* source, std::istream* pairSource) {
         ownStreams = false;
         this->source = source;
         this->pairSource = pairSource;
+        initReaders();
+    }
+
+    template<typename uint_read_len>
+    void FASTQReadsSourceIterator<uint_read_len>::initReaders() {
+        reader = new BufferedRecordsReader(source);
+        if (pairSource)
+            pairReader = new BufferedRecordsReader(pairSource);
     }
 
     template<typename uint_read_len>
     FASTQReadsSourceIterator<uint_read_len>::~FASTQReadsSourceIterator() {
+        delete(reader);
+        delete(pairReader);
         if (ownStreams) {
-            source->close();
-            if (pairSource)
-                pairSource->close();
             delete(source);
             delete(pairSource);
         }
@@ -185,12 +254,22 @@ namespace PgSAReadsSet {
 
     template<typename uint_read_len>
     string FASTQReadsSourceIterator<uint_read_len>::getRead() {
-        return line.substr(0, length);
+        return string(record[READ_LINE], length);
     }
 
     template<typename uint_read_len>
     string FASTQReadsSourceIterator<uint_read_len>::getQualityInfo() {
-        return quality.substr(0, length);
+        return string(record[QUALITY_LINE], recordLength[QUALITY_LINE] < length ? recordLength[QUALITY_LINE] : length);
+    }
+
+    template<typename uint_read_len>
+    const char* FASTQReadsSourceIterator<uint_read_len>::peekRead() {
+        return record[READ_LINE];
+    }
+
+    template<typename uint_read_len>
+    const char* FASTQReadsSourceIterator<uint_read_len>::peekQualityInfo() {
+        return recordLength[QUALITY_LINE] < length ? 0 : record[QUALITY_LINE];
     }
 
     template<typename uint_read_len>
@@ -200,18 +279,16 @@ namespace PgSAReadsSet {
 
     template<typename uint_read_len>
     bool FASTQReadsSourceIterator<uint_read_len>::moveNext() {
-        std::istream* src = source;
-        if (pair && pairSource)
-            src = pairSource;
+        BufferedRecordsReader* src = reader;
+        if (pair && pairReader)
+            src = pairReader;
         pair = !pair;
 
-        if (!std::getline(*src, id))
+        if (!src->nextRecord(record, recordLength, RECORD_LINES))
             return false;
-        std::getline(*src, line);
-        std::getline(*src, opt_id);
-        std::getline(*src, quality);
 
-        for (length = 0; length < line.length(); length++)
+        const char* line = record[READ_LINE];
+        for (length = 0; length < recordLength[READ_LINE]; length++)
             if (!isalpha(line[length]))
                 break;
 
@@ -224,9 +301,11 @@ namespace PgSAReadsSet {
         counter = -1;
         source->clear();
         source->seekg(0);
+        reader->rewind();
         if (pairSource) { 
             pairSource->clear();
             pairSource->seekg(0);
+            pairReader->rewind();
         }
         pair = false;
     }
@@ -242,6 +321,18 @@ namespace PgSAReadsSet {
     ReadsSourceIteratorTemplate<uint_read_len>::~ReadsSourceIteratorTemplate() {
     }
 
+    template<typename uint_read_len>
+    const char* ReadsSourceIteratorTemplate<uint_read_len>::peekRead() {
+        peekedRead = getRead();
+        return peekedRead.data();
+    }
+
+    template<typename uint_read_len>
+    const char* ReadsSourceIteratorTemplate<uint_read_len>::peekQualityInfo() {
+        peekedQuality = getQualityInfo();
+        return peekedQuality.size() < getReadLength() ? 0 : peekedQuality.data();
+    }
+
     template<typename uint_read_len>
     RevComplPairReadsSetIterator<uint_read_len>::RevComplPairReadsSetIterator(
             ReadsSourceIteratorTemplate<uint_read_len> *coreIterator): coreIterator(coreIterator) {
@@ -272,6 +363,20 @@ namespace PgSAReadsSet {
         return q;
     }
 
+    template<typename uint_read_len>
+    const char* RevComplPairReadsSetIterator<uint_read_len>::peekRead() {
+        if (counter % 2)
+            return ReadsSourceIteratorTemplate<uint_read_len>::peekRead();
+        return coreIterator->peekRead();
+    }
+
+    template<typename uint_read_len>
+    const char* RevComplPairReadsSetIterator<uint_read_len>::peekQualityInfo() {
+        if (counter % 2)
+            return ReadsSourceIteratorTemplate<uint_read_len>::peekQualityInfo();
+        return coreIterator->peekQualityInfo();
+    }
+
     template<typename uint_read_len>
     uint_read_len RevComplPairReadsSetIterator<uint_read_len>::getReadLength() {
         return coreIterator->getReadLength();
@@ -315,6 +420,16 @@ namespace PgSAReadsSet {
         return coreIterator->getQualityInfo();
     }
 
+    template<typename uint_read_len>
+    const char* IgnoreNReadsSetIterator<uint_read_len>::peekRead() {
+        return coreIterator->peekRead();
+    }
+
+    template<typename uint_read_len>
+    const char* IgnoreNReadsSetIterator<uint_read_len>::peekQualityInfo() {
+        return coreIterator->peekQualityInfo();
+    }
+
     template<typename uint_read_len>
     uint_read_len IgnoreNReadsSetIterator<uint_read_len>::getReadLength() {
         return coreIterator->getReadLength();
@@ -329,7 +444,7 @@ namespace PgSAReadsSet {
 
     template<typename uint_read_len>
     bool IgnoreNReadsSetIterator<uint_read_len>::isFreeOfN() {
-        return coreIterator->getRead().find('N') == string::npos;
+        return memchr(coreIterator->peekRead(), 'N', coreIterator->getReadLength()) == 0;
     }
 
     template<typename uint_read_len>
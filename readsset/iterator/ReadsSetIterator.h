@@ -4,6 +4,7 @@
 #include <ctype.h>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "../../utils/helper.h"
 #include "../../pgsaconfig.h"
 
@@ -11,6 +12,99 @@ namespace PgSAReadsSet {
 
     typedef uint_read_len_std uint_read_len_max;
 
+    // reads indexes are stored in 32-bit values unless indexes exceed the standard reads count range
+    class ReadsIndexValues {
+        bool maxMode;
+    public:
+        vector<uint_reads_cnt_std> stdValues;
+        vector<uint_reads_cnt_max> maxValues;
+
+        ReadsIndexValues(uint_reads_cnt_max readsCount = 0) : maxMode(!isReadsCountStd(readsCount)) {}
+
+        bool isMaxMode() const { return maxMode; }
+
+        // switches to 64-bit values if indexes up to readsCount are to be stored (not thread-safe)
+        void adjustMode(uint_reads_cnt_max readsCount) {
+            if (maxMode || isReadsCountStd(readsCount))
+                return;
+            maxValues.assign(stdValues.begin(), stdValues.end());
+            vector<uint_reads_cnt_std>().swap(stdValues);
+            maxMode = true;
+        }
+
+        template<typename uint_reads_cnt>
+        vector<uint_reads_cnt> &getValues();
+
+        inline uint_reads_cnt_max operator[](uint_reads_cnt_max idx) const {
+            return maxMode ? maxValues[idx] : stdValues[idx];
+        }
+
+        // value must fit the current mode (see adjustMode)
+        inline void set(uint_reads_cnt_max idx, uint_reads_cnt_max value) {
+            if (maxMode)
+                maxValues[idx] = value;
+            else
+                stdValues[idx] = value;
+        }
+
+        void push_back(uint_reads_cnt_max value) {
+            adjustMode(value);
+            if (maxMode)
+                maxValues.push_back(value);
+            else
+                stdValues.push_back(value);
+        }
+
+        void append(const ReadsIndexValues &values) {
+            adjustMode(values.isMaxMode() ? UINT64_MAX : 0);
+            if (!maxMode)
+                stdValues.insert(stdValues.end(), values.stdValues.begin(), values.stdValues.end());
+            else if (values.isMaxMode())
+                maxValues.insert(maxValues.end(), values.maxValues.begin(), values.maxValues.end());
+            else
+                maxValues.insert(maxValues.end(), values.stdValues.begin(), values.stdValues.end());
+        }
+
+        uint_reads_cnt_max lowerBound(uint_reads_cnt_max value) const {
+            return maxMode ? std::lower_bound(maxValues.begin(), maxValues.end(), value) - maxValues.begin() :
+                    std::lower_bound(stdValues.begin(), stdValues.end(), value) - stdValues.begin();
+        }
+
+        uint_reads_cnt_max back() const { return maxMode ? maxValues.back() : stdValues.back(); }
+        void reserve(uint_reads_cnt_max count) { maxMode ? maxValues.reserve(count) : stdValues.reserve(count); }
+        void resize(uint_reads_cnt_max count) { maxMode ? maxValues.resize(count) : stdValues.resize(count); }
+        uint_reads_cnt_max size() const { return maxMode ? maxValues.size() : stdValues.size(); }
+        bool empty() const { return size() == 0; }
+        void clear() { stdValues.clear(); maxValues.clear(); }
+        char* data() { return maxMode ? (char*) maxValues.data() : (char*) stdValues.data(); }
+        uint8_t valueBytes() const { return maxMode ? sizeof(uint_reads_cnt_max) : sizeof(uint_reads_cnt_std); }
+
+        // single index persistence (32-bit values for standard reads count)
+        static void writeIndex(std::ostream &dest, uint_reads_cnt_max value, bool stdIndex) {
+            if (stdIndex)
+                PgSAHelpers::writeValue<uint_reads_cnt_std>(dest, value);
+            else
+                PgSAHelpers::writeValue<uint_reads_cnt_max>(dest, value);
+        }
+
+        static uint_reads_cnt_max readIndex(std::istream &src, bool stdIndex, bool plainTextReadMode) {
+            if (!stdIndex) {
+                uint_reads_cnt_max value;
+                PgSAHelpers::readValue<uint_reads_cnt_max>(src, value, plainTextReadMode);
+                return value;
+            }
+            uint_reads_cnt_std value;
+            PgSAHelpers::readValue<uint_reads_cnt_std>(src, value, plainTextReadMode);
+            return value;
+        }
+    };
+
+    template<>
+    inline vector<uint_reads_cnt_std> &ReadsIndexValues::getValues<uint_reads_cnt_std>() { return stdValues; }
+
+    template<>
+    inline vector<uint_reads_cnt_max> &ReadsIndexValues::getValues<uint_reads_cnt_max>() { return maxValues; }
+
     class IndexesMapping {
     public:
         virtual uint_reads_cnt_max getReadOriginalIndex(uint_reads_cnt_max idx) = 0;
@@ -31,10 +125,10 @@ namespace PgSAReadsSet {
 
     class VectorMapping : public IndexesMapping {
     private:
-        vector<uint_reads_cnt_max> mappingWithGuard;
+        ReadsIndexValues mappingWithGuard;
         uint_reads_cnt_max readsCount;
     public:
-        VectorMapping(vector<uint_reads_cnt_max> &&mapping, uint_reads_cnt_max readsCount) :
+        VectorMapping(ReadsIndexValues &&mapping, uint_reads_cnt_max readsCount) :
         mappingWithGuard(std::move(mapping)), readsCount(readsCount) {
             if (mappingWithGuard.empty() || mappingWithGuard.back() != readsCount)
                 mappingWithGuard.push_back(readsCount);
@@ -44,7 +138,7 @@ namespace PgSAReadsSet {
         uint_reads_cnt_max getMappedReadsCount() override { return mappingWithGuard.size() - 1; }
         uint_reads_cnt_max getReadsTotalCount() override { return readsCount; }
 
-        vector<uint_reads_cnt_max> &getMappingVector();
+        ReadsIndexValues &getMappingVector();
 
         void saveMapping(string mappingFile);
         static VectorMapping* loadMapping(string mappingFile);
@@ -87,7 +181,35 @@ namespace PgSAReadsSet {
             virtual uint_read_len getReadLength() = 0;
             virtual void rewind() = 0;
 
+            // zero-copy access to getReadLength() symbols of current read (valid until the next moveNext call)
+            virtual const char* peekRead();
+            // returns 0 if quality info is unavailable
+            virtual const char* peekQualityInfo();
+
             virtual IndexesMapping* retainVisitedIndexesMapping() = 0;
+
+        protected:
+            string peekedRead, peekedQuality;
+    };
+
+    // slices records of lines from a source read in large blocks
+    class BufferedRecordsReader {
+    private:
+        std::istream* source;
+        vector<char> buffer;
+        size_t begin = 0;
+        size_t end = 0;
+        bool sourceExhausted = false;
+
+        bool refill();
+    public:
+        static const size_t DEFAULT_BUFFER_SIZE = 1 << 24;
+
+        BufferedRecordsReader(std::istream* source, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+        // lines (without end of line symbols) are valid until the next nextRecord call
+        bool nextRecord(const char** lines, size_t* lengths, uint8_t linesCount);
+        void rewind();
     };
 
     template < typename uint_read_len >
@@ -144,18 +266,27 @@ namespace PgSAReadsSet {
     class FASTQReadsSourceIterator: public ReadsSourceIteratorTemplate< uint_read_len >
     {
         private:
-            std::string id, line, opt_id, quality;
+            static const uint8_t RECORD_LINES = 4;
+            static const uint8_t READ_LINE = 1;
+            static const uint8_t QUALITY_LINE = 3;
+
+            const char* record[RECORD_LINES];
+            size_t recordLength[RECORD_LINES];
             uint_read_len length;
-            std::ifstream* source = 0;
-            std::ifstream* pairSource = 0;
+            std::istream* source = 0;
+            std::istream* pairSource = 0;
+            BufferedRecordsReader* reader = 0;
+            BufferedRecordsReader* pairReader = 0;
             bool ownStreams = false;
             bool pair = false;
             int64_t counter = -1;
+
+            void initReaders();
             
         public:
 
             FASTQReadsSourceIterator(const string &srcFile, const string &pairFile = std::string());
-            FASTQReadsSourceIterator(std::ifstream* source, std::ifstream* pairSource);
+            FASTQReadsSourceIterator(std::istream* source, std::istream* pairSource);
 
             ~FASTQReadsSourceIterator();
 
@@ -165,6 +296,9 @@ namespace PgSAReadsSet {
             uint_read_len getReadLength();
             void rewind();
 
+            const char* peekRead() override;
+            const char* peekQualityInfo() override;
+
             IndexesMapping* retainVisitedIndexesMapping() override;
     };
 
@@ -182,6 +316,8 @@ namespace PgSAReadsSet {
         string getQualityInfo();
         uint_read_len getReadLength();
         void rewind();
+        const char* peekRead() override;
+        const char* peekQualityInfo() override;
         IndexesMapping* retainVisitedIndexesMapping() override;
     };
 
@@ -190,7 +326,7 @@ namespace PgSAReadsSet {
     private:
         ReadsSourceIteratorTemplate<uint_read_len>* coreIterator;
         int64_t counter = -1;
-        vector<uint_reads_cnt_max> indexesMapping;
+        ReadsIndexValues indexesMapping;
 
         bool isFreeOfN();
     public:
@@ -201,6 +337,8 @@ namespace PgSAReadsSet {
         string getQualityInfo();
         uint_read_len getReadLength();
         void rewind();
+        const char* peekRead() override;
+        const char* peekQualityInfo() override;
         IndexesMapping* retainVisitedIndexesMapping() override;
     };
 }
@@ -1,6 +1,7 @@
 #include "ReadsSetPersistence.h"
 
 #include "../iterator/DivisionReadsSetDecorators.h"
+#include "../../utils/GzipInputStream.h"
 
 namespace PgSAReadsSet {
 
@@ -19,13 +20,13 @@ namespace PgSAReadsSet {
 
     ReadsSetPersistence::ManagedReadsSetIterator::ManagedReadsSetIterator(const string &srcFile, const string &pairFile,
             bool revComplPairFile, const string &divisionFile, bool divisionComplement, bool ignoreNReads, bool ignoreNoNReads) {
-        srcSource = new ifstream(srcFile, ios_base::in | ios_base::binary);
+        srcSource = openPlainOrGzipInputStream(srcFile);
         if (srcSource->fail()) {
             fprintf(stderr, "cannot open reads file %s\n", srcFile.c_str());
             exit(EXIT_FAILURE);
         }
         if (pairFile != "") {
-            pairSource = new ifstream(pairFile, ios_base::in | ios_base::binary);
+            pairSource = openPlainOrGzipInputStream(pairFile);
             if (pairSource->fail()) {
                 fprintf(stderr, "cannot open reads pair file %s\n", pairFile.c_str());
                 exit(EXIT_FAILURE);
@@ -65,9 +66,6 @@ namespace PgSAReadsSet {
         delete(readsIterator);
         for(ReadsSourceIteratorTemplate<uint_read_len_max>* coreIterator: coreIterators)
             delete(coreIterator);
-        srcSource->close();
-        if (pairSource)
-            pairSource->close();
         if (divSource)
             divSource->close();
         delete(srcSource);
@@ -87,6 +85,14 @@ namespace PgSAReadsSet {
         return readsIterator->getQualityInfo();
     }
 
+    const char* ReadsSetPersistence::ManagedReadsSetIterator::peekRead() {
+        return readsIterator->peekRead();
+    }
+
+    const char* ReadsSetPersistence::ManagedReadsSetIterator::peekQualityInfo() {
+        return readsIterator->peekQualityInfo();
+    }
+
     uint_read_len_max ReadsSetPersistence::ManagedReadsSetIterator::getReadLength() {
         return readsIterator->getReadLength();
     }
@@ -98,4 +104,92 @@ namespace PgSAReadsSet {
     IndexesMapping* ReadsSetPersistence::ManagedReadsSetIterator::retainVisitedIndexesMapping() {
         return readsIterator->retainVisitedIndexesMapping();
     }
-}
\ No newline at end of file
+
+    size_t ReadsSetPersistence::packedReadsStoreReadLength(uint_read_len_max readLength) {
+        return (readLength + 2) / 3;
+    }
+
+    void ReadsSetPersistence::writePackedReadsStoreHeader(ostream &dest, uint_read_len_max readLength,
+                                                          uint_reads_cnt_max readsCount) {
+        writeValue<uint16_t>(dest, readLength, false);
+        writeValue<uint64_t>(dest, readsCount, false);
+    }
+
+    bool ReadsSetPersistence::probePackedReadsStore(const string &storeFile, uint_read_len_max &readLength) {
+        ifstream src(storeFile, ios_base::in | ios_base::binary);
+        if (src.fail())
+            return false;
+        uint16_t length = 0;
+        readValue<uint16_t>(src, length, false);
+        if (src.fail())
+            return false;
+        readLength = length;
+        return true;
+    }
+
+    ReadsSourceIteratorTemplate<uint_read_len_max> *ReadsSetPersistence::createPackedReadsStoreIterator(
+            const string &storeFile) {
+        return new PackedReadsStoreIterator(storeFile);
+    }
+
+    ReadsSetPersistence::PackedReadsStoreIterator::PackedReadsStoreIterator(const string &storeFile) {
+        source.open(storeFile, ios_base::in | ios_base::binary);
+        if (source.fail()) {
+            fprintf(stderr, "cannot open reads store file %s\n", storeFile.c_str());
+            exit(EXIT_FAILURE);
+        }
+        uint16_t length = 0;
+        uint64_t count = 0;
+        readValue<uint16_t>(source, length, false);
+        readValue<uint64_t>(source, count, false);
+        readLength = length;
+        readsCount = count;
+        dataBegin = source.tellg();
+        packedReadLength = packedReadsStoreReadLength(readLength);
+        packedBuffer.resize(packedReadLength * BUFFERED_READS_COUNT);
+        read.resize(readLength);
+    }
+
+    bool ReadsSetPersistence::PackedReadsStoreIterator::moveNext() {
+        if (counter + 1 == readsCount)
+            return false;
+        if (++bufferedReadIdx >= bufferedReadsCount) {
+            bufferedReadsCount = readsCount - (counter + 1) < BUFFERED_READS_COUNT ?
+                    readsCount - (counter + 1) : BUFFERED_READS_COUNT;
+            source.read(&packedBuffer[0], packedReadLength * bufferedReadsCount);
+            if (source.gcount() != packedReadLength * bufferedReadsCount) {
+                fprintf(stderr, "Unexpected end of reads store file.\n");
+                exit(EXIT_FAILURE);
+            }
+            bufferedReadIdx = 0;
+        }
+        SymbolsPackingFacility::ACGTNPacker.reverseSequence(
+                (const uint8_t*) packedBuffer.data() + packedReadLength * bufferedReadIdx, 0, readLength, &read[0]);
+        counter++;
+        return true;
+    }
+
+    string ReadsSetPersistence::PackedReadsStoreIterator::getRead() {
+        return read;
+    }
+
+    const char* ReadsSetPersistence::PackedReadsStoreIterator::peekRead() {
+        return read.data();
+    }
+
+    uint_read_len_max ReadsSetPersistence::PackedReadsStoreIterator::getReadLength() {
+        return readLength;
+    }
+
+    void ReadsSetPersistence::PackedReadsStoreIterator::rewind() {
+        counter = -1;
+        bufferedReadsCount = 0;
+        bufferedReadIdx = 0;
+        source.clear();
+        source.seekg(dataBegin);
+    }
+
+    IndexesMapping* ReadsSetPersistence::PackedReadsStoreIterator::retainVisitedIndexesMapping() {
+        return new DirectMapping(counter + 1);
+    }
+}
@@ -15,8 +15,8 @@ namespace PgSAReadsSet {
             vector<ReadsSourceIteratorTemplate< uint_read_len_max>*> coreIterators;
             ReadsSourceIteratorTemplate< uint_read_len_max>* readsIterator = 0;
 
-            ifstream* srcSource = 0;
-            ifstream* pairSource = 0;
+            istream* srcSource = 0;
+            istream* pairSource = 0;
             ifstream* divSource = 0;
         public:
             ManagedReadsSetIterator(const string &srcFile, const string &pairFile = "", bool revComplPairFile = false,
@@ -30,12 +30,51 @@ namespace PgSAReadsSet {
             uint_read_len_max getReadLength();
             void rewind();
 
+            const char* peekRead() override;
+            const char* peekQualityInfo() override;
+
             virtual ~ManagedReadsSetIterator();
 
             IndexesMapping* retainVisitedIndexesMapping() override;
         };
 
+        // iterates over reads packed (in original order) in a reads store file
+        class PackedReadsStoreIterator: public ReadsSourceIteratorTemplate<uint_read_len_max> {
+        private:
+            static const uint_reads_cnt_max BUFFERED_READS_COUNT = 1 << 16;
+
+            ifstream source;
+            std::streampos dataBegin;
+            uint_read_len_max readLength = 0;
+            uint_reads_cnt_max readsCount = 0;
+            size_t packedReadLength;
+            string packedBuffer;
+            uint_reads_cnt_max bufferedReadsCount = 0;
+            uint_reads_cnt_max bufferedReadIdx = 0;
+            string read;
+            int64_t counter = -1;
+
+        public:
+            PackedReadsStoreIterator(const string &storeFile);
+
+            bool moveNext();
+            string getRead();
+            uint_read_len_max getReadLength();
+            void rewind();
+
+            const char* peekRead() override;
+
+            IndexesMapping* retainVisitedIndexesMapping() override;
+        };
+
     public:
+        // all reads stored with ACGTN packing (3 symbols per byte)
+        static size_t packedReadsStoreReadLength(uint_read_len_max readLength);
+        static void writePackedReadsStoreHeader(ostream &dest, uint_read_len_max readLength,
+                                                uint_reads_cnt_max readsCount);
+        static bool probePackedReadsStore(const string &storeFile, uint_read_len_max &readLength);
+        static ReadsSourceIteratorTemplate<uint_read_len_max>* createPackedReadsStoreIterator(const string &storeFile);
+
         static ReadsSourceIteratorTemplate<uint_read_len_max>* createManagedReadsIterator(const string &srcFile,
                                                                                           const string &pairFile = "",
                                                                                           bool revComplPairFile = false,
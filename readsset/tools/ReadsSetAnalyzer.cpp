@@ -26,12 +26,12 @@ namespace PgSAReadsSet {
             properties->allReadsLength += currLength;
 
             //analyze symbols
-            string read(readsIterator->getRead());
+            const char* read = readsIterator->peekRead();
 
             for (uint_read_len_max i = 0; i < currLength; i++) {
-                read[i] = toupper(read[i]);
-                if (!symbolOccured[(unsigned char) read[i]]) {
-                    symbolOccured[(unsigned char) read[i]] = true;
+                const unsigned char symbol = toupper(read[i]);
+                if (!symbolOccured[symbol]) {
+                    symbolOccured[symbol] = true;
                     properties->symbolsCount++;
                 }
             }
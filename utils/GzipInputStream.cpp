@@ -0,0 +1,231 @@
+#include "GzipInputStream.h"
+
+#include "helper.h"
+
+namespace PgSAHelpers {
+
+    static const uint8_t GZIP_ID1 = 0x1f;
+    static const uint8_t GZIP_ID2 = 0x8b;
+    static const uint8_t GZIP_CM_DEFLATE = 8;
+    static const uint8_t GZIP_FLG_FEXTRA = 4;
+    static const size_t GZIP_HEADER_SIZE = 12;
+    static const size_t GZIP_FOOTER_SIZE = 8;
+    static const size_t BGZF_HEADER_SIZE = 18;
+
+    static inline uint16_t readLE16(const uint8_t *ptr) {
+        return ptr[0] | ((uint16_t) ptr[1] << 8);
+    }
+
+    static inline uint32_t readLE32(const uint8_t *ptr) {
+        return ptr[0] | ((uint32_t) ptr[1] << 8) | ((uint32_t) ptr[2] << 16) | ((uint32_t) ptr[3] << 24);
+    }
+
+    GzipInputStreamBuf::GzipInputStreamBuf(const string &fileName) {
+        src.open(fileName, ios_base::in | ios_base::binary);
+        if (src.fail())
+            return;
+        uint8_t header[BGZF_HEADER_SIZE];
+        src.read((char*) header, BGZF_HEADER_SIZE);
+        bgzfMode = isBGZFHeader(header, src.gcount());
+        src.clear();
+        src.seekg(0);
+        if (!bgzfMode) {
+            strm = {};
+            if (inflateInit2(&strm, 15 + 16) != Z_OK) {
+                fprintf(stderr, "Error initializing gzip decoder.\n");
+                exit(EXIT_FAILURE);
+            }
+            inBuf.resize(INPUT_BUFFER_SIZE);
+        }
+    }
+
+    GzipInputStreamBuf::~GzipInputStreamBuf() {
+        if (inflater.joinable())
+            inflater.join();
+        if (src.is_open() && !bgzfMode)
+            inflateEnd(&strm);
+    }
+
+    bool GzipInputStreamBuf::isBGZFHeader(const uint8_t *header, size_t length) {
+        return length >= BGZF_HEADER_SIZE && header[0] == GZIP_ID1 && header[1] == GZIP_ID2 &&
+               header[2] == GZIP_CM_DEFLATE && (header[3] & GZIP_FLG_FEXTRA) && readLE16(header + 10) >= 6 &&
+               header[12] == 'B' && header[13] == 'C' && readLE16(header + 14) == 2;
+    }
+
+    void GzipInputStreamBuf::inflateNext(string &dest) {
+        dest.clear();
+        // parts of empty gzip members (e.g. BGZF end-of-file markers) are skipped
+        while (dest.empty() && !inputExhausted) {
+            if (bgzfMode)
+                inflateBGZFBlocks(dest);
+            else
+                inflatePlainGzipPart(dest);
+        }
+    }
+
+    void GzipInputStreamBuf::inflatePlainGzipPart(string &dest) {
+        dest.resize(PLAIN_GZIP_PART_SIZE);
+        strm.next_out = (Bytef*) &dest[0];
+        strm.avail_out = PLAIN_GZIP_PART_SIZE;
+        while (strm.avail_out > 0) {
+            if (strm.avail_in == 0) {
+                src.read(inBuf.data(), inBuf.size());
+                strm.next_in = (Bytef*) inBuf.data();
+                strm.avail_in = src.gcount();
+            }
+            if (memberEnded) {
+                if (strm.avail_in == 0) {
+                    inputExhausted = true;
+                    break;
+                }
+                inflateReset(&strm);
+                memberEnded = false;
+            }
+            int res = inflate(&strm, Z_NO_FLUSH);
+            if (res == Z_STREAM_END)
+                memberEnded = true;
+            else if (res == Z_BUF_ERROR && strm.avail_in == 0) {
+                fprintf(stderr, "Unexpected end of gzip file.\n");
+                exit(EXIT_FAILURE);
+            } else if (res != Z_OK) {
+                fprintf(stderr, "Error decompressing gzip file (%d): %s\n", res, strm.msg ? strm.msg : "");
+                exit(EXIT_FAILURE);
+            }
+        }
+        dest.resize(PLAIN_GZIP_PART_SIZE - strm.avail_out);
+    }
+
+    void GzipInputStreamBuf::inflateBGZFBlocks(string &dest) {
+        const size_t blocksLimit = numberOfThreads * BGZF_BLOCKS_PER_THREAD;
+        if (bgzfBlocks.size() < blocksLimit)
+            bgzfBlocks.resize(blocksLimit);
+        size_t blocksCount = 0;
+        uint8_t header[GZIP_HEADER_SIZE];
+        string extra;
+        while (blocksCount < blocksLimit) {
+            src.read((char*) header, GZIP_HEADER_SIZE);
+            if (src.gcount() == 0) {
+                inputExhausted = true;
+                break;
+            }
+            if (src.gcount() < GZIP_HEADER_SIZE || header[0] != GZIP_ID1 || header[1] != GZIP_ID2 ||
+                header[2] != GZIP_CM_DEFLATE || !(header[3] & GZIP_FLG_FEXTRA)) {
+                fprintf(stderr, "Invalid BGZF block header.\n");
+                exit(EXIT_FAILURE);
+            }
+            const uint16_t xlen = readLE16(header + 10);
+            extra.resize(xlen);
+            src.read(&extra[0], xlen);
+            size_t blockSize = 0;
+            for(size_t i = 0; i + 4 <= xlen; ) {
+                const uint8_t *subfield = (const uint8_t*) extra.data() + i;
+                const uint16_t slen = readLE16(subfield + 2);
+                if (subfield[0] == 'B' && subfield[1] == 'C' && slen == 2 && i + 6 <= xlen)
+                    blockSize = readLE16(subfield + 4) + 1;
+                i += 4 + slen;
+            }
+            if (src.gcount() < xlen || blockSize < GZIP_HEADER_SIZE + xlen + GZIP_FOOTER_SIZE) {
+                fprintf(stderr, "Invalid BGZF block header.\n");
+                exit(EXIT_FAILURE);
+            }
+            string &block = bgzfBlocks[blocksCount++];
+            block.resize(blockSize - GZIP_HEADER_SIZE - xlen);
+            src.read(&block[0], block.size());
+            if (src.gcount() < block.size()) {
+                fprintf(stderr, "Unexpected end of BGZF file.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        vector<size_t> destOffset(blocksCount + 1, 0);
+        for(size_t i = 0; i < blocksCount; i++)
+            destOffset[i + 1] = destOffset[i] +
+                    readLE32((const uint8_t*) bgzfBlocks[i].data() + bgzfBlocks[i].size() - 4);
+        dest.resize(destOffset[blocksCount]);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(numberOfThreads)
+        for(int64_t i = 0; i < (int64_t) blocksCount; i++) {
+            const string &block = bgzfBlocks[i];
+            const size_t blockDestLen = destOffset[i + 1] - destOffset[i];
+            Bytef *blockDest = (Bytef*) &dest[0] + destOffset[i];
+            z_stream blockStrm = {};
+            inflateInit2(&blockStrm, -15);
+            blockStrm.next_in = (Bytef*) block.data();
+            blockStrm.avail_in = block.size() - GZIP_FOOTER_SIZE;
+            blockStrm.next_out = blockDest;
+            blockStrm.avail_out = blockDestLen;
+            int res = inflate(&blockStrm, Z_FINISH);
+            inflateEnd(&blockStrm);
+            if (res != Z_STREAM_END || blockStrm.total_out != blockDestLen ||
+                crc32(0, blockDest, blockDestLen) != readLE32((const uint8_t*) block.data() + block.size() - 8)) {
+                fprintf(stderr, "Error decompressing BGZF block.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    void GzipInputStreamBuf::startInflater() {
+        inflater = std::thread([this]() { inflateNext(nextBuffer); });
+    }
+
+    void GzipInputStreamBuf::resetDecoder() {
+        src.clear();
+        src.seekg(0);
+        inputExhausted = false;
+        if (!bgzfMode) {
+            inflateReset(&strm);
+            strm.avail_in = 0;
+            memberEnded = false;
+        }
+    }
+
+    GzipInputStreamBuf::int_type GzipInputStreamBuf::underflow() {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (!inflater.joinable())
+            startInflater();
+        inflater.join();
+        buffer.swap(nextBuffer);
+        if (buffer.empty()) {
+            setg(0, 0, 0);
+            return traits_type::eof();
+        }
+        setg(&buffer[0], &buffer[0], &buffer[0] + buffer.size());
+        startInflater();
+        return traits_type::to_int_type(*gptr());
+    }
+
+    GzipInputStreamBuf::pos_type GzipInputStreamBuf::seekoff(off_type off, ios_base::seekdir dir,
+                                                             ios_base::openmode which) {
+        if (off == 0 && dir == ios_base::beg)
+            return seekpos(0, which);
+        return pos_type(off_type(-1));
+    }
+
+    GzipInputStreamBuf::pos_type GzipInputStreamBuf::seekpos(pos_type pos, ios_base::openmode which) {
+        if (pos != pos_type(0))
+            return pos_type(off_type(-1));
+        if (inflater.joinable())
+            inflater.join();
+        resetDecoder();
+        setg(0, 0, 0);
+        return pos;
+    }
+
+    GzipInputStream::GzipInputStream(const string &fileName): std::istream(&sbuf), sbuf(fileName) {
+        if (!sbuf.isOpen())
+            setstate(ios_base::failbit);
+    }
+
+    bool isGzipFile(const string &fileName) {
+        ifstream in(fileName, ios_base::in | ios_base::binary);
+        uint8_t id[2] = { 0, 0 };
+        in.read((char*) id, 2);
+        return in.gcount() == 2 && id[0] == GZIP_ID1 && id[1] == GZIP_ID2;
+    }
+
+    istream* openPlainOrGzipInputStream(const string &fileName) {
+        if (isGzipFile(fileName))
+            return new GzipInputStream(fileName);
+        return new ifstream(fileName, ios_base::in | ios_base::binary);
+    }
+
+}
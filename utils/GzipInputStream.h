@@ -0,0 +1,71 @@
+#ifndef PGTOOLS_GZIPINPUTSTREAM_H
+#define PGTOOLS_GZIPINPUTSTREAM_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <zlib.h>
+
+using namespace std;
+
+namespace PgSAHelpers {
+
+    // Inflates gzip (possibly multi-member) or BGZF files. Decompression runs ahead in a background thread
+    // (BGZF blocks are inflated in parallel). Only rewinding (seeking to the beginning) is supported.
+    class GzipInputStreamBuf : public std::streambuf {
+    private:
+        static const size_t PLAIN_GZIP_PART_SIZE = 1 << 22;
+        static const size_t INPUT_BUFFER_SIZE = 1 << 20;
+        static const size_t BGZF_BLOCKS_PER_THREAD = 32;
+
+        ifstream src;
+        bool bgzfMode = false;
+        bool inputExhausted = false;
+
+        z_stream strm;
+        vector<char> inBuf;
+        bool memberEnded = false;
+
+        vector<string> bgzfBlocks;
+
+        string buffer;
+        string nextBuffer;
+        std::thread inflater;
+
+        static bool isBGZFHeader(const uint8_t *header, size_t length);
+
+        void inflateNext(string &dest);
+        void inflatePlainGzipPart(string &dest);
+        void inflateBGZFBlocks(string &dest);
+
+        void startInflater();
+        void resetDecoder();
+
+    protected:
+        int_type underflow() override;
+        pos_type seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, ios_base::openmode which) override;
+
+    public:
+        GzipInputStreamBuf(const string &fileName);
+        virtual ~GzipInputStreamBuf();
+
+        bool isOpen() { return src.is_open(); }
+    };
+
+    class GzipInputStream : public std::istream {
+    private:
+        GzipInputStreamBuf sbuf;
+    public:
+        GzipInputStream(const string &fileName);
+    };
+
+    bool isGzipFile(const string &fileName);
+
+    // opens plain or gzip compressed file (check fail() for errors)
+    istream* openPlainOrGzipInputStream(const string &fileName);
+
+}
+
+#endif //PGTOOLS_GZIPINPUTSTREAM_H
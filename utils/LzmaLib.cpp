@@ -5,6 +5,8 @@
 #include "../lzma/Alloc.h"
 #include "../lzma/LzmaDec.h"
 #include "../lzma/LzmaEnc.h"
+#include "../lzma/Lzma2Dec.h"
+#include "../lzma/Lzma2Enc.h"
 #include "../lzma/Ppmd7.h"
 #include "LzmaLib.h"
 #include "../utils/VarLenDNACoder.h"
@@ -80,8 +82,8 @@ fb - Word size (the number of fast bytes).
      slower compression process.
 */
 
-void LzmaEncProps_Set(CLzmaEncProps *p, int coder_level, size_t dataLength, int numThreads, 
-        int dataPeriodCode = -1) {
+void LzmaEncProps_Set(CLzmaEncProps *p, int coder_level, size_t dataLength, int numThreads,
+        int dataPeriodCode, ostream &log) {
     switch(coder_level) {
         case PGRC_CODER_LEVEL_FAST:
             p->level = 5;
@@ -113,10 +115,10 @@ void LzmaEncProps_Set(CLzmaEncProps *p, int coder_level, size_t dataLength, int
     }
     p->numThreads = numThreads;
     p->reduceSize = dataLength;
-    *PgSAHelpers::logout << " lzma (level = " << p->level << "; dictSize = " << (p->dictSize >> 20) << "MB; lp,pb = " << p->lp << "; th = " << p->numThreads << ") ...";
+    log << " lzma (level = " << p->level << "; dictSize = " << (p->dictSize >> 20) << "MB; lp,pb = " << p->lp << "; th = " << p->numThreads << ") ...";
 }
 
-void Ppmd7_SetProps(uint32_t &memSize, uint8_t coder_level, size_t dataLength, int& order_param) {
+void Ppmd7_SetProps(uint32_t &memSize, uint8_t coder_level, size_t dataLength, int& order_param, ostream &log) {
     switch(coder_level) {
         case PGRC_CODER_LEVEL_FAST:
             memSize = (uint32_t) 16 << 20;
@@ -134,7 +136,7 @@ void Ppmd7_SetProps(uint32_t &memSize, uint8_t coder_level, size_t dataLength, i
             fprintf(stderr, "Unsupported %d PgRC coding level for LZMA compression.\n", coder_level);
             exit(EXIT_FAILURE);
     }
-    *PgSAHelpers::logout << " ppmd (mem = " << (memSize >> 20) << "MB; ord = " << order_param << ") ... ";
+    log << " ppmd (mem = " << (memSize >> 20) << "MB; ord = " << order_param << ") ... ";
     const unsigned kMult = 16;
     if (memSize / kMult > dataLength)
     {
@@ -171,10 +173,11 @@ SZ_ERROR_THREAD     - errors in multithreading functions (only for Mt version)
 */
 
 MY_STDAPI LzmaCompress(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
-                       uint8_t coder_level, int numThreads, int coder_param, double estimated_compression) {
+                       uint8_t coder_level, int numThreads, int coder_param, double estimated_compression,
+                       ostream &log) {
     CLzmaEncProps props;
     LzmaEncProps_Init(&props);
-    LzmaEncProps_Set(&props, coder_level, srcLen, numThreads, coder_param);
+    LzmaEncProps_Set(&props, coder_level, srcLen, numThreads, coder_param, log);
     size_t propsSize = LZMA_PROPS_SIZE;
     size_t maxDestSize = propsSize + (srcLen + srcLen / 3) * estimated_compression + 128;
     try {
@@ -192,6 +195,95 @@ MY_STDAPI LzmaCompress(unsigned char *&dest, size_t &destLen, const unsigned cha
     return res;
 }
 
+/*
+Lzma2Compress
+------------
+  The data is divided into blocks compressed in parallel by independent single-threaded LZMA2 encoders.
+  Each block starts with a dictionary reset chunk, so the concatenated blocks (without end markers
+  of all but the last block) form a standard LZMA2 stream that can be decoded in parallel.
+
+  Format: 1 byte (LZMA2 dictionary size property) followed by LZMA2 stream.
+*/
+
+#define LZMA2_PROPS_SIZE 1
+#define LZMA2_LCLP_MAX 4
+#define LZMA2_MIN_BLOCK_SIZE ((size_t) 1 << 22)
+
+MY_STDAPI Lzma2Compress(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
+                        uint8_t coder_level, int numThreads, int coder_param, double estimated_compression,
+                        ostream &log) {
+    CLzma2EncProps props;
+    Lzma2EncProps_Init(&props);
+    LzmaEncProps_Set(&props.lzmaProps, coder_level, srcLen, 1, coder_param, log);
+    const int lp = props.lzmaProps.lp < 0 ? 0 : props.lzmaProps.lp;
+    if (props.lzmaProps.lc + lp > LZMA2_LCLP_MAX)
+        props.lzmaProps.lc = LZMA2_LCLP_MAX - lp;
+    props.blockSize = LZMA2_ENC_PROPS__BLOCK_SIZE__SOLID;
+    props.numTotalThreads = 1;
+    size_t blockSize = srcLen / numThreads + 1;
+    if (blockSize < LZMA2_MIN_BLOCK_SIZE)
+        blockSize = LZMA2_MIN_BLOCK_SIZE;
+    const size_t blocksCount = (srcLen + blockSize - 1) / blockSize;
+    log << " lzma2 (lc = " << props.lzmaProps.lc << "; blocks = " << blocksCount << "; th = "
+        << numThreads << ") ...";
+
+    props.lzmaProps.reduceSize = blockSize < srcLen ? blockSize : srcLen;
+    CLzma2EncHandle enc = Lzma2Enc_Create(&g_Alloc, &g_BigAlloc);
+    if (!enc)
+        return SZ_ERROR_MEM;
+    int res = Lzma2Enc_SetProps(enc, &props);
+    const Byte dicProp = Lzma2Enc_WriteProperties(enc);
+    Lzma2Enc_Destroy(enc);
+    if (res != SZ_OK)
+        return res;
+
+    vector<unsigned char*> blocks(blocksCount, 0);
+    vector<size_t> blocksLen(blocksCount, 0);
+    vector<int> blocksRes(blocksCount, SZ_OK);
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(numThreads)
+    for(size_t b = 0; b < blocksCount; b++) {
+        const size_t blockStart = b * blockSize;
+        const size_t blockLen = blockStart + blockSize < srcLen ? blockSize : srcLen - blockStart;
+        CLzma2EncProps blockProps = props;
+        blockProps.lzmaProps.reduceSize = blockLen;
+        size_t maxBlockDestSize = (blockLen + blockLen / 3) * estimated_compression + 128;
+        blocks[b] = new unsigned char[maxBlockDestSize];
+        CLzma2EncHandle blockEnc = Lzma2Enc_Create(&g_Alloc, &g_BigAlloc);
+        if (!blockEnc) {
+            blocksRes[b] = SZ_ERROR_MEM;
+            continue;
+        }
+        blocksRes[b] = Lzma2Enc_SetProps(blockEnc, &blockProps);
+        if (blocksRes[b] == SZ_OK) {
+            Lzma2Enc_SetDataSize(blockEnc, blockLen);
+            blocksLen[b] = maxBlockDestSize;
+            blocksRes[b] = Lzma2Enc_Encode2(blockEnc, NULL, blocks[b], &blocksLen[b], NULL, src + blockStart,
+                    blockLen, NULL);
+            if (b + 1 < blocksCount)
+                blocksLen[b]--; // skipping end marker
+        }
+        Lzma2Enc_Destroy(blockEnc);
+    }
+    destLen = LZMA2_PROPS_SIZE;
+    for(size_t b = 0; b < blocksCount; b++) {
+        if (blocksRes[b] != SZ_OK)
+            res = blocksRes[b];
+        destLen += blocksLen[b];
+    }
+    if (res == SZ_OK) {
+        dest = new unsigned char[destLen];
+        dest[0] = dicProp;
+        unsigned char *destPtr = dest + LZMA2_PROPS_SIZE;
+        for (size_t b = 0; b < blocksCount; b++) {
+            memcpy(destPtr, blocks[b], blocksLen[b]);
+            destPtr += blocksLen[b];
+        }
+    }
+    for(size_t b = 0; b < blocksCount; b++)
+        delete[] blocks[b];
+    return res;
+}
+
 struct CByteOutBufWrap
 {
     IByteOut vt;
@@ -227,14 +319,14 @@ CByteOutBufWrap::CByteOutBufWrap(unsigned char *buf, size_t bufLen) throw(): Buf
 }
 
 MY_STDAPI Ppmd7Compress(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
-              uint8_t coder_level, int numThreads, int coder_param, double estimated_compression) {
+              uint8_t coder_level, int numThreads, int coder_param, double estimated_compression, ostream &log) {
     if (numThreads != 1) {
         cout << "Unsupported number of threads " << numThreads << " in ppmd compressor." << endl;
         exit(EXIT_FAILURE);
     }
     CPpmd7 ppmd;
     uint32_t memSize = 0;
-    Ppmd7_SetProps(memSize, coder_level, srcLen, coder_param);
+    Ppmd7_SetProps(memSize, coder_level, srcLen, coder_param, log);
     Ppmd7_Construct(&ppmd);
     if (!Ppmd7_Alloc(&ppmd, memSize, &g_Alloc))
         return SZ_ERROR_MEM;
@@ -288,9 +380,9 @@ Returns:
 #define RC_INIT_SIZE 5
 #define UNCOMPRESS_BUFFER_SIZE 8192
 
-MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, istream &src, size_t *srcLen) {
+MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, istream &src, size_t *srcLen, ostream &log) {
     size_t propsSize = LZMA_PROPS_SIZE;
-    *PgSAHelpers::logout << "... lzma ... ";
+    log << "... lzma ... ";
     unsigned char propsBuf[LZMA_PROPS_SIZE];
     PgSAHelpers::readArray(src, (void*) propsBuf, propsSize);
 
@@ -399,7 +491,7 @@ CByteInBufWrap::CByteInBufWrap(istream &src, size_t bufLen): src(&src),
     vt.Read = Wrap_Stream_ReadByte;
 }
 
-MY_STDAPI PpmdUncompress(unsigned char *dest, size_t *destLen, istream &src, size_t *srcLen) {
+MY_STDAPI PpmdUncompress(unsigned char *dest, size_t *destLen, istream &src, size_t *srcLen, ostream &log) {
     size_t propsSize = LZMA_PROPS_SIZE;
     CPpmd7 ppmd;
     //LzmaDecProps_Set(&props, coder_level, srcLen, numThreads, coder_param); // extract method, support numThreads?
@@ -411,7 +503,7 @@ MY_STDAPI PpmdUncompress(unsigned char *dest, size_t *destLen, istream &src, siz
         return SZ_ERROR_MEM;
     unsigned int order = propsBuf[0];
     Ppmd7_Init(&ppmd, order);
-    *PgSAHelpers::logout << "... ppmd (mem = " << (memSize >> 20) << "MB; ord = " << order << ") ... ";
+    log << "... ppmd (mem = " << (memSize >> 20) << "MB; ord = " << order << ") ... ";
     CPpmd7z_RangeDec rDec;
     Ppmd7z_RangeDec_CreateVTable(&rDec);
     CByteInBufWrap _inStream(src, *srcLen - propsSize);
@@ -441,34 +533,174 @@ MY_STDAPI PpmdUncompress(unsigned char *dest, size_t *destLen, istream &src, siz
     return Res;
 }
 
+MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t *srcLen) {
+    size_t propsSize = LZMA_PROPS_SIZE;
+    if (*srcLen < propsSize + RC_INIT_SIZE)
+        return SZ_ERROR_INPUT_EOF;
+    SizeT inSize = *srcLen - propsSize;
+    ELzmaStatus status = LZMA_STATUS_NOT_SPECIFIED;
+    SRes res = LzmaDecode(dest, destLen, src + propsSize, &inSize, src, propsSize, LZMA_FINISH_ANY, &status, &g_Alloc);
+    if (res == SZ_OK && status == LZMA_STATUS_NEEDS_MORE_INPUT)
+        res = SZ_ERROR_INPUT_EOF;
+    *srcLen = inSize + propsSize;
+    return res;
+}
+
+MY_STDAPI PpmdUncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t *srcLen) {
+    size_t propsSize = LZMA_PROPS_SIZE;
+    if (*srcLen < propsSize)
+        return SZ_ERROR_INPUT_EOF;
+    CPpmd7 ppmd;
+    Ppmd7_Construct(&ppmd);
+    uint32_t memSize = GetUi32(src + 1);
+    if (!Ppmd7_Alloc(&ppmd, memSize, &g_Alloc))
+        return SZ_ERROR_MEM;
+    unsigned int order = src[0];
+    Ppmd7_Init(&ppmd, order);
+    CPpmd7z_RangeDec rDec;
+    Ppmd7z_RangeDec_CreateVTable(&rDec);
+    CByteInBufWrap _inStream((unsigned char*) src + propsSize, *srcLen - propsSize);
+    rDec.Stream = &_inStream.vt;
+
+    int Res = SZ_OK;
+    if (!Ppmd7z_RangeDec_Init(&rDec))
+        Res = SZ_ERROR_DATA;
+    else {
+        size_t i;
+        for (i = 0; i < *destLen; i++) {
+            int sym = Ppmd7_DecodeSymbol(&ppmd, &rDec.vt);
+            if (_inStream.Res != SZ_OK || sym < 0)
+                break;
+            dest[i] = sym;
+        }
+        if (i != *destLen)
+            Res = (_inStream.Res != SZ_OK ? _inStream.Res : SZ_ERROR_DATA);
+        else if (_inStream.GetProcessed() != *srcLen - propsSize || !Ppmd7z_RangeDec_IsFinishedOK(&rDec))
+            Res = SZ_ERROR_DATA;
+    }
+
+    Ppmd7_Free(&ppmd, &g_Alloc);
+    return Res;
+}
+
+#define LZMA2_CONTROL_EOF 0
+#define LZMA2_CONTROL_COPY_RESET_DIC 1
+#define LZMA2_CONTROL_COPY_NO_RESET 2
+#define LZMA2_CONTROL_LZMA (1 << 7)
+#define LZMA2_CONTROL_LZMA_PROPS (3 << 6)
+#define LZMA2_CONTROL_LZMA_RESET_DIC (7 << 5)
+
+MY_STDAPI Lzma2Uncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t *srcLen) {
+    if (*srcLen < LZMA2_PROPS_SIZE)
+        return SZ_ERROR_INPUT_EOF;
+    const Byte dicProp = src[0];
+    // chunk headers parsing (dictionary reset chunks start independently decodable segments)
+    vector<size_t> segSrcPos;
+    vector<size_t> segDestPos;
+    size_t pos = LZMA2_PROPS_SIZE;
+    size_t unpacked = 0;
+    while (pos < *srcLen) {
+        const Byte control = src[pos];
+        if (control == LZMA2_CONTROL_EOF) {
+            pos++;
+            break;
+        }
+        size_t headerSize, packSize, unpackSize;
+        bool dicReset;
+        if (control < LZMA2_CONTROL_LZMA) {
+            if (control > LZMA2_CONTROL_COPY_NO_RESET)
+                return SZ_ERROR_DATA;
+            headerSize = 3;
+            if (pos + headerSize > *srcLen)
+                return SZ_ERROR_INPUT_EOF;
+            unpackSize = packSize = (((size_t) src[pos + 1] << 8) | src[pos + 2]) + 1;
+            dicReset = control == LZMA2_CONTROL_COPY_RESET_DIC;
+        } else {
+            headerSize = control >= LZMA2_CONTROL_LZMA_PROPS ? 6 : 5;
+            if (pos + headerSize > *srcLen)
+                return SZ_ERROR_INPUT_EOF;
+            unpackSize = (((size_t) (control & 0x1F) << 16) | ((size_t) src[pos + 1] << 8) | src[pos + 2]) + 1;
+            packSize = (((size_t) src[pos + 3] << 8) | src[pos + 4]) + 1;
+            dicReset = control >= LZMA2_CONTROL_LZMA_RESET_DIC;
+        }
+        if (dicReset) {
+            segSrcPos.push_back(pos);
+            segDestPos.push_back(unpacked);
+        }
+        pos += headerSize + packSize;
+        unpacked += unpackSize;
+    }
+    if (pos > *srcLen)
+        return SZ_ERROR_INPUT_EOF;
+    if (segSrcPos.empty() || segSrcPos[0] != LZMA2_PROPS_SIZE || unpacked != *destLen)
+        return SZ_ERROR_DATA;
+    segSrcPos.push_back(pos);
+    segDestPos.push_back(unpacked);
+
+    const size_t segmentsCount = segSrcPos.size() - 1;
+    vector<int> segmentsRes(segmentsCount, SZ_OK);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t s = 0; s < segmentsCount; s++) {
+        SizeT outLen = segDestPos[s + 1] - segDestPos[s];
+        SizeT inLen = segSrcPos[s + 1] - segSrcPos[s];
+        ELzmaStatus status = LZMA_STATUS_NOT_SPECIFIED;
+        segmentsRes[s] = Lzma2Decode(dest + segDestPos[s], &outLen, src + segSrcPos[s], &inLen, dicProp,
+                LZMA_FINISH_ANY, &status, &g_Alloc);
+        if (segmentsRes[s] == SZ_OK && outLen != segDestPos[s + 1] - segDestPos[s])
+            segmentsRes[s] = SZ_ERROR_DATA;
+    }
+    for(size_t s = 0; s < segmentsCount; s++)
+        if (segmentsRes[s] != SZ_OK)
+            return segmentsRes[s];
+    *srcLen = pos;
+    return SZ_OK;
+}
+
+MY_STDAPI Lzma2Uncompress(unsigned char *dest, size_t *destLen, istream &src, size_t *srcLen, ostream &log) {
+    log << "... lzma2 ... ";
+    vector<unsigned char> srcBuf(*srcLen);
+    PgSAHelpers::readArray(src, srcBuf.data(), *srcLen);
+    return Lzma2Uncompress(dest, destLen, srcBuf.data(), srcLen);
+}
+
 using namespace PgSAHelpers;
 
-char* Compress(size_t &destLen, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
-               int coder_param, double estimated_compression) {
-    chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
-    unsigned char* dest = 0;
-    int res = 0;
-    int noOfThreads = PgSAHelpers::numberOfThreads;
+size_t parallelBlocksCoderBlockSize = 0;
+
+uint8_t selectLzmaCoder(size_t srcLen) {
+    return (PgSAHelpers::numberOfThreads > 2 && srcLen >= LZMA2_CODER_MIN_STREAM_SIZE) ? LZMA2_CODER : LZMA_CODER;
+}
+
+static int coderCompress(unsigned char *&dest, size_t &destLen, const char *src, size_t srcLen, uint8_t coder_type,
+                         uint8_t coder_level, int coder_param, double &estimated_compression, int noOfThreads,
+                         ostream &log) {
     switch (coder_type) {
         case LZMA_CODER:
             noOfThreads = noOfThreads>1?2:1;
-            res = LzmaCompress(dest, destLen, (const unsigned char*) src, srcLen, coder_level, noOfThreads, coder_param,
-                    estimated_compression);
-            break;
+            return LzmaCompress(dest, destLen, (const unsigned char*) src, srcLen, coder_level, noOfThreads, coder_param,
+                    estimated_compression, log);
         case PPMD7_CODER:
             noOfThreads = 1;
-            res = Ppmd7Compress(dest, destLen, (const unsigned char*) src, srcLen, coder_level, noOfThreads, coder_param,
-                    estimated_compression);
-            break;
+            return Ppmd7Compress(dest, destLen, (const unsigned char*) src, srcLen, coder_level, noOfThreads, coder_param,
+                    estimated_compression, log);
+        case LZMA2_CODER:
+            return Lzma2Compress(dest, destLen, (const unsigned char*) src, srcLen, coder_level, noOfThreads, coder_param,
+                    estimated_compression, log);
         case VARLEN_DNA_CODER:
-            res = VarLenDNACoder::Compress(dest, destLen, (const unsigned char *) src, srcLen, coder_param);
             estimated_compression = VarLenDNACoder::COMPRESSION_ESTIMATION;
-            break;
-        case LZMA2_CODER:
+            return VarLenDNACoder::Compress(dest, destLen, (const unsigned char *) src, srcLen, coder_param);
         default:
             fprintf(stderr, "Unsupported coder type: %d.\n", coder_type);
             exit(EXIT_FAILURE);
     }
+}
+
+char* Compress(size_t &destLen, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
+               int coder_param, double estimated_compression, ostream &log) {
+    chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+    unsigned char* dest = 0;
+    int res = coderCompress(dest, destLen, src, srcLen, coder_type, coder_level, coder_param, estimated_compression,
+            PgSAHelpers::numberOfThreads, log);
 
     if (res != SZ_OK) {
         fprintf(stderr, "Error during compression (code: %d).\n", res);
@@ -476,29 +708,152 @@ char* Compress(size_t &destLen, const char *src, size_t srcLen, uint8_t coder_ty
     }
 
     const double ratio = ((double) destLen) / srcLen;
-    *PgSAHelpers::logout << "compressed " << srcLen << " bytes to " << destLen << " bytes (ratio "
+    log << "compressed " << srcLen << " bytes to " << destLen << " bytes (ratio "
          << PgSAHelpers::toString(ratio, 3) << " vs estimated "
          << PgSAHelpers::toString(estimated_compression, 3) << ") in "
          << PgSAHelpers::time_millis(start_t) << " msec." << endl;
     if (ratio > estimated_compression)
-        *PgSAHelpers::logout << "WARNING: compression ratio " << PgSAHelpers::toString(ratio / estimated_compression, 5)
+        log << "WARNING: compression ratio " << PgSAHelpers::toString(ratio / estimated_compression, 5)
         << " times greater than estimation." << endl;
 
     return (char*) dest;
 }
 
-void Uncompress(char* dest, size_t destLen, istream &src, size_t srcLen, uint8_t coder_type) {
+static int coderUncompress(char* dest, size_t &destLen, const char* src, size_t &srcLen, uint8_t coder_type) {
+    switch (coder_type) {
+        case LZMA_CODER:
+            return LzmaUncompress((unsigned char*) dest, &destLen, (const unsigned char*) src, &srcLen);
+        case PPMD7_CODER:
+            return PpmdUncompress((unsigned char*) dest, &destLen, (const unsigned char*) src, &srcLen);
+        case LZMA2_CODER:
+            return Lzma2Uncompress((unsigned char*) dest, &destLen, (const unsigned char*) src, &srcLen);
+        case VARLEN_DNA_CODER:
+            return PgSAHelpers::VarLenDNACoder::Uncompress((unsigned char*) dest, &destLen,
+                                                           (unsigned char*) src, &srcLen);
+        default:
+            fprintf(stderr, "Unsupported coder type: %d.\n", coder_type);
+            exit(EXIT_FAILURE);
+    }
+}
+
+/*
+Parallel blocks container
+--------------
+  The stream is divided into blocks of blockSize bytes (the last one may be shorter) compressed
+  independently with the same coder. Payload (following standard srcLen, compLen and coder type fields):
+    1 byte   - coder type of blocks
+    8 bytes  - blockSize
+    8 bytes  - compressed length of each block (block index)
+    ...      - concatenated compressed blocks
+*/
+
+bool isParallelBlocksCompressionApplicable(size_t srcLen, uint8_t coder_type) {
+    return parallelBlocksCoderBlockSize && srcLen > parallelBlocksCoderBlockSize &&
+        (coder_type == LZMA_CODER || coder_type == PPMD7_CODER);
+}
+
+static void writeParallelBlocksCompressed(ostream &dest, const char *src, size_t srcLen, uint8_t coder_type,
+        uint8_t coder_level, int coder_param, double estimated_compression, ostream &log) {
+    chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+    const size_t blockSize = parallelBlocksCoderBlockSize;
+    const size_t blocksCount = (srcLen + blockSize - 1) / blockSize;
+    vector<unsigned char*> blocks(blocksCount, 0);
+    vector<uint64_t> blocksLen(blocksCount, 0);
+    vector<int> blocksRes(blocksCount, SZ_OK);
+    log << blocksCount << " blocks (" << (int) coder_type << " coder) ...";
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t b = 0; b < blocksCount; b++) {
+        const size_t blockStart = b * blockSize;
+        const size_t blockLen = blockStart + blockSize < srcLen ? blockSize : srcLen - blockStart;
+        double blockEstimation = estimated_compression;
+        size_t blockCompLen = 0;
+        ostringstream blockLog;
+        blocksRes[b] = coderCompress(blocks[b], blockCompLen, src + blockStart, blockLen, coder_type, coder_level,
+                coder_param, blockEstimation, 1, blockLog);
+        blocksLen[b] = blockCompLen;
+    }
+    size_t compLen = sizeof(uint8_t) + sizeof(uint64_t) * (1 + blocksCount);
+    for(size_t b = 0; b < blocksCount; b++) {
+        if (blocksRes[b] != SZ_OK) {
+            fprintf(stderr, "Error during compression of block %zu (code: %d).\n", b, blocksRes[b]);
+            exit(EXIT_FAILURE);
+        }
+        compLen += blocksLen[b];
+    }
+    PgSAHelpers::writeValue<uint64_t>(dest, compLen, false);
+    PgSAHelpers::writeValue<uint8_t>(dest, PARALLEL_BLOCKS_CODER_TYPE, false);
+    PgSAHelpers::writeValue<uint8_t>(dest, coder_type, false);
+    PgSAHelpers::writeValue<uint64_t>(dest, blockSize, false);
+    for(size_t b = 0; b < blocksCount; b++)
+        PgSAHelpers::writeValue<uint64_t>(dest, blocksLen[b], false);
+    for(size_t b = 0; b < blocksCount; b++) {
+        PgSAHelpers::writeArray(dest, (void*) blocks[b], blocksLen[b]);
+        delete[] blocks[b];
+    }
+    const double ratio = ((double) compLen) / srcLen;
+    log << "compressed " << srcLen << " bytes to " << compLen << " bytes (ratio "
+        << PgSAHelpers::toString(ratio, 3) << " vs estimated "
+        << PgSAHelpers::toString(estimated_compression, 3) << ") in "
+        << PgSAHelpers::time_millis(start_t) << " msec." << endl;
+}
+
+MY_STDAPI ParallelBlocksUncompress(unsigned char *dest, size_t *destLen, istream &src, size_t *srcLen, ostream &log) {
+    uint8_t coder_type = 0;
+    uint64_t blockSize = 0;
+    PgSAHelpers::readValue<uint8_t>(src, coder_type, false);
+    PgSAHelpers::readValue<uint64_t>(src, blockSize, false);
+    if (blockSize == 0)
+        return SZ_ERROR_DATA;
+    const size_t blocksCount = (*destLen + blockSize - 1) / blockSize;
+    size_t headerLen = sizeof(uint8_t) + sizeof(uint64_t) * (1 + blocksCount);
+    if (*srcLen < headerLen)
+        return SZ_ERROR_INPUT_EOF;
+    vector<uint64_t> blocksPos(blocksCount + 1, 0);
+    for(size_t b = 0; b < blocksCount; b++) {
+        uint64_t blockCompLen = 0;
+        PgSAHelpers::readValue<uint64_t>(src, blockCompLen, false);
+        blocksPos[b + 1] = blocksPos[b] + blockCompLen;
+    }
+    if (headerLen + blocksPos[blocksCount] != *srcLen)
+        return SZ_ERROR_DATA;
+    log << "... " << blocksCount << " blocks (" << (int) coder_type << " coder) ... ";
+    vector<char> compBlocks(blocksPos[blocksCount]);
+    PgSAHelpers::readArray(src, compBlocks.data(), compBlocks.size());
+    vector<int> blocksRes(blocksCount, SZ_OK);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t b = 0; b < blocksCount; b++) {
+        const size_t blockStart = b * blockSize;
+        const size_t blockLen = blockStart + blockSize < *destLen ? blockSize : *destLen - blockStart;
+        size_t outLen = blockLen;
+        size_t inLen = blocksPos[b + 1] - blocksPos[b];
+        blocksRes[b] = coderUncompress((char*) dest + blockStart, outLen, compBlocks.data() + blocksPos[b], inLen,
+                coder_type);
+        if (blocksRes[b] == SZ_OK && outLen != blockLen)
+            blocksRes[b] = SZ_ERROR_DATA;
+    }
+    for(size_t b = 0; b < blocksCount; b++)
+        if (blocksRes[b] != SZ_OK)
+            return blocksRes[b];
+    return SZ_OK;
+}
+
+void Uncompress(char* dest, size_t destLen, istream &src, size_t srcLen, uint8_t coder_type, ostream &log) {
     chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
     int res = 0;
     size_t outLen = destLen;
     switch (coder_type) {
     case LZMA_CODER:
-        res = LzmaUncompress((unsigned char*) dest, &outLen, src, &srcLen);
+        res = LzmaUncompress((unsigned char*) dest, &outLen, src, &srcLen, log);
     break;
     case PPMD7_CODER:
-        res = PpmdUncompress((unsigned char*) dest, &outLen, src, &srcLen);
+        res = PpmdUncompress((unsigned char*) dest, &outLen, src, &srcLen, log);
     break;
     case LZMA2_CODER:
+        res = Lzma2Uncompress((unsigned char*) dest, &outLen, src, &srcLen, log);
+    break;
+    case PARALLEL_BLOCKS_CODER_TYPE:
+        res = ParallelBlocksUncompress((unsigned char*) dest, &outLen, src, &srcLen, log);
+    break;
     default:
     fprintf(stderr, "Unsupported coder type: %d.\n", coder_type);
     exit(EXIT_FAILURE);
@@ -509,42 +864,38 @@ void Uncompress(char* dest, size_t destLen, istream &src, size_t srcLen, uint8_t
         fprintf(stderr, "Error during decompression (code: %d).\n", res);
         exit(EXIT_FAILURE);
     }
-    *PgSAHelpers::logout << "uncompressed " << srcLen << " bytes to " << destLen << " bytes in "
+    log << "uncompressed " << srcLen << " bytes to " << destLen << " bytes in "
          << PgSAHelpers::time_millis(start_t) << " msec." << endl;
 }
 
-void Uncompress(char* dest, size_t destLen, const char* src, size_t srcLen, uint8_t coder_type) {
+void Uncompress(char* dest, size_t destLen, const char* src, size_t srcLen, uint8_t coder_type, ostream &log) {
     chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
-    int res = 0;
     size_t outLen = destLen;
-    switch (coder_type) {
-        case VARLEN_DNA_CODER:
-            res = PgSAHelpers::VarLenDNACoder::Uncompress((unsigned char*) dest, &outLen,
-                                                          (unsigned char*) src, &srcLen);
-            break;
-        default:
-            fprintf(stderr, "Unsupported coder type: %d.\n", coder_type);
-            exit(EXIT_FAILURE);
-    }
+    int res = coderUncompress(dest, outLen, src, srcLen, coder_type);
     assert(outLen == destLen);
 
     if (res != SZ_OK) {
         fprintf(stderr, "Error during decompression (code: %d).\n", res);
         exit(EXIT_FAILURE);
     }
-    *PgSAHelpers::logout << "uncompressed " << srcLen << " bytes to " << destLen << " bytes in "
-                         << PgSAHelpers::time_millis(start_t) << " msec." << endl;
+    log << "uncompressed " << srcLen << " bytes to " << destLen << " bytes in "
+        << PgSAHelpers::time_millis(start_t) << " msec." << endl;
 }
 
 void writeCompressed(ostream &dest, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
-                     int coder_param, double estimated_compression) {
+                     int coder_param, double estimated_compression, ostream &log) {
     PgSAHelpers::writeValue<uint64_t>(dest, srcLen, false);
     if (srcLen == 0) {
-        *PgSAHelpers::logout << "skipped compression (0 bytes)." << endl;
+        log << "skipped compression (0 bytes)." << endl;
+        return;
+    }
+    if (isParallelBlocksCompressionApplicable(srcLen, coder_type)) {
+        writeParallelBlocksCompressed(dest, src, srcLen, coder_type, coder_level, coder_param, estimated_compression,
+                log);
         return;
     }
     size_t compLen = 0;
-    char* compSeq = Compress(compLen, src, srcLen, coder_type, coder_level, coder_param, estimated_compression);
+    char* compSeq = Compress(compLen, src, srcLen, coder_type, coder_level, coder_param, estimated_compression, log);
     PgSAHelpers::writeValue<uint64_t>(dest, compLen, false);
     PgSAHelpers::writeValue<uint8_t>(dest, coder_type, false);
     PgSAHelpers::writeArray(dest, (void*) compSeq, compLen);
@@ -552,8 +903,93 @@ void writeCompressed(ostream &dest, const char *src, size_t srcLen, uint8_t code
 }
 
 void writeCompressed(ostream &dest, const string srcStr, uint8_t coder_type, uint8_t coder_level, int coder_param,
-        double estimated_compression) {
-    writeCompressed(dest, srcStr.data(), srcStr.length(), coder_type, coder_level, coder_param, estimated_compression);
+        double estimated_compression, ostream &log) {
+    writeCompressed(dest, srcStr.data(), srcStr.length(), coder_type, coder_level, coder_param, estimated_compression,
+            log);
+}
+
+void ParallelStreamsCompressor::addStream(const string &label, const char *src, size_t srcLen, uint8_t coder_type,
+                                          uint8_t coder_level, int coder_param, double estimated_compression) {
+    jobs.emplace_back();
+    CompressionJob &job = jobs.back();
+    job.label = label;
+    job.rawMode = false;
+    job.src = src;
+    job.srcLen = srcLen;
+    job.coder_type = coder_type;
+    job.coder_level = coder_level;
+    job.coder_param = coder_param;
+    job.estimated_compression = estimated_compression;
+}
+
+void ParallelStreamsCompressor::addStream(const string &label, string &&src, uint8_t coder_type, uint8_t coder_level,
+                                          int coder_param, double estimated_compression) {
+    addStream(label, 0, src.length(), coder_type, coder_level, coder_param, estimated_compression);
+    jobs.back().ownedSrc = std::move(src);
+}
+
+void ParallelStreamsCompressor::addRawBytes(const string &bytes) {
+    jobs.emplace_back();
+    jobs.back().rawMode = true;
+    jobs.back().dest = bytes;
+}
+
+void ParallelStreamsCompressor::compressJob(CompressionJob &job) {
+    const char* src = job.src ? job.src : job.ownedSrc.data();
+    ostringstream dest;
+    ostringstream log;
+    writeCompressed(dest, src, job.srcLen, job.coder_type, job.coder_level, job.coder_param,
+                    job.estimated_compression, log);
+    job.dest = dest.str();
+    job.log = log.str();
+    job.ownedSrc.clear();
+    job.ownedSrc.shrink_to_fit();
+}
+
+void ParallelStreamsCompressor::writeCompletedJobs(ostream &dest) {
+    while (writtenJobsCount < jobs.size() && jobsCompleted[writtenJobsCount]) {
+        CompressionJob &job = jobs[writtenJobsCount++];
+        dest.write(job.dest.data(), job.dest.length());
+        if (!job.rawMode)
+            *PgSAHelpers::logout << job.label << "... " << job.log;
+        string().swap(job.dest);
+        string().swap(job.log);
+    }
+}
+
+void ParallelStreamsCompressor::write(ostream &dest) {
+    chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+    jobsCompleted.assign(jobs.size(), false);
+    writtenJobsCount = 0;
+    // streams coded with internally parallel coders are processed one by one (using all threads)
+    vector<size_t> concurrentJobs;
+    for(size_t i = 0; i < jobs.size(); i++) {
+        if (jobs[i].rawMode)
+            jobsCompleted[i] = true;
+        else if (jobs[i].coder_type == LZMA2_CODER ||
+                isParallelBlocksCompressionApplicable(jobs[i].srcLen, jobs[i].coder_type)) {
+            compressJob(jobs[i]);
+            jobsCompleted[i] = true;
+        } else
+            concurrentJobs.push_back(i);
+        writeCompletedJobs(dest);
+    }
+    std::stable_sort(concurrentJobs.begin(), concurrentJobs.end(),
+            [this](const size_t &j1, const size_t &j2) -> bool { return jobs[j1].srcLen > jobs[j2].srcLen; });
+    // each stream is written (and released) as soon as all the preceding streams are written
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(PgSAHelpers::numberOfThreads)
+    for(size_t j = 0; j < concurrentJobs.size(); j++) {
+        compressJob(jobs[concurrentJobs[j]]);
+        #pragma omp critical(ParallelStreamsCompressorWrite)
+        {
+            jobsCompleted[concurrentJobs[j]] = true;
+            writeCompletedJobs(dest);
+        }
+    }
+    *PgSAHelpers::logout << "Compressed " << jobs.size() << " streams (" << concurrentJobs.size() << " concurrently) in "
+                         << PgSAHelpers::time_millis(start_t) << " msec." << endl;
+    jobs.clear();
+    jobsCompleted.clear();
 }
 
 char* componentCompress(ostream &dest, size_t &compLen, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
@@ -574,14 +1010,9 @@ void writeCompoundCompressionHeader(ostream &dest, size_t srcLen, size_t compLen
     PgSAHelpers::writeValue<uint8_t>(dest, coder_type, false);
 }
 
-void readCompressed(istream &src, string& dest) {
-    size_t destLen = 0;
+static void readCompressedData(istream &src, char* dest, size_t destLen, ostream &log) {
     size_t srcLen = 0;
     uint8_t coder_type = 0;
-    PgSAHelpers::readValue<uint64_t>(src, destLen, false);
-    dest.resize(destLen);
-    if (destLen == 0)
-        return;
     PgSAHelpers::readValue<uint64_t>(src, srcLen, false);
     PgSAHelpers::readValue<uint8_t>(src, coder_type, false);
     if (coder_type == COMPOUND_CODER_TYPE) {
@@ -589,17 +1020,107 @@ void readCompressed(istream &src, string& dest) {
         string component;
         readCompressed(src, component);
         assert(srcLen == component.length());
-        Uncompress((char *) dest.data(), destLen, component.data(), srcLen, coder_type);
+        Uncompress(dest, destLen, component.data(), srcLen, coder_type, log);
     } else {
-        Uncompress((char *) dest.data(), destLen, src, srcLen, coder_type);
+        Uncompress(dest, destLen, src, srcLen, coder_type, log);
     }
+}
+
 #ifdef DEVELOPER_BUILD
+static void dumpAfterDecompression(const char* dest, size_t destLen) {
     if (dump_after_decompression) {
         string dumpFileName = dump_after_decompression_prefix + (dump_after_decompression_counter < 10?"0":"");
         PgSAHelpers::writeArrayToFile(dumpFileName + PgSAHelpers::toString(dump_after_decompression_counter++),
-                                      (void*) dest.data(), destLen);
+                                      (void*) dest, destLen);
+    }
+}
+#endif
+
+void readCompressed(istream &src, string& dest) {
+    size_t destLen = 0;
+    PgSAHelpers::readValue<uint64_t>(src, destLen, false);
+    dest.resize(destLen);
+    if (destLen == 0)
+        return;
+    readCompressedData(src, (char *) dest.data(), destLen, *PgSAHelpers::logout);
+#ifdef DEVELOPER_BUILD
+    dumpAfterDecompression(dest.data(), destLen);
+#endif
+}
+
+// copies compressed data of a stream (following decompressed data length) without decoding
+static void copyCompressedData(istream &src, ostream &dest) {
+    size_t srcLen = 0;
+    uint8_t coder_type = 0;
+    PgSAHelpers::readValue<uint64_t>(src, srcLen, false);
+    PgSAHelpers::readValue<uint8_t>(src, coder_type, false);
+    PgSAHelpers::writeValue<uint64_t>(dest, srcLen, false);
+    PgSAHelpers::writeValue<uint8_t>(dest, coder_type, false);
+    if (coder_type == COMPOUND_CODER_TYPE) {
+        PgSAHelpers::readValue<uint8_t>(src, coder_type, false);
+        PgSAHelpers::writeValue<uint8_t>(dest, coder_type, false);
+        size_t componentLen = 0;
+        PgSAHelpers::readValue<uint64_t>(src, componentLen, false);
+        PgSAHelpers::writeValue<uint64_t>(dest, componentLen, false);
+        if (componentLen)
+            copyCompressedData(src, dest);
+    } else {
+        string data(srcLen, ' ');
+        PgSAHelpers::readArray(src, (void*) data.data(), srcLen);
+        PgSAHelpers::writeArray(dest, (void*) data.data(), srcLen);
     }
+}
+
+struct MemoryStreamBuf : std::streambuf {
+    MemoryStreamBuf(char *src, size_t srcLen) {
+        setg(src, src, src + srcLen);
+    }
+};
+
+void ParallelStreamsDecompressor::addStream(istream &src, string &dest) {
+    size_t destLen = 0;
+    PgSAHelpers::readValue<uint64_t>(src, destLen, false);
+    dest.resize(destLen);
+    addStream(src, (char*) dest.data(), destLen);
+}
+
+void ParallelStreamsDecompressor::addStream(istream &src, char *dest, size_t destLen) {
+    if (destLen == 0)
+        return;
+    ostringstream data;
+    copyCompressedData(src, data);
+    jobs.push_back({ dest, destLen, data.str() });
+}
+
+void ParallelStreamsDecompressor::addFinalizer(const std::function<void()> &finalizer) {
+    finalizers.push_back(finalizer);
+}
+
+void ParallelStreamsDecompressor::decompressJob(DecompressionJob &job) {
+    MemoryStreamBuf srcBuf((char*) job.src.data(), job.src.length());
+    istream src(&srcBuf);
+    ostringstream log;
+    readCompressedData(src, job.dest, job.destLen, log);
+    job.log = log.str();
+    job.src.clear();
+    job.src.shrink_to_fit();
+}
+
+void ParallelStreamsDecompressor::decompress(ostream &log) {
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(PgSAHelpers::numberOfThreads)
+    for(size_t j = 0; j < jobs.size(); j++)
+        decompressJob(jobs[j]);
+    for(DecompressionJob &job: jobs)
+        log << job.log;
+#ifdef DEVELOPER_BUILD
+    for(DecompressionJob &job: jobs)
+        dumpAfterDecompression(job.dest, job.destLen);
 #endif
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(PgSAHelpers::numberOfThreads)
+    for(size_t f = 0; f < finalizers.size(); f++)
+        finalizers[f]();
+    jobs.clear();
+    finalizers.clear();
 }
 
 double simpleUintCompressionEstimate(uint64_t dataMaxValue, uint64_t typeMaxValue) {
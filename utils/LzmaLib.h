@@ -8,6 +8,7 @@
 #include "helper.h"
 #include "VarLenDNACoder.h"
 #include <vector>
+#include <functional>
 
 using namespace std;
 
@@ -26,6 +27,15 @@ const static uint8_t LZMA2_CODER = 2;
 const static uint8_t PPMD7_CODER = 3;
 const static uint8_t VARLEN_DNA_CODER = 11;
 const static uint8_t COMPOUND_CODER_TYPE = 77;
+const static uint8_t PARALLEL_BLOCKS_CODER_TYPE = 88;
+
+// size of independently coded blocks of a stream (0 - disabled)
+extern size_t parallelBlocksCoderBlockSize;
+
+// minimal size of a stream for block-parallel LZMA2 coder (when more than 2 threads are available)
+const static size_t LZMA2_CODER_MIN_STREAM_SIZE = ((size_t) 1) << 26;
+
+uint8_t selectLzmaCoder(size_t srcLen);
 
 
 const static int PGRC_DATAPERIODCODE_8_t = 0;
@@ -47,20 +57,98 @@ const static double COMPRESSION_ESTIMATION_MIS_SYM = 0.250;
 double simpleUintCompressionEstimate(uint64_t dataMaxValue, uint64_t typeMaxValue);
 
 char* Compress(size_t &destLen, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
-        int coder_param = -1, double estimated_compression = 1);
+        int coder_param = -1, double estimated_compression = 1, ostream &log = *PgSAHelpers::logout);
+bool isParallelBlocksCompressionApplicable(size_t srcLen, uint8_t coder_type);
+
 void writeCompressed(ostream &dest, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
-                     int coder_param = -1, double estimated_compression = 1);
+                     int coder_param = -1, double estimated_compression = 1, ostream &log = *PgSAHelpers::logout);
 void writeCompressed(ostream &dest, const string srcStr, uint8_t coder_type, uint8_t coder_level,
-                     int coder_param = -1, double estimated_compression = 1);
+                     int coder_param = -1, double estimated_compression = 1, ostream &log = *PgSAHelpers::logout);
+
+// Compresses independent streams concurrently and writes them in the order they were added.
+class ParallelStreamsCompressor {
+private:
+    struct CompressionJob {
+        string label;
+        bool rawMode;
+        const char *src;
+        size_t srcLen;
+        string ownedSrc;
+        uint8_t coder_type;
+        uint8_t coder_level;
+        int coder_param;
+        double estimated_compression;
+        string dest;
+        string log;
+    };
+
+    vector<CompressionJob> jobs;
+    vector<bool> jobsCompleted;
+    size_t writtenJobsCount = 0;
+
+    static void compressJob(CompressionJob &job);
+    // writes (and releases) the completed jobs following the already written ones
+    void writeCompletedJobs(ostream &dest);
+public:
+    // src must remain valid until write is called
+    void addStream(const string &label, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
+                   int coder_param = -1, double estimated_compression = 1);
+    void addStream(const string &label, string &&src, uint8_t coder_type, uint8_t coder_level,
+                   int coder_param = -1, double estimated_compression = 1);
+    // uncompressed bytes (e.g. headers) written between streams
+    void addRawBytes(const string &bytes);
+
+    void write(ostream &dest);
+};
 
 char* componentCompress(ostream &dest, size_t &compLen, const char *src, size_t srcLen, uint8_t coder_type, uint8_t coder_level,
                         int coder_param = -1, double estimated_compression = 1);
 void writeCompoundCompressionHeader(ostream &dest, size_t srcLen, size_t compLen, uint8_t coder_type);
 
-void Uncompress(char* dest, size_t destLen, istream &src, size_t srcLen, uint8_t coder_type);
-void Uncompress(char* dest, size_t destLen, const char* src, size_t srcLen, uint8_t coder_type);
+void Uncompress(char* dest, size_t destLen, istream &src, size_t srcLen, uint8_t coder_type,
+        ostream &log = *PgSAHelpers::logout);
+void Uncompress(char* dest, size_t destLen, const char* src, size_t srcLen, uint8_t coder_type,
+        ostream &log = *PgSAHelpers::logout);
 void readCompressed(istream &src, string& dest);
 
+// Reads compressed streams one after another and decompresses them concurrently.
+class ParallelStreamsDecompressor {
+private:
+    struct DecompressionJob {
+        char *dest;
+        size_t destLen;
+        string src;
+        string log;
+    };
+
+    vector<DecompressionJob> jobs;
+    vector<std::function<void()>> finalizers;
+
+    void addStream(istream &src, char *dest, size_t destLen);
+    static void decompressJob(DecompressionJob &job);
+public:
+    // dest is resized immediately, its contents are available after decompress is called
+    void addStream(istream &src, string &dest);
+    template<typename T>
+    void addStream(istream &src, vector<T> &dest);
+    // finalizers are executed (concurrently) after all streams are decompressed
+    void addFinalizer(const std::function<void()> &finalizer);
+
+    void decompress(ostream &log = *PgSAHelpers::logout);
+};
+
+template<typename T>
+void ParallelStreamsDecompressor::addStream(istream &src, vector<T> &dest) {
+    size_t destLen = 0;
+    PgSAHelpers::readValue<uint64_t>(src, destLen, false);
+    if (destLen % sizeof(T)) {
+        fprintf(stderr, "Invalid output size %zu for decompressing to the vector of %zu-byte elements",
+                destLen, sizeof(T));
+    }
+    dest.resize(destLen / sizeof(T));
+    addStream(src, (char*) dest.data(), destLen);
+}
+
 template<typename T>
 void readCompressed(istream &src, vector<T>& dest) {
     size_t destLen = 0;
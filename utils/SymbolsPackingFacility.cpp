@@ -94,6 +94,8 @@ namespace PgSAIndex {
         delete[]currentClear;
         delete[]sequence;
 
+        bitsPerSymbol = maxValue == UINT8_MAX ? 8 / symbolsPerElement : 0;
+
         packLUT0 = new uchar[PACK_LUT_SIZE]();
         packLUT1 = new uchar[PACK_LUT_SIZE]();
         symbolsPerLUT1 = symbolsPerElement - SYMBOLS_PER_LUT_0;
@@ -255,7 +257,61 @@ namespace PgSAIndex {
         return res;
     }
 
+    uint64_t SymbolsPackingFacility::loadSymbolsWord(const uint8_t* seq, uchar bitOffset, uint_max bitsCount) {
+        uint64_t word;
+        if (bitsCount >= 72) {
+            memcpy(&word, seq, 8);
+            return (__builtin_bswap64(word) << bitOffset) | (seq[8] >> (8 - bitOffset));
+        }
+        const uint_max bits = bitsCount < 64 ? bitsCount : 64;
+        const uint_max bytesCount = (bitOffset + bits + 7) / 8;
+        if (bytesCount > 8) {
+            memcpy(&word, seq, 8);
+            word = (__builtin_bswap64(word) << bitOffset) | (seq[8] >> (8 - bitOffset));
+        } else {
+            word = 0;
+            for (uint_max i = 0; i < bytesCount; i++)
+                word |= (uint64_t) seq[i] << (56 - 8 * i);
+            word <<= bitOffset;
+        }
+        if (bits < 64)
+            word &= ~(UINT64_MAX >> bits);
+        return word;
+    }
+
+    uint64_t SymbolsPackingFacility::getPackedSymbolsWord(const uint8_t* sequence, uint_max pos, uint_max length) {
+        const uint_max bitPos = pos * bitsPerSymbol;
+        return loadSymbolsWord(sequence + bitPos / 8, bitPos % 8, length * bitsPerSymbol);
+    }
+
+    int SymbolsPackingFacility::compareSymbolsWordwise(const uint8_t* lSeq, uchar lBitOffset,
+            const uint8_t* rSeq, uchar rBitOffset, uint_max length) {
+        uint_max bitsLeft = length * bitsPerSymbol;
+        while (bitsLeft > 0) {
+            const uint64_t lWord = loadSymbolsWord(lSeq, lBitOffset, bitsLeft);
+            const uint64_t rWord = loadSymbolsWord(rSeq, rBitOffset, bitsLeft);
+            const uint64_t diff = lWord ^ rWord;
+            if (diff) {
+                // bitsPerSymbol is a power of 2, so masking aligns the first mismatch to the symbol boundary
+                const int shift = __builtin_clzll(diff) & ~(bitsPerSymbol - 1);
+                return (int) ((lWord << shift) >> (64 - bitsPerSymbol)) - (int) ((rWord << shift) >> (64 - bitsPerSymbol));
+            }
+            if (bitsLeft <= 64)
+                break;
+            bitsLeft -= 64;
+            lSeq += 8;
+            rSeq += 8;
+        }
+        return 0;
+    }
+
     int SymbolsPackingFacility::compareSequences(uint8_t* lSeq, uint8_t* rSeq, const uint_max length) {
+        if (bitsPerSymbol) {
+            // most of comparisons are resolved by the first element
+            if (length >= symbolsPerElement && *lSeq != *rSeq)
+                return (int) *lSeq - *rSeq;
+            return compareSymbolsWordwise(lSeq, 0, rSeq, 0, length);
+        }
         uint_max i = length;
         while (i >= symbolsPerElement) {
             int cmp = (int) *lSeq++ - *rSeq++;
@@ -281,6 +337,8 @@ namespace PgSAIndex {
 
         lSeq += i;
         rSeq += i;
+        if (bitsPerSymbol)
+            return compareSymbolsWordwise(lSeq, reminder * bitsPerSymbol, rSeq, reminder * bitsPerSymbol, length);
         for (uchar j = reminder; j < symbolsPerElement; j++) {
             int cmp = (int) reverse[*lSeq][j] - reverse[*rSeq][j];
             if (cmp)
@@ -297,6 +355,8 @@ namespace PgSAIndex {
         uint_max reminder = moduloBySmallInteger(sufPos, this->symbolsPerElement, i);
         
         sufSeq += i;
+        if (bitsPerSymbol)
+            return compareSymbolsWordwise(sufSeq, reminder * bitsPerSymbol, preSeq, 0, length);
         if (reminder == 0)
             return compareSequences(sufSeq, preSeq, length);
         
@@ -345,31 +405,20 @@ namespace PgSAIndex {
                                                                                     const char *pattern,
                                                                                     uint_read_len_max length,
                                                                                     uint8_t maxMismatches) {
+        // sequence is unpacked in blocks verified with (SIMD) mismatches counting
+        char_pg block[UNPACKED_BLOCK_SYMBOLS];
+        const uint_max blockLength = (UNPACKED_BLOCK_SYMBOLS / symbolsPerElement) * symbolsPerElement;
         uint8_t res = 0;
-        uint_max i = length;
-        while (i >= symbolsPerElement) {
-            uint_ps_element_min pSeq = packSymbols(pattern);
-            if (*seq != pSeq) {
-                for(uint8_t j = 0; j < symbolsPerElement; j++) {
-                    if (reverse[*seq][j] != *pattern++)
-                        if (res++ >= maxMismatches)
-                            return UINT8_MAX;
-                }
-            } else
-                pattern += symbolsPerElement;
-            seq++;
-            i -= symbolsPerElement;
-        }
-
-        int j = 0;
-        while (i--) {
-            if (reverse[*seq][j] != *pattern++) {
-                if (res++ >= maxMismatches)
-                    return UINT8_MAX;
-            }
-            j++;
+        for(uint_max pos = 0; pos < length; pos += blockLength) {
+            const uint_max len = length - pos < blockLength ? length - pos : blockLength;
+            char_pg* ptr = block;
+            for(uint_max j = 0; j < len; j += symbolsPerElement, ptr += symbolsPerElement)
+                memcpy(ptr, reverse[*seq++], symbolsPerElement);
+            const uint8_t blockRes = PgSAHelpers::countMismatches(block, pattern + pos, len, maxMismatches - res);
+            if (blockRes == UINT8_MAX)
+                return UINT8_MAX;
+            res += blockRes;
         }
-
         return res;
     }
 
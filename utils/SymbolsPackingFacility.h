@@ -14,6 +14,7 @@ namespace PgSAIndex {
 
             const static uint16_t PACK_LUT_SIZE = 1 << 11;
             const static uint16_t PACK_MASK = PACK_LUT_SIZE - 1;
+            const static uint16_t UNPACKED_BLOCK_SYMBOLS = 128;
 
             uint_max maxValue;
             const uint_symbols_cnt symbolsCount;
@@ -37,8 +38,17 @@ namespace PgSAIndex {
 
             const bool globallyManaged = false;
 
+            // bits per symbol if values fill the whole byte (e.g. 2 for ACGT), otherwise 0
+            uchar bitsPerSymbol = 0;
+
             void buildReversePackAndClearIndexes();
 
+            // loads up to 64 bits of sequence starting at bitOffset (0..7) of seq; result is aligned to MSB
+            static inline uint64_t loadSymbolsWord(const uint8_t* seq, uchar bitOffset, uint_max bitsCount);
+            // compares length symbols (of bitsPerSymbol bits each) word by word
+            int compareSymbolsWordwise(const uint8_t* lSeq, uchar lBitOffset, const uint8_t* rSeq, uchar rBitOffset,
+                    uint_max length);
+
             inline void validateSymbol(uchar symbol);
 
         public:
@@ -80,6 +90,11 @@ namespace PgSAIndex {
             
             static uchar maxSymbolsPerElement(uchar symbolsCount);
           
+            // 0 if packed values are not bit-aligned
+            uchar getBitsPerSymbol() { return bitsPerSymbol; }
+            // returns (MSB aligned) packed bits of length symbols (up to 64 bits) at pos; requires bit-aligned packing
+            uint64_t getPackedSymbolsWord(const uint8_t* sequence, uint_max pos, uint_max length);
+
             int compareSequences(uint8_t* lSeq, uint8_t* rSeq, const uint_max length);
             int compareSequences(uint8_t* lSeq, uint8_t* rSeq, uint_max pos, uint_max length);
             int compareSuffixWithPrefix(uint8_t* sufSeq, uint8_t* preSeq, uint_max sufPos, uint_max length);
@@ -1,6 +1,9 @@
 #include "helper.h"
 
 #include "byteswap.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 std::ostream *PgSAHelpers::logout = &std::cout;
 
@@ -328,7 +331,7 @@ void PgSAHelpers::reverseComplementInPlace(string &kmer) {
     reverseComplementInPlace((char*) kmer.data(), kmer.length());
 }
 
-double PgSAHelpers::qualityScore2approxCorrectProb(string quality) {
+double PgSAHelpers::qualityScore2approxCorrectProb(const string &quality) {
     double val = 1;
     for (char q : quality) {
         switch (q) {
@@ -371,55 +374,88 @@ double PgSAHelpers::qualityScore2approxCorrectProb(string quality) {
     return pow(val, 1.0/quality.length());
 }
 
-double PgSAHelpers::qualityScore2correctProb(string quality) {
-    double val = 1;
-    for (char q : quality) {
-        switch (q) {
-            case 33: return 0;
-            case 34: val *= 0.2056717652757185; break;
-            case 35: val *= 0.36904265551980675; break;
-            case 36: val *= 0.49881276637272776; break;
-            case 37: val *= 0.6018928294465028; break;
-            case 38: val *= 0.683772233983162; break;
-            case 39: val *= 0.748811356849042; break;
-            case 40: val *= 0.800473768503112; break;
-            case 41: val *= 0.8415106807538887; break;
-            case 42: val *= 0.8741074588205833; break;
-            case 43: val *= 0.9; break;
-            case 44: val *= 0.9205671765275718; break;
-            case 45: val *= 0.9369042655519807; break;
-            case 46: val *= 0.9498812766372727; break;
-            case 47: val *= 0.9601892829446502; break;
-            case 48: val *= 0.9683772233983162; break;
-            case 49: val *= 0.9748811356849042; break;
-            case 50: val *= 0.9800473768503112; break;
-            case 51: val *= 0.9841510680753889; break;
-            case 52: val *= 0.9874107458820583; break;
-            case 53: val *= 0.99; break;
-            case 54: val *= 0.9920567176527572; break;
-            case 55: val *= 0.993690426555198; break;
-            case 56: val *= 0.9949881276637272; break;
-            case 57: val *= 0.996018928294465; break;
-            case 58: val *= 0.9968377223398316; break;
-            case 59: val *= 0.9974881135684904; break;
-            case 60: val *= 0.9980047376850312; break;
-            case 61: val *= 0.9984151068075389; break;
-            case 62: val *= 0.9987410745882058; break;
-            case 63: val *= 0.999; break;
-            case 64: val *= 0.9992056717652757; break;
-            case 65: val *= 0.9993690426555198; break;
-            case 66: val *= 0.9994988127663728; break;
-            case 67: val *= 0.9996018928294464; break;
-            case 68: val *= 0.9996837722339832; break;
-            case 69: val *= 0.999748811356849; break;
-            case 70: val *= 0.9998004737685031; break;
-            case 71: val *= 0.9998415106807539; break;
-            case 72: val *= 0.9998741074588205; break;
-            case 73: val *= 0.9999; break;
-            default: val *= 1;
+double PgSAHelpers::qualityScore2correctProb(const string &quality) {
+    return qualityScore2correctProb(quality.data(), quality.length());
+}
+
+namespace {
+    const uint8_t MIN_QUALITY_SYMBOL = 33;
+    const uint8_t MAX_QUALITY_SYMBOL = 73;
+
+    // probability of correct base call for Phred+33 symbols (from MIN_QUALITY_SYMBOL)
+    const double phredCorrectProb[MAX_QUALITY_SYMBOL - MIN_QUALITY_SYMBOL + 1] = {
+        0, 0.2056717652757185, 0.36904265551980675, 0.49881276637272776,
+        0.6018928294465028, 0.683772233983162, 0.748811356849042, 0.800473768503112,
+        0.8415106807538887, 0.8741074588205833, 0.9, 0.9205671765275718,
+        0.9369042655519807, 0.9498812766372727, 0.9601892829446502, 0.9683772233983162,
+        0.9748811356849042, 0.9800473768503112, 0.9841510680753889, 0.9874107458820583,
+        0.99, 0.9920567176527572, 0.993690426555198, 0.9949881276637272,
+        0.996018928294465, 0.9968377223398316, 0.9974881135684904, 0.9980047376850312,
+        0.9984151068075389, 0.9987410745882058, 0.999, 0.9992056717652757,
+        0.9993690426555198, 0.9994988127663728, 0.9996018928294464, 0.9996837722339832,
+        0.999748811356849, 0.9998004737685031, 0.9998415106807539, 0.9998741074588205,
+        0.9999
+    };
+
+    // log of correct base call probability for every symbol (-inf for '!', 0 for symbols out of range)
+    struct QualityLogProbTable {
+        double logProb[UINT8_MAX + 1];
+
+        QualityLogProbTable() {
+            for(int i = 0; i <= UINT8_MAX; i++)
+                logProb[i] = 0;
+            for(int q = MIN_QUALITY_SYMBOL; q <= MAX_QUALITY_SYMBOL; q++)
+                logProb[q] = log(phredCorrectProb[q - MIN_QUALITY_SYMBOL]);
+        }
+    } const qualityLogProbTable;
+
+    const size_t QUALITY_EARLY_EXIT_BLOCK = 32;
+
+    // sums log probabilities of correct base calls; stops as soon as the sum drops below limit
+    double qualityScoreLogProbSum(const char* quality, size_t length, double limit) {
+        const double* logProb = qualityLogProbTable.logProb;
+        double sum = 0;
+        size_t i = 0;
+#ifdef __AVX2__
+        for(; i + QUALITY_EARLY_EXIT_BLOCK <= length; i += QUALITY_EARLY_EXIT_BLOCK) {
+            __m256d acc0 = _mm256_setzero_pd();
+            __m256d acc1 = _mm256_setzero_pd();
+            for(size_t j = 0; j < QUALITY_EARLY_EXIT_BLOCK; j += 16) {
+                __m128i q = _mm_loadu_si128((const __m128i*) (quality + i + j));
+                acc0 = _mm256_add_pd(acc0, _mm256_i32gather_pd(logProb, _mm_cvtepu8_epi32(q), 8));
+                acc1 = _mm256_add_pd(acc1, _mm256_i32gather_pd(logProb, _mm_cvtepu8_epi32(_mm_srli_si128(q, 4)), 8));
+                acc0 = _mm256_add_pd(acc0, _mm256_i32gather_pd(logProb, _mm_cvtepu8_epi32(_mm_srli_si128(q, 8)), 8));
+                acc1 = _mm256_add_pd(acc1, _mm256_i32gather_pd(logProb, _mm_cvtepu8_epi32(_mm_srli_si128(q, 12)), 8));
+            }
+            __m256d acc = _mm256_add_pd(acc0, acc1);
+            __m128d acc2 = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+            sum += _mm_cvtsd_f64(_mm_add_sd(acc2, _mm_unpackhi_pd(acc2, acc2)));
+            if (sum < limit)
+                return sum;
+        }
+#endif
+        for(; i < length; i++) {
+            sum += logProb[(uint8_t) quality[i]];
+            if (sum < limit)
+                return sum;
         }
+        return sum;
     }
-    return pow(val, 1.0/quality.length());
+}
+
+double PgSAHelpers::qualityScore2correctProb(const char* quality, size_t length) {
+    if (length == 0)
+        return 1;
+    return exp(qualityScoreLogProbSum(quality, length, -INFINITY) / length);
+}
+
+bool PgSAHelpers::qualityScoreErrorExceeds(const char* quality, size_t length, double errorLimit) {
+    if (length == 0)
+        return errorLimit < 0;
+    if (errorLimit >= 1)
+        return false;
+    const double limit = length * log(1 - errorLimit);
+    return qualityScoreLogProbSum(quality, length, limit) < limit;
 }
 
 int PgSAHelpers::readsSufPreCmp(const char* suffixPart, const char* prefixRead) {
@@ -13,6 +13,9 @@
 #include <climits>
 #include <cmath>
 #include <sstream>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -34,8 +37,47 @@ namespace PgSAHelpers {
     string reverseComplement(string kmer);
     void reverseComplementInPlace(char* start, const std::size_t N);
     void reverseComplementInPlace(string &kmer);
-    double qualityScore2approxCorrectProb(string quality);
-    double qualityScore2correctProb(string quality);
+    double qualityScore2approxCorrectProb(const string &quality);
+    double qualityScore2correctProb(const string &quality);
+    double qualityScore2correctProb(const char* quality, size_t length);
+    // equivalent of 1 - qualityScore2correctProb(quality, length) > errorLimit (with early exit)
+    bool qualityScoreErrorExceeds(const char* quality, size_t length, double errorLimit);
+
+    static const size_t MISMATCHES_EARLY_EXIT_BLOCK = 32;
+
+    // returns UINT8_MAX if the number of mismatches exceeds maxMismatches (checked after each block of symbols)
+    inline uint8_t countMismatches(const char* pattern, const char* text, size_t length, uint8_t maxMismatches) {
+        size_t res = 0;
+        size_t i = 0;
+#ifdef __AVX2__
+        for(; i + MISMATCHES_EARLY_EXIT_BLOCK <= length; i += MISMATCHES_EARLY_EXIT_BLOCK) {
+            __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (pattern + i)),
+                                           _mm256_loadu_si256((const __m256i*) (text + i)));
+            res += __builtin_popcount(~(uint32_t) _mm256_movemask_epi8(eq));
+            if (res > maxMismatches)
+                return UINT8_MAX;
+        }
+#endif
+#ifdef __SSE2__
+        for(; i + 16 <= length; i += 16) {
+            __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (pattern + i)),
+                                        _mm_loadu_si128((const __m128i*) (text + i)));
+            res += __builtin_popcount(~(uint32_t) _mm_movemask_epi8(eq) & 0xFFFF);
+            if (res > maxMismatches)
+                return UINT8_MAX;
+        }
+#endif
+        for(; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+            uint64_t temp1, temp2;
+            memcpy(&temp1, pattern + i, sizeof(uint64_t));
+            memcpy(&temp2, text + i, sizeof(uint64_t));
+            const uint64_t diff = temp1 ^ temp2;
+            res += __builtin_popcountll((((diff & 0x7F7F7F7F7F7F7F7F) + 0x7F7F7F7F7F7F7F7F) | diff) & 0x8080808080808080);
+        }
+        for(; i < length; i++)
+            res += pattern[i] != text[i];
+        return res > maxMismatches ? UINT8_MAX : res;
+    }
 
     inline uint8_t symbol2value(char symbol);
     inline char value2symbol(uint8_t value);